@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+'''
+Generates the benchmark corpus: synthetic .ddg files in the format read by
+DataDepGraph::ReadFrmFile. The graphs are seeded, so the corpus can be
+regenerated exactly, but the generated files are checked in and are what the
+benchmarks run on.
+
+There are three kinds of regions:
+  latency   Narrow graphs of long-latency instructions, which need long
+            enumerations to prove a schedule length optimal.
+  wide      Many independent chains with a few cross dependences, which give
+            the enumerator a wide ready list.
+  pressure  Many loads whose values are combined late, which give high
+            register pressure with optsched-replay's -model-data-regs.
+'''
+
+import argparse
+import os
+import random
+
+# The data latency of each instruction type. These must match the instruction
+# types in cfg/machine_model.cfg.
+LATENCIES = {
+    'alu': 1,
+    'mul': 3,
+    'load': 4,
+    'fdiv': 12,
+}
+
+OPCODES = {
+    'alu': 'ADD',
+    'mul': 'MUL',
+    'load': 'LOAD',
+    'fdiv': 'FDIV',
+}
+
+
+class Graph:
+    def __init__(self):
+        self.types = []
+        self.preds = []
+
+    def add(self, inst_type, preds=()):
+        self.types.append(inst_type)
+        self.preds.append(sorted(set(preds)))
+        return len(self.types) - 1
+
+    def __len__(self):
+        return len(self.types)
+
+
+def gen_latency(rng, size):
+    g = Graph()
+    while len(g) < size:
+        if len(g) < 2 or rng.random() < 0.15:
+            g.add('load')
+            continue
+        inst_type = rng.choice(['mul', 'mul', 'fdiv', 'alu', 'load'])
+        window = list(range(max(0, len(g) - 6), len(g)))
+        preds = rng.sample(window, min(len(window), rng.randint(1, 2)))
+        g.add(inst_type, preds)
+    return g
+
+
+def gen_wide(rng, size):
+    g = Graph()
+    width = rng.randint(8, 12)
+    chains = [[g.add('load')] for _ in range(width)]
+    while len(g) < size - 2:
+        chain = rng.choice(chains)
+        preds = [chain[-1]]
+        if rng.random() < 0.1:
+            other = rng.choice(chains)
+            preds.append(rng.choice(other))
+        chain.append(g.add(rng.choice(['alu', 'alu', 'mul', 'load']), preds))
+    half = width // 2
+    g.add('alu', [chain[-1] for chain in chains[:half]])
+    g.add('alu', [chain[-1] for chain in chains[half:]])
+    return g
+
+
+def gen_pressure(rng, size):
+    g = Graph()
+    values = [g.add('load') for _ in range(size // 3)]
+    while len(g) < size:
+        a, b = rng.sample(values, 2)
+        # Keep some of the operands live so that the pressure stays high.
+        values.remove(a)
+        if rng.random() < 0.5:
+            values.remove(b)
+        values.append(g.add(rng.choice(['alu', 'mul']), [a, b]))
+        if len(values) < 2:
+            values.append(g.add('load'))
+    return g
+
+
+GENERATORS = {
+    'latency': (gen_latency, (40, 60)),
+    'wide': (gen_wide, (60, 90)),
+    'pressure': (gen_pressure, (40, 60)),
+}
+
+
+def write_ddg(out, name, g):
+    inst_cnt = len(g) + 2
+    leaf = inst_cnt - 1
+    succs = [[] for _ in range(len(g))]
+    for i, preds in enumerate(g.preds):
+        for p in preds:
+            succs[p].append(i)
+
+    # Record a simple in-order list schedule as the input schedule.
+    cycles = []
+    cycle = -1
+    for i, preds in enumerate(g.preds):
+        ready = max([cycles[p] + LATENCIES[g.types[p]] for p in preds],
+                    default=0)
+        cycle = max(cycle + 1, ready)
+        cycles.append(cycle)
+
+    out.write('dag %d "Benchmark"\n' % inst_cnt)
+    out.write('{\n')
+    out.write('dag_id %s\n' % name)
+    out.write('dag_weight 1.000000\n')
+    out.write('compiler LLVM\n')
+    out.write('nodes\n')
+    out.write('  node 0 "artificial"\n')
+    for i, inst_type in enumerate(g.types):
+        out.write('  node %d "%s"  "%s"\n' %
+                  (i + 1, inst_type, OPCODES[inst_type]))
+        out.write('    sched_order %d\n' % i)
+        out.write('    issue_cycle %d\n' % cycles[i])
+    out.write('  node %d "artificial"\n' % leaf)
+    out.write('dependencies\n')
+    for i, preds in enumerate(g.preds):
+        if not preds:
+            out.write('  dep 0 %d "other" 0\n' % (i + 1))
+    for i in range(len(g)):
+        for s in succs[i]:
+            out.write('  dep %d %d "data" %d\n' %
+                      (i + 1, s + 1, LATENCIES[g.types[i]]))
+        if not succs[i]:
+            out.write('  dep %d %d "other" 0\n' % (i + 1, leaf))
+    out.write('}\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Generate the benchmark corpus of .ddg files')
+    parser.add_argument('-o', '--output', default=os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), 'corpus'),
+        help='The directory to write the corpus to')
+    parser.add_argument('-n', '--count', type=int, default=4,
+                        help='The number of regions of each kind')
+    parser.add_argument('--seed', type=int, default=2020,
+                        help='The seed for the generated graphs')
+    args = parser.parse_args()
+
+    os.makedirs(args.output, exist_ok=True)
+    for kind, (gen, (min_size, max_size)) in sorted(GENERATORS.items()):
+        for i in range(args.count):
+            rng = random.Random('%d:%s:%d' % (args.seed, kind, i))
+            name = '%s_%02d' % (kind, i + 1)
+            g = gen(rng, rng.randint(min_size, max_size))
+            with open(os.path.join(args.output, name + '.ddg'), 'w') as out:
+                write_ddg(out, name, g)
+
+
+if __name__ == '__main__':
+    main()
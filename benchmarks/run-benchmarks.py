@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+'''
+Runs optsched-replay over the benchmark corpus with the pinned configuration
+and writes the results as CSV, one row per region. Each region is run in its
+own process, so that the peak memory is that of the region, and the times are
+the median of several runs.
+
+Pass the results of an earlier run with --baseline to compare the two. To
+measure the effect of an option, override it with --set, for example
+--set RELAXED_PRUNING_INCREMENTAL=NO for the baseline run.
+'''
+
+import argparse
+import csv
+import math
+import os
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+
+BENCHMARK_DIR = os.path.dirname(os.path.abspath(__file__))
+
+FIELDS = [
+    'region', 'insts', 'result', 'best_length', 'best_cost', 'enum_nodes',
+    'enum_time_ms', 'nodes_per_sec', 'rlxd_checks', 'rlxd_ns_per_node',
+    'time_ms', 'time_to_optimal_ms',
+    'aco_iterations', 'aco_time_ms', 'aco_iterations_per_sec', 'peak_rss_kb',
+]
+
+# The metrics to compare, and whether larger values are better.
+COMPARED = [
+    ('time_ms', False),
+    ('nodes_per_sec', True),
+    ('rlxd_ns_per_node', False),
+    ('aco_iterations_per_sec', True),
+    ('peak_rss_kb', False),
+]
+
+
+def replay(args, path):
+    cmd = [args.replay, '-cfg', args.cfg, '-csv', '-quiet', '-model-data-regs',
+           path]
+    out = subprocess.run(cmd, check=True, stdout=subprocess.PIPE,
+                         universal_newlines=True).stdout
+    return list(csv.DictReader(out.splitlines()))
+
+
+def per_sec(count, time_ms):
+    if time_ms <= 0:
+        return ''
+    return '%.1f' % (count * 1000.0 / time_ms)
+
+
+def per_node_ns(time_us, nodes):
+    if nodes <= 0:
+        return ''
+    return '%.1f' % (time_us * 1000.0 / nodes)
+
+
+def override_cfg(cfg, settings, tmp_dir):
+    '''
+    Copies the configuration directory into tmp_dir with the KEY=VALUE
+    settings replacing the values in sched.ini, and returns the copy.
+    '''
+    overrides = {}
+    for setting in settings:
+        key, sep, value = setting.partition('=')
+        if not sep:
+            sys.exit('Expected KEY=VALUE, got %s' % setting)
+        overrides[key] = value
+
+    copy = os.path.join(tmp_dir, 'cfg')
+    shutil.copytree(cfg, copy)
+    path = os.path.join(copy, 'sched.ini')
+    with open(path) as f:
+        lines = f.read().splitlines()
+    for i, line in enumerate(lines):
+        words = line.split()
+        if words and words[0] in overrides:
+            lines[i] = '%s %s' % (words[0], overrides.pop(words[0]))
+    lines += ['%s %s' % item for item in sorted(overrides.items())]
+    with open(path, 'w') as f:
+        f.write('\n'.join(lines) + '\n')
+    return copy
+
+
+def run_region(args, path):
+    runs = [replay(args, path) for _ in range(args.repeat)]
+    results = []
+    for i, row in enumerate(runs[0]):
+        same = [run[i] for run in runs]
+
+        def median(field):
+            return int(statistics.median(int(r[field]) for r in same))
+
+        enum_nodes = int(row['enum_nodes'])
+        aco_iterations = int(row['aco_iterations'])
+        enum_time = median('enum_time_ms')
+        rlxd_time = median('rlxd_check_us')
+        aco_time = median('aco_time_ms')
+        time = median('time_ms')
+        optimal = row['result'] in ('optimal', 'heuristic-optimal')
+        results.append({
+            'region': row['region'],
+            'insts': row['insts'],
+            'result': row['result'],
+            'best_length': row['best_length'],
+            'best_cost': row['best_cost'],
+            'enum_nodes': enum_nodes,
+            'enum_time_ms': enum_time,
+            'nodes_per_sec': per_sec(enum_nodes, enum_time),
+            'rlxd_checks': row['rlxd_checks'],
+            'rlxd_ns_per_node': per_node_ns(rlxd_time, enum_nodes),
+            'time_ms': time,
+            'time_to_optimal_ms': time if optimal else '',
+            'aco_iterations': aco_iterations,
+            'aco_time_ms': aco_time,
+            'aco_iterations_per_sec': per_sec(aco_iterations, aco_time),
+            'peak_rss_kb': max(int(r['peak_rss_kb']) for r in same),
+        })
+    return results
+
+
+def compare(baseline_path, results, out):
+    with open(baseline_path) as f:
+        baseline = {row['region']: row for row in csv.DictReader(f)}
+
+    ratios = {metric: [] for metric, _ in COMPARED}
+    out.write('%-16s' % 'region')
+    for metric, _ in COMPARED:
+        out.write(' %24s' % metric)
+    out.write('\n')
+
+    for row in results:
+        base = baseline.get(row['region'])
+        if base is None:
+            continue
+        out.write('%-16s' % row['region'])
+        for metric, _ in COMPARED:
+            old, new = base[metric], str(row[metric])
+            if not old or not new or float(old) == 0:
+                out.write(' %24s' % '-')
+                continue
+            ratio = float(new) / float(old)
+            ratios[metric].append(ratio)
+            out.write(' %24s' % ('%.3fx' % ratio))
+        if (base['result'], base['best_cost']) != (row['result'],
+                                                   str(row['best_cost'])):
+            out.write('  (was %s with cost %s)' %
+                      (base['result'], base['best_cost']))
+        out.write('\n')
+
+    out.write('%-16s' % 'geomean')
+    geomeans = {}
+    for metric, _ in COMPARED:
+        values = ratios[metric]
+        if not values:
+            out.write(' %24s' % '-')
+            continue
+        geomeans[metric] = math.exp(sum(map(math.log, values)) / len(values))
+        out.write(' %24s' % ('%.3fx' % geomeans[metric]))
+    out.write('\n')
+    return geomeans
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Run the OptSched benchmark corpus')
+    parser.add_argument('--replay', required=True,
+                        help='The optsched-replay executable')
+    parser.add_argument('--cfg', default=os.path.join(BENCHMARK_DIR, 'cfg'),
+                        help='The configuration directory')
+    parser.add_argument('--corpus', default=os.path.join(BENCHMARK_DIR,
+                                                         'corpus'),
+                        help='The directory of .ddg files to run')
+    parser.add_argument('--set', action='append', default=[],
+                        metavar='KEY=VALUE',
+                        help='Override an option of sched.ini. May be '
+                             'repeated')
+    parser.add_argument('--repeat', type=int, default=3,
+                        help='The number of times to run each region')
+    parser.add_argument('-o', '--output',
+                        help='The CSV file to write. Defaults to stdout')
+    parser.add_argument('--baseline',
+                        help='The results of an earlier run to compare with')
+    parser.add_argument('--max-slowdown', type=float,
+                        help='Fail if the geometric mean of the time ratios '
+                             'to the baseline exceeds this')
+    args = parser.parse_args()
+
+    tmp_dir = None
+    if args.set:
+        tmp_dir = tempfile.mkdtemp(prefix='optsched-benchmark-')
+        args.cfg = override_cfg(args.cfg, args.set, tmp_dir)
+
+    results = []
+    try:
+        for name in sorted(os.listdir(args.corpus)):
+            if name.endswith('.ddg'):
+                results += run_region(args, os.path.join(args.corpus, name))
+    finally:
+        if tmp_dir:
+            shutil.rmtree(tmp_dir)
+
+    out = open(args.output, 'w', newline='') if args.output else sys.stdout
+    writer = csv.DictWriter(out, FIELDS)
+    writer.writeheader()
+    writer.writerows(results)
+    if args.output:
+        out.close()
+
+    if args.baseline:
+        report = sys.stderr if not args.output else sys.stdout
+        geomeans = compare(args.baseline, results, report)
+        if (args.max_slowdown is not None and
+                geomeans.get('time_ms', 1.0) > args.max_slowdown):
+            sys.exit('Slower than the baseline by %.3fx' %
+                     geomeans['time_ms'])
+
+
+if __name__ == '__main__':
+    main()
@@ -9,18 +9,23 @@ Last Update:  Jan. 2020
 #ifndef OPTSCHED_ACO_H
 #define OPTSCHED_ACO_H
 
+#include "opt-sched/Scheduler/aco_select.h"
 #include "opt-sched/Scheduler/gen_sched.h"
+#include "opt-sched/Scheduler/random.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/SmallVector.h"
+#include <atomic>
+#include <limits>
 #include <map>
 #include <memory>
 #include <utility>
+#include <vector>
 namespace llvm {
 namespace opt_sched {
 
-typedef double pheromone_t;
+class SharedIncumbent;
 
 enum class DCF_OPT {
   OFF,
@@ -46,14 +51,36 @@ public:
   // Set the initial schedule for ACO
   // Default is NULL if none are set.
   void setInitialSched(InstSchedule *Sched);
+  // The number of iterations completed by the last FindSchedule call.
+  int getIterationCnt() const { return IterationCnt; }
+  // The number of ants that the last FindSchedule call stopped early because
+  // they could no longer beat the iteration best, and the number of
+  // instruction steps that those ants did not take.
+  int getAbortedAntCnt() const { return AbortedAntCnt; }
+  int64_t getSavedAntStepCnt() const { return SavedAntStepCnt; }
+  // Constructs some of the ants of each iteration with Wrkr on another thread.
+  // Wrkr must have been built from a copy of this scheduler's DAG, and Rgn
+  // must be the copy of the region that it schedules.
+  void addAntWorker(ACOScheduler *Wrkr, SchedRegion *Rgn);
+  // Stops FindSchedule at the end of the first iteration that ends after
+  // Deadline. INVALID_VALUE for no deadline.
+  void setDeadline(Milliseconds Deadline) { Deadline_ = Deadline; }
+  // Runs FindSchedule alongside the enumerator. The cost of each better
+  // schedule that it finds is offered to Incumbent, and it stops at the end of
+  // the first iteration after Stop is set.
+  void setPipeline(SharedIncumbent *Incumbent, const std::atomic<bool> *Stop);
 
 private:
-  pheromone_t &Pheromone(SchedInstruction *from, SchedInstruction *to);
-  pheromone_t &Pheromone(InstCount from, InstCount to);
+  pheromone_cell_t &Pheromone(SchedInstruction *from, SchedInstruction *to);
+  pheromone_cell_t &Pheromone(InstCount from, InstCount to);
   pheromone_t Score(SchedInstruction *from, Choice choice);
+  // Scores all the choices once, into Scores_ for the selection kernels.
+  void ScoreChoices(const llvm::ArrayRef<Choice> &ready,
+                    SchedInstruction *lastInst);
   bool shouldReplaceSchedule(InstSchedule *OldSched, InstSchedule *NewSched,
                              bool IsGlobal);
   DCF_OPT ParseDCFOpt(const std::string &opt);
+  double RandDouble(double min, double max);
 
   void PrintPheromone();
 
@@ -77,8 +104,36 @@ private:
   Choice SelectInstruction(const llvm::ArrayRef<Choice> &ready,
                            SchedInstruction *lastInst);
   void UpdatePheromone(InstSchedule *schedule);
-  std::unique_ptr<InstSchedule> FindOneSchedule(InstCount TargetRPCost);
-  llvm::SmallVector<pheromone_t, 0> pheromone_;
+  static constexpr InstCount MaxCost = std::numeric_limits<InstCount>::max();
+  // Constructs one ant, drawing from the random stream seeded with AntSeed.
+  // The ant is stopped, and null returned, if its RP cost exceeds
+  // TargetRPCost or a lower bound on its cost exceeds CostUprBound.
+  std::unique_ptr<InstSchedule>
+  FindOneSchedule(uint64_t AntSeed, InstCount TargetRPCost,
+                  InstCount CostUprBound = MaxCost);
+  // A lower bound on the cost of any schedule that completes the ant's
+  // partial schedule, given the ant's current choices.
+  InstCount CmputAntCostLwrBound_(llvm::ArrayRef<Choice> ready);
+  // The cost that an ant has to stay within to possibly replace IterationBest.
+  InstCount AntCostUprBound_(InstSchedule *IterationBest);
+  // Constructs the ants of one iteration on this thread and the threads of the
+  // ant workers. The schedules are returned in ant order.
+  std::vector<std::unique_ptr<InstSchedule>>
+  FindAntSchedulesPrll_(int Iteration, InstCount TargetRPCost);
+  // The seed of the random stream of an ant of this pass.
+  uint64_t AntSeed_(int Iteration, size_t Ant) const;
+  llvm::SmallVector<pheromone_cell_t, 0> pheromone_;
+  // The pheromone table that the ants read. An ant worker reads that of the
+  // scheduler it works for.
+  pheromone_cell_t *PheromoneTbl_ = nullptr;
+  std::vector<ACOScheduler *> AntWrkrs_;
+  Milliseconds Deadline_ = INVALID_VALUE;
+  SharedIncumbent *Incumbent_ = nullptr;
+  const std::atomic<bool> *StopRequest_ = nullptr;
+  // The seed that the random streams of the ants of this pass derive from.
+  uint64_t PassSeed_ = 0;
+  // The random stream of the ant being constructed.
+  RandomStream AntRand_;
   pheromone_t initialValue_;
   bool use_fixed_bias;
   int count_;
@@ -93,6 +148,14 @@ private:
   int ants_per_iteration2p;
   int noImprovementMax;
   bool print_aco_trace;
+  // Whether to select with the scalar reference kernels.
+  bool ScalarSelect;
+  // Whether to stop the ants that cannot beat the iteration best.
+  bool AbortByBound;
+  // Whether to start from, and keep, the pheromone of runs on the same DAG.
+  bool UsePheromoneCache;
+  // The scores of the choices of the current selection.
+  llvm::SmallVector<pheromone_t, 0> Scores_;
   std::unique_ptr<InstSchedule> InitialSchedule;
   bool VrfySched_;
   bool IsPostBB;
@@ -101,6 +164,9 @@ private:
   DCF_OPT DCFOption;
   SPILL_COST_FUNCTION DCFCostFn;
   int localCmp = 0, localCmpRej = 0, globalCmp = 0, globalCmpRej = 0;
+  int IterationCnt = 0;
+  int AbortedAntCnt = 0;
+  int64_t SavedAntStepCnt = 0;
 };
 
 } // namespace opt_sched
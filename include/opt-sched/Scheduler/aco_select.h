@@ -0,0 +1,56 @@
+/*******************************************************************************
+Description:  Selection kernels for the ant colony optimizing scheduler. The
+              kernels work on the contiguous scores of the candidates of one
+              selection.
+*******************************************************************************/
+
+#ifndef OPTSCHED_ACO_SELECT_H
+#define OPTSCHED_ACO_SELECT_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include <cstddef>
+
+namespace llvm {
+namespace opt_sched {
+
+typedef double pheromone_t;
+
+// The pheromone table is stored in single precision, which halves its size.
+// The scores computed from it are in double precision. Define
+// ACO_DOUBLE_PHEROMONE to store the table in double precision.
+#ifdef ACO_DOUBLE_PHEROMONE
+typedef double pheromone_cell_t;
+#else
+typedef float pheromone_cell_t;
+#endif
+
+namespace AcoSelect {
+// The number of independent lanes that the unrolled kernels split the scores
+// into. The kernels are plain scalar loops unrolled LaneCnt times. Each lane
+// keeps its own running sum or maximum, so the additions of different lanes
+// do not wait on each other.
+const size_t LaneCnt = 4;
+
+// Returns the index of the first of the highest scores. Scores must not be
+// empty.
+size_t argMax(ArrayRef<pheromone_t> Scores);
+// Returns the sum of the scores.
+pheromone_t sum(ArrayRef<pheromone_t> Scores);
+// Returns the index of the first score at which the running sum of the scores
+// reaches Point, or Scores.size() if rounding keeps the sum below it. Point is
+// left holding what remains of it once the running sum is subtracted, which
+// is not positive unless Scores.size() is returned.
+size_t roulette(ArrayRef<pheromone_t> Scores, pheromone_t &Point);
+
+// Reference versions of the kernels, which add the scores one at a time in
+// order, as the scheduler has always done. The unrolled kernels add in a
+// different order, so their sums can differ in the last bits.
+size_t argMaxScalar(ArrayRef<pheromone_t> Scores);
+pheromone_t sumScalar(ArrayRef<pheromone_t> Scores);
+size_t rouletteScalar(ArrayRef<pheromone_t> Scores, pheromone_t &Point);
+} // namespace AcoSelect
+
+} // namespace opt_sched
+} // namespace llvm
+
+#endif
@@ -13,7 +13,9 @@ Last Update:  Apr. 2011
 #include "opt-sched/Scheduler/defines.h"
 #include "opt-sched/Scheduler/sched_region.h"
 #include "llvm/ADT/SmallVector.h"
+#include <functional>
 #include <map>
+#include <memory>
 #include <set>
 #include <vector>
 
@@ -25,11 +27,33 @@ class EnumTreeNode;
 class Register;
 class RegisterFile;
 class BitVector;
+class BBWithSpill;
+
+// A copy of a region, built from the same DAG, that enumerates part of the
+// search tree or constructs ACO ants on another thread.
+struct ParallelEnumWorker {
+  std::unique_ptr<OptSchedDDGWrapperBase> DDG;
+  // Declared after DDG so that it is destroyed first.
+  std::unique_ptr<BBWithSpill> Rgn;
+};
 
 class BBWithSpill : public SchedRegion {
 private:
   LengthCostEnumerator *enumrtr_;
 
+  // The number of extra threads to enumerate with, and the depth at which the
+  // search tree is split among the threads.
+  int prllWrkrCnt_ = 0;
+  InstCount prllSplitDepth_ = 0;
+  // The number of extra threads to construct ACO ants on.
+  int acoWrkrCnt_ = 0;
+  // Builds the region copies used by the extra threads.
+  std::function<ParallelEnumWorker()> mkPrllWrkr_;
+  std::vector<ParallelEnumWorker> prllWrkrs_;
+  std::vector<ParallelEnumWorker> acoWrkrs_;
+  // The region copy that ACO runs on when it is pipelined with the enumerator.
+  ParallelEnumWorker pipelinedAcoWrkr_;
+
   InstCount crntSpillCost_;
   InstCount optmlSpillCost_;
 
@@ -64,6 +88,15 @@ private:
   // calculated.
   InstCount dynamicSlilLowerBound_ = 0;
 
+  // For each instruction and register type, the registers whose live interval
+  // or possible live interval contains the instruction. The entry of
+  // instruction i and type t holds the register numbers from
+  // slilIntrvlRegs_[slilIntrvlBgn_[i * regTypeCnt_ + t]] up to the start of
+  // the next entry. Only live registers outside these raise the dynamic SLIL
+  // lower bound, so it can be updated without scanning all the registers.
+  std::vector<int> slilIntrvlBgn_;
+  std::vector<int> slilIntrvlRegs_;
+
   int entryInstCnt_;
   int exitInstCnt_;
   int schduldEntryInstCnt_;
@@ -104,14 +137,31 @@ private:
 
   void UpdateSpillInfoForSchdul_(SchedInstruction *inst, bool trackCnflcts);
   void UpdateSpillInfoForUnSchdul_(SchedInstruction *inst);
+  // Builds slilIntrvlBgn_ and slilIntrvlRegs_ from the live intervals.
+  void CmputSlilIntrvlRegs_();
+  // The number of live registers of the type whose live intervals and
+  // possible live intervals do not contain inst.
+  int CntLiveRegsOutsideIntrvls_(const SchedInstruction *inst,
+                                 int16_t regType) const;
   void SetupPhysRegs_();
   // can only compute SLIL if SLIL was the spillCostFunc
   // This function must only be called after the regPressures_ is computed
   InstCount CmputCostForFunction(SPILL_COST_FUNCTION SpillCF);
   void CmputCrntSpillCost_();
+  // A lower bound on the unnormalized spill cost of any schedule that
+  // completes the current partial schedule.
+  InstCount CmputPartialSpillCostLwrBound_();
   bool ChkSchedule_(InstSchedule *bestSched, InstSchedule *lstSched);
   void CmputCnflcts_(InstSchedule *sched);
 
+  // Builds and sets up the regions of the extra threads. Returns false if
+  // that failed, in which case the enumeration is done serially.
+  bool SetupPrllWrkrs_(Milliseconds lngthTimeout);
+  void FreePrllWrkrs_();
+  // Searches one target length on this thread and the extra threads.
+  FUNC_RESULT EnumeratePrll_(InstCount trgtLngth, int costLwrBound,
+                             Milliseconds lngthDeadline);
+
 public:
   BBWithSpill(const OptSchedTarget *OST_, DataDepGraph *dataDepGraph,
               long rgnNum, int16_t sigHashSize, LB_ALG lbAlg,
@@ -129,6 +179,20 @@ public:
   void addRecordedCost(SPILL_COST_FUNCTION Scf);
   void storeExtraCost(InstSchedule *sched, SPILL_COST_FUNCTION Scf);
   InstCount getUnnormalizedIncrementalRPCost() const;
+  InstCount getPartialCostLwrBound(InstCount lngthLwrBound);
+  InstCount getPartialNormSpillCostLwrBound();
+
+  // Sets how the copies of the region used by the extra threads of
+  // setParallelEnum(), setParallelAco() and pipelined ACO are built.
+  void setParallelWorkerFactory(std::function<ParallelEnumWorker()> mkWrkr);
+  // Enumerates each target length on wrkrCnt extra threads, each with its own
+  // copy of the region. The search tree is split among the threads at
+  // splitDepth. Only the single-pass algorithm is parallelized.
+  void setParallelEnum(int wrkrCnt, InstCount splitDepth);
+  // Constructs the ants of each ACO iteration on wrkrCnt extra threads, each
+  // with its own copy of the region. Only the single-pass algorithm is
+  // parallelized.
+  void setParallelAco(int wrkrCnt);
 
   void CmputAndSetCostLwrBound();
   int cmputSpillCostLwrBound();
@@ -160,6 +224,14 @@ protected:
   inline virtual const std::vector<int> &GetSLIL_() const {
     return sumOfLiveIntervalLengths_;
   }
+
+  std::vector<SchedRegion *> SetupAcoWrkrs_();
+  void FreeAcoWrkrs_();
+  SchedRegion *SetupPipelinedAcoWrkr_();
+  void FreePipelinedAcoWrkr_();
+  // Builds wrkr as a copy of this region for ACO to schedule. Returns false if
+  // the copy disagrees with this region.
+  bool SetupAcoWrkr_(ParallelEnumWorker &wrkr);
 };
 
 } // namespace opt_sched
@@ -10,16 +10,171 @@ Last Update:  Mar. 2011
 
 #include "opt-sched/Scheduler/logger.h"
 #include "opt-sched/Scheduler/mem_mngr.h"
+#include "llvm/Support/MathExtras.h"
+#include <cstdint>
 #include <cstring>
 #include <memory>
 
 namespace llvm {
 namespace opt_sched {
 
+// Kernels over arrays of 64-bit words, shared by BitVector and the other sets
+// that are stored as raw words, such as the scheduled instructions of history
+// nodes. The loops work on LaneCnt independent words at a time, so that the
+// compiler can keep them in vector registers.
+namespace BitWords {
+typedef uint64_t Word;
+
+const int BitsInWord = 64;
+const int LaneCnt = 4;
+
+// The number of words that hold bitCnt bits.
+inline int getWordCnt(int bitCnt) {
+  return (bitCnt + BitsInWord - 1) / BitsInWord;
+}
+
+inline int cntOnes(Word W) { return llvm::countPopulation(W); }
+
+// Returns the number of one bits in the words.
+inline int cntOnes(const Word *Ws, int Cnt) {
+  int i = 0;
+  int LaneSum[LaneCnt] = {0, 0, 0, 0};
+  for (; i + LaneCnt <= Cnt; i += LaneCnt)
+    for (int l = 0; l < LaneCnt; l++)
+      LaneSum[l] += cntOnes(Ws[i + l]);
+
+  int Sum = (LaneSum[0] + LaneSum[1]) + (LaneSum[2] + LaneSum[3]);
+  for (; i < Cnt; i++)
+    Sum += cntOnes(Ws[i]);
+  return Sum;
+}
+
+// Returns the number of bits that are one in both A and B.
+inline int cntCommonOnes(const Word *A, const Word *B, int Cnt) {
+  int i = 0;
+  int LaneSum[LaneCnt] = {0, 0, 0, 0};
+  for (; i + LaneCnt <= Cnt; i += LaneCnt)
+    for (int l = 0; l < LaneCnt; l++)
+      LaneSum[l] += cntOnes(A[i + l] & B[i + l]);
+
+  int Sum = (LaneSum[0] + LaneSum[1]) + (LaneSum[2] + LaneSum[3]);
+  for (; i < Cnt; i++)
+    Sum += cntOnes(A[i] & B[i]);
+  return Sum;
+}
+
+// Dst = Dst & Src, Dst | Src and Dst & ~Src. Each returns the number of one
+// bits in the result.
+inline int andWith(Word *Dst, const Word *Src, int Cnt) {
+  for (int i = 0; i < Cnt; i++)
+    Dst[i] &= Src[i];
+  return cntOnes(Dst, Cnt);
+}
+
+inline int orWith(Word *Dst, const Word *Src, int Cnt) {
+  for (int i = 0; i < Cnt; i++)
+    Dst[i] |= Src[i];
+  return cntOnes(Dst, Cnt);
+}
+
+inline int andNotWith(Word *Dst, const Word *Src, int Cnt) {
+  for (int i = 0; i < Cnt; i++)
+    Dst[i] &= ~Src[i];
+  return cntOnes(Dst, Cnt);
+}
+
+// Returns true if every one bit of A is also one in B.
+inline bool isSubset(const Word *A, const Word *B, int Cnt) {
+  int i = 0;
+  // Combine the words of a block without branching, and branch once per
+  // block.
+  for (; i + LaneCnt <= Cnt; i += LaneCnt) {
+    Word Extra = 0;
+    for (int l = 0; l < LaneCnt; l++)
+      Extra |= A[i + l] & ~B[i + l];
+    if (Extra != 0)
+      return false;
+  }
+
+  for (; i < Cnt; i++)
+    if ((A[i] & ~B[i]) != 0)
+      return false;
+  return true;
+}
+
+inline bool equal(const Word *A, const Word *B, int Cnt) {
+  int i = 0;
+  for (; i + LaneCnt <= Cnt; i += LaneCnt) {
+    Word Diff = 0;
+    for (int l = 0; l < LaneCnt; l++)
+      Diff |= A[i + l] ^ B[i + l];
+    if (Diff != 0)
+      return false;
+  }
+
+  for (; i < Cnt; i++)
+    if (A[i] != B[i])
+      return false;
+  return true;
+}
+
+inline bool getBit(const Word *Ws, int Indx) {
+  return (Ws[Indx / BitsInWord] >> (Indx % BitsInWord)) & 1;
+}
+
+inline void setBit(Word *Ws, int Indx) {
+  Ws[Indx / BitsInWord] |= Word(1) << (Indx % BitsInWord);
+}
+
+// Returns the index of the first one bit at or after Indx, or -1 if there is
+// none. Cnt is the number of words.
+inline int findNext(const Word *Ws, int Cnt, int Indx) {
+  int i = Indx / BitsInWord;
+  if (i >= Cnt)
+    return -1;
+
+  // Drop the bits before Indx from its word.
+  Word W = Ws[i] & (~Word(0) << (Indx % BitsInWord));
+  while (W == 0) {
+    if (++i == Cnt)
+      return -1;
+    W = Ws[i];
+  }
+  return i * BitsInWord + llvm::countTrailingZeros(W);
+}
+} // namespace BitWords
+
 class BitVector {
 public:
   // The actual integral type that is used to store the bits.
-  typedef unsigned int Unit;
+  typedef BitWords::Word Unit;
+
+  // Iterates over the indices of the one bits, in increasing order.
+  class SetBitIterator {
+  public:
+    SetBitIterator(const BitVector *vctr, int index)
+        : vctr_(vctr), index_(index) {}
+    int operator*() const { return index_; }
+    SetBitIterator &operator++() {
+      index_ = vctr_->FindNext(index_ + 1);
+      return *this;
+    }
+    bool operator!=(const SetBitIterator &othr) const {
+      return index_ != othr.index_;
+    }
+
+  private:
+    const BitVector *vctr_;
+    int index_;
+  };
+
+  struct SetBitRange {
+    const BitVector *vctr;
+    SetBitIterator begin() const {
+      return SetBitIterator(vctr, vctr->FindNext(0));
+    }
+    SetBitIterator end() const { return SetBitIterator(vctr, -1); }
+  };
 
   // Constructs a bit vector of a given length.
   BitVector(int length = 0);
@@ -29,6 +184,10 @@ public:
   // Reconstructs the vector to hold a vector of the new length. All old data
   // is discarded.
   void Construct(int length);
+  // Makes the vector use the length bits at vctr, which it does not own,
+  // instead of a buffer of its own. The bits are left as they are, so the
+  // vector can view a row of a larger matrix of bits.
+  void Attach(Unit *vctr, int length);
 
   // Sets all bits to 0.
   virtual void Reset();
@@ -40,11 +199,26 @@ public:
   int GetOneCnt() const;
   // Returns the number of bits in the vector.
   int GetSize() const;
+  // Returns the index of the first one bit at or after index, or -1 if there
+  // is none.
+  int FindNext(int index) const;
+  // The indices of the one bits, for use in a range-based for loop. Only the
+  // words that have one bits in them are looked at closely.
+  SetBitRange GetSetBits() const;
   // Create a bit vector that is the "bitwise and" of this bit vector and
   // another bit vector.
   std::unique_ptr<BitVector> And(BitVector *otherBitVector) const;
   // Returns true if this BitVector's one bits are a subset of "otherBitVector".
   bool IsSubVector(BitVector *otherBitVector) const;
+  // Returns the number of bits that are one in both vectors. Both vectors must
+  // be of the same size.
+  int CntCommonOnes(const BitVector &othr) const;
+
+  // In-place "bitwise and", "bitwise or" and "bitwise and not" with another
+  // vector of the same size.
+  void AndWith(const BitVector &othr);
+  void OrWith(const BitVector &othr);
+  void AndNotWith(const BitVector &othr);
 
   // Assigns the values from src to the vector. Both vectors must be of the
   // same size.
@@ -61,11 +235,13 @@ protected:
   int unitCnt_;
   // The number of ones currently in the vector.
   int oneCnt_;
+  // Whether vctr_ was allocated by this vector rather than attached to it.
+  bool ownsVctr_;
 
   // Gets a Unit-sized bitmask for a given bit, inverted if val = false.
   static Unit GetMask_(int bitNum, bool val);
   // The number of bits per storage unit.
-  static const int BITS_IN_UNIT = sizeof(Unit) * 8;
+  static const int BITS_IN_UNIT = BitWords::BitsInWord;
 };
 
 inline BitVector::BitVector(int length) {
@@ -73,12 +249,18 @@ inline BitVector::BitVector(int length) {
   unitCnt_ = 0;
   oneCnt_ = 0;
   vctr_ = NULL;
+  ownsVctr_ = true;
   Construct(length);
 }
 
 inline void BitVector::Construct(int length) {
+  if (!ownsVctr_) {
+    vctr_ = NULL;
+    ownsVctr_ = true;
+  }
+
   bitCnt_ = length;
-  unitCnt_ = (bitCnt_ + BITS_IN_UNIT - 1) / BITS_IN_UNIT;
+  unitCnt_ = BitWords::getWordCnt(bitCnt_);
 
   if (unitCnt_ == 0)
     return;
@@ -94,8 +276,18 @@ inline void BitVector::Construct(int length) {
   oneCnt_ = 0;
 }
 
+inline void BitVector::Attach(Unit *vctr, int length) {
+  if (vctr_ != NULL && ownsVctr_)
+    delete[] vctr_;
+  vctr_ = vctr;
+  ownsVctr_ = false;
+  bitCnt_ = length;
+  unitCnt_ = BitWords::getWordCnt(bitCnt_);
+  oneCnt_ = BitWords::cntOnes(vctr_, unitCnt_);
+}
+
 inline BitVector::~BitVector() {
-  if (vctr_ != NULL)
+  if (vctr_ != NULL && ownsVctr_)
     delete[] vctr_;
 }
 
@@ -114,24 +306,30 @@ inline void BitVector::SetBit(int index, bool bitVal) {
   assert(index < bitCnt_);
   int unitNum = index / BITS_IN_UNIT;
   int bitNum = index - unitNum * BITS_IN_UNIT;
-  Unit mask = GetMask_(bitNum, bitVal);
-
-  if (bitVal) {
-    if (GetBit(index) == false)
-      oneCnt_++;
-    vctr_[unitNum] |= mask;
-  } else {
-    if (GetBit(index) == true)
-      oneCnt_--;
-    vctr_[unitNum] &= mask;
-  }
+  Unit mask = GetMask_(bitNum, true);
+  Unit old = vctr_[unitNum];
+
+  if (bitVal)
+    vctr_[unitNum] = old | mask;
+  else
+    vctr_[unitNum] = old & ~mask;
+  // Adds one if the bit was set and subtracts one if it was cleared.
+  oneCnt_ += (vctr_[unitNum] != old) ? (bitVal ? 1 : -1) : 0;
 }
 
 inline bool BitVector::GetBit(int index) const {
   assert(index < bitCnt_);
-  int unitNum = index / BITS_IN_UNIT;
-  int bitNum = index - unitNum * BITS_IN_UNIT;
-  return (vctr_[unitNum] & GetMask_(bitNum, true)) != 0;
+  return BitWords::getBit(vctr_, index);
+}
+
+inline int BitVector::FindNext(int index) const {
+  if (index >= bitCnt_)
+    return -1;
+  return BitWords::findNext(vctr_, unitCnt_, index);
+}
+
+inline BitVector::SetBitRange BitVector::GetSetBits() const {
+  return SetBitRange{this};
 }
 
 inline bool BitVector::IsSubVector(BitVector *other) const {
@@ -139,33 +337,50 @@ inline bool BitVector::IsSubVector(BitVector *other) const {
   // The other vector must be at least as large as this vector.
   if (unitCnt_ > other->unitCnt_)
     return false;
+  if (oneCnt_ > other->oneCnt_)
+    return false;
 
-  for (int i = 0; i < unitCnt_; i++) {
-    if ((vctr_[i] & other->vctr_[i]) != vctr_[i])
-      return false;
-  }
-  return true;
+  return BitWords::isSubset(vctr_, other->vctr_, unitCnt_);
 }
 
 inline std::unique_ptr<BitVector>
 BitVector::And(BitVector *otherBitVector) const {
   assert(otherBitVector != NULL);
-  // Set length to the larger of the two vectors
+  // Set length to the larger of the two vectors. The bits past the end of the
+  // shorter vector are zero in the result.
   int bitCnt =
       bitCnt_ > otherBitVector->bitCnt_ ? bitCnt_ : otherBitVector->bitCnt_;
   std::unique_ptr<BitVector> andedVector(new BitVector(bitCnt));
 
-  for (int i = 0; i < andedVector->unitCnt_; i++) {
-    andedVector->vctr_[i] = vctr_[i] & otherBitVector->vctr_[i];
+  int cmnUnitCnt = unitCnt_ < otherBitVector->unitCnt_
+                       ? unitCnt_
+                       : otherBitVector->unitCnt_;
+  if (cmnUnitCnt == 0)
+    return andedVector;
+  memcpy(andedVector->vctr_, vctr_, cmnUnitCnt * sizeof(Unit));
+  andedVector->oneCnt_ =
+      BitWords::andWith(andedVector->vctr_, otherBitVector->vctr_, cmnUnitCnt);
+  return andedVector;
+}
 
-    // TODO(austin) This may not be portable enough.
-    // This is a built in gcc function for counting the number of 1 bits
-    // in a number. When using x86 it should be implemented as a single
-    // instruction ie "popcnt %rdi, %rax"
-    andedVector->oneCnt_ += __builtin_popcountll(andedVector->vctr_[i]);
-  }
+inline int BitVector::CntCommonOnes(const BitVector &othr) const {
+  assert(bitCnt_ == othr.bitCnt_);
+  return BitWords::cntCommonOnes(vctr_, othr.vctr_, unitCnt_);
+}
 
-  return andedVector;
+inline void BitVector::AndWith(const BitVector &othr) {
+  assert(bitCnt_ == othr.bitCnt_);
+  oneCnt_ = BitWords::andWith(vctr_, othr.vctr_, unitCnt_);
+}
+
+inline void BitVector::OrWith(const BitVector &othr) {
+  assert(bitCnt_ == othr.bitCnt_);
+  oneCnt_ = BitWords::orWith(vctr_, othr.vctr_, unitCnt_);
+}
+
+inline void BitVector::AndNotWith(const BitVector &othr) {
+  assert(bitCnt_ == othr.bitCnt_);
+  oneCnt_ = BitWords::andNotWith(vctr_, othr.vctr_, unitCnt_);
 }
 
 inline int BitVector::GetSize() const { return bitCnt_; }
@@ -184,8 +399,7 @@ inline bool BitVector::operator==(const BitVector &other) const {
   assert(bitCnt_ == other.bitCnt_);
   if (oneCnt_ != other.oneCnt_)
     return false;
-  int byteCnt = unitCnt_ * sizeof(Unit);
-  return (memcmp(vctr_, other.vctr_, byteCnt) == 0);
+  return BitWords::equal(vctr_, other.vctr_, unitCnt_);
 }
 
 inline BitVector::Unit BitVector::GetMask_(int bitNum, bool bitVal) {
@@ -228,20 +442,17 @@ inline void WeightedBitVector::SetBit(int index, bool bitVal, int weight) {
   assert(index < bitCnt_);
   int unitNum = index / BITS_IN_UNIT;
   int bitNum = index - unitNum * BITS_IN_UNIT;
-  Unit mask = GetMask_(bitNum, bitVal);
+  Unit mask = GetMask_(bitNum, true);
+  Unit old = vctr_[unitNum];
 
-  if (bitVal) {
-    if (GetBit(index) == false) {
-      oneCnt_++;
-      wghtedCnt_ += weight;
-    }
-    vctr_[unitNum] |= mask;
-  } else {
-    if (GetBit(index) == true) {
-      oneCnt_--;
-      wghtedCnt_ -= weight;
-    }
-    vctr_[unitNum] &= mask;
+  if (bitVal)
+    vctr_[unitNum] = old | mask;
+  else
+    vctr_[unitNum] = old & ~mask;
+
+  if (vctr_[unitNum] != old) {
+    oneCnt_ += bitVal ? 1 : -1;
+    wghtedCnt_ += bitVal ? weight : -weight;
   }
 }
 
@@ -291,6 +291,10 @@ public:
 
   RegisterFile *getRegFiles() { return RegFiles.get(); }
 
+  // Returns the store of the hot fields of the graph's instructions, which is
+  // indexed by instruction number.
+  SchedInstStore *GetInstStore() { return &instStore_; }
+
 protected:
   // TODO(max): Get rid of this.
   // Number of basic blocks
@@ -374,6 +378,9 @@ protected:
   // object holds all registers for a given register type.
   std::unique_ptr<RegisterFile[]> RegFiles;
 
+  // The hot fields of the instructions in insts_.
+  SchedInstStore instStore_;
+
   void AllocArrays_(InstCount instCnt);
   FUNC_RESULT ParseF2Nodes_(SpecsBuffer *specsBuf, MachineModel *machMdl);
   FUNC_RESULT ParseF2Edges_(SpecsBuffer *specsBuf, MachineModel *machMdl);
@@ -12,8 +12,10 @@ Last Update:  Apr. 2020
 #include "opt-sched/Scheduler/defines.h"
 #include "opt-sched/Scheduler/gen_sched.h"
 #include "opt-sched/Scheduler/mem_mngr.h"
+#include "opt-sched/Scheduler/parallel_enum.h"
 #include "opt-sched/Scheduler/ready_list.h"
 #include "opt-sched/Scheduler/relaxed_sched.h"
+#include "opt-sched/Scheduler/undo_trail.h"
 #include <iostream>
 #include <vector>
 
@@ -41,6 +43,15 @@ struct Pruning {
 
 enum ENUMTREE_NODEMODE { ETN_PRELIM, ETN_ACTIVE, ETN_HISTORY };
 
+// Which entry to evict from the history table when it reaches its memory
+// limit. The entry is chosen among those sharing the new entry's bucket.
+enum HIST_EVICTION {
+  // The entry that was least recently matched by a domination test.
+  HE_LEAST_RECENTLY_MATCHED,
+  // The entry closest to the root of the enumeration tree.
+  HE_SHALLOWEST
+};
+
 struct TightndInst {
   SchedInstruction *inst;
   InstCount tightBound;
@@ -54,6 +65,7 @@ class EnumTreeNode {
 private:
   friend class HistEnumTreeNode;
   friend class CostHistEnumTreeNode;
+  friend class EnumTreeNodeAlloc;
 
   class ExaminedInst {
   private:
@@ -66,6 +78,9 @@ private:
                  LinkedList<SchedInstruction> *dirctTightndLst);
     ~ExaminedInst();
 
+    // Reinitializes a recycled record.
+    void Construct(SchedInstruction *inst, bool wasRlxInfsbl);
+
     inline SchedInstruction *GetInst();
     inline bool wasRlxInfsbl() { return wasRlxInfsbl_; }
     inline bool IsRsrcDmntd(SchedInstruction *cnddtInst);
@@ -103,16 +118,10 @@ private:
 
   ENUMTREE_NODEMODE mode_;
 
-  // Array of instructions' forward lower bounds tightened up to this node
-  InstCount *frwrdLwrBounds_;
-
-  // Array hloding the number of issue slots available for each issue type
-  // based on the target schedule length and the slots that have been taken
-  InstCount avlblSlots_[MAX_ISSUTYPE_CNT];
-
-  // Array hloding the number of issue slots available for each issue type
-  // in the current machine cycle
-  int16_t avlblSlotsInCrntCycle_[MAX_ISSUTYPE_CNT];
+  // The size of the enumerator's undo trail when this node was entered.
+  // Popping the trail back to it restores the lower bounds and the slot
+  // counts of this node.
+  UndoTrail::Mark trailMark_;
 
   bool crntCycleBlkd_;
   int realSlotNum_;
@@ -158,7 +167,11 @@ private:
   InstCount SpillCost_;
   InstCount MinSuffixRPLowerBound;
   bool totalCostIsActualCost_ = false;
+  // The reserved issue slots at this node, or NULL if no unpipelined
+  // instructions are in flight. Points into rsrvSlotsBuf_, which is allocated
+  // once with the node.
   ReserveSlot *rsrvSlots_;
+  ReserveSlot *rsrvSlotsBuf_;
 
   // (Chris)
   using SuffixType = std::vector<SchedInstruction *>;
@@ -193,18 +206,12 @@ public:
 
   bool WasRsrcDmnntNodeExmnd(SchedInstruction *cnddtInst);
 
-  inline void SetSlotAvlblty(InstCount avlblSlots[],
-                             int16_t avlblSlotsInCrntCycle[]);
+  inline void SetTrailMark(UndoTrail::Mark mark);
+  inline UndoTrail::Mark GetTrailMark();
 
   inline InstCount GetBranchCnt(bool &isEmpty);
   inline InstCount GetBranchCnt();
 
-  // Return a pointer to the array of lower bounds
-  inline InstCount *GetLwrBounds(DIRECTION dir);
-
-  inline void GetLwrBounds(DIRECTION dir, InstCount lwrBounds[]);
-  inline void GetSlotAvlblty(InstCount avlblSlots[],
-                             int16_t avlblSlotsInCrntCycle[]);
   inline InstCount GetCrntBranchNum();
   inline SchedInstruction *GetInst();
   inline InstCount GetInstNum();
@@ -228,9 +235,6 @@ public:
 
   bool DoesPartialSchedMatch(EnumTreeNode *othr);
 
-  void SetLwrBounds(DIRECTION dir);
-  void SetLwrBounds();
-
   void SetRsrvSlots(int16_t rsrvSlotCnt, ReserveSlot *rsrvSlots);
 
   // Add a node to the list of nodes dominated by this node
@@ -321,13 +325,85 @@ public:
 };
 /*****************************************************************************/
 
-class EnumTreeNodeAlloc : public MemAlloc<EnumTreeNode> {
+// Allocates the nodes of the enumeration tree. Only the nodes on the path from
+// the root to the current node, plus the candidate node being probed, are
+// alive at any time, so there is exactly one node per depth (time step) and
+// the nodes are kept in an array indexed by depth. Freeing a node releases it
+// and the whole subtree below it by lowering a watermark; released nodes are
+// cleaned up when their depth is reached again. The nodes keep their arrays
+// and lists across uses, and the allocator recycles the examined-instruction
+// records, so stepping forward and backtracking make no heap allocations once
+// every depth has been visited.
+class EnumTreeNodeAlloc {
 public:
   inline EnumTreeNodeAlloc(int maxSize);
   inline ~EnumTreeNodeAlloc();
   inline EnumTreeNode *Alloc(EnumTreeNode *prevNode, SchedInstruction *inst,
                              Enumerator *enumrtr);
+  // Releases the node and all the nodes below it.
   inline void Free(EnumTreeNode *node);
+  // Releases all the nodes.
+  inline void Reset();
+  inline EnumTreeNode::ExaminedInst *AllocExmndInst(SchedInstruction *inst,
+                                                    bool wasRlxInfsbl);
+  inline void FreeExmndInst(EnumTreeNode::ExaminedInst *exmndInst);
+
+private:
+  // The number of depths.
+  int maxSize_;
+  // The node at each depth.
+  EnumTreeNode *nodes_;
+  // Examined-instruction records that are free for reuse.
+  std::vector<EnumTreeNode::ExaminedInst *> freeExmndInsts_;
+  // The lowest depth whose node is free.
+  InstCount wtrMark_;
+};
+/*****************************************************************************/
+
+// The unscheduled instructions of each issue type, bucketed by their current
+// forward lower bound, so that the instructions whose lower bound is below a
+// given cycle can be found without scanning the whole region.
+class FrwrdLwrBoundIndex {
+public:
+  FrwrdLwrBoundIndex();
+
+  // Lower bounds of bktCnt - 1 or more share the last bucket.
+  void Construct(DataDepGraph *dataDepGraph, int16_t issuTypeCnt,
+                 InstCount bktCnt);
+
+  // Indexes all the instructions that are not scheduled.
+  void Build();
+  void Insert(SchedInstruction *inst);
+  void Remove(SchedInstruction *inst);
+  // Moves an indexed instruction to the bucket of its current lower bound.
+  // Does nothing if the instruction is not indexed or has not moved.
+  void Update(SchedInstruction *inst);
+
+  // Appends the indexed instructions of the given issue type whose lower
+  // bound is less than the given cycle to insts.
+  void GetInstsBelow(IssueType issuType, InstCount cycle,
+                     std::vector<SchedInstruction *> &insts);
+
+private:
+  InstCount GetBkt_(InstCount instNum) const;
+  void Link_(InstCount instNum, InstCount bkt);
+  void Unlink_(InstCount instNum);
+
+  DataDepGraph *dataDepGraph_;
+  // The graph's store, from which the bounds and issue types are read.
+  SchedInstStore *instStore_;
+  int16_t issuTypeCnt_;
+  InstCount bktCnt_;
+  // The first instruction in each bucket, or INVALID_VALUE. The buckets of
+  // each issue type are consecutive.
+  std::vector<InstCount> bktHeads_;
+  // The lowest bucket of each issue type that may not be empty.
+  std::vector<InstCount> minBkts_;
+  // The bucket of each instruction, or INVALID_VALUE if it is not indexed,
+  // and its neighbors in the bucket.
+  std::vector<InstCount> instBkts_;
+  std::vector<InstCount> nxtInsts_;
+  std::vector<InstCount> prevInsts_;
 };
 /*****************************************************************************/
 
@@ -376,9 +452,43 @@ protected:
   uint64_t createdNodeCnt_;
   uint64_t exmndNodeCnt_;
 
-  InstCount minUnschduldTplgclOrdr_;
-
-  BinHashTable<HistEnumTreeNode> *exmndSubProbs_;
+  // The history table searched and updated by this enumerator. While several
+  // threads enumerate the same target length, this is the table of the main
+  // thread's enumerator, which all of them share.
+  ShardedBinHashTable<HistEnumTreeNode> *exmndSubProbs_;
+  // The history table owned by this enumerator.
+  ShardedBinHashTable<HistEnumTreeNode> *ownExmndSubProbs_;
+  // The width of the partial schedule signatures in bits.
+  int16_t histSigBits_;
+  // The number of history entries whose signature matched that of a node
+  // tested for domination, and how many of those were aliases, i.e. had
+  // different scheduled instructions.
+  uint64_t histSigTestCnt_;
+  uint64_t histSigAliasCnt_;
+  // The time spent in history domination tests in nanoseconds. Only measured
+  // with IS_DEBUG_SPD, since reading the clock on each test is costly.
+  uint64_t histDmntnChkTime_;
+
+  // The memory limit on the history kept by this enumerator in bytes, or 0 if
+  // there is no limit.
+  uint64_t histMaxBytes_;
+  HIST_EVICTION histEvctnPlcy_;
+  // The approximate memory taken by the history nodes inserted into the
+  // table, including evicted nodes that are still needed by their children.
+  uint64_t histBytes_;
+  uint64_t peakHistBytes_;
+  uint64_t evctdHistCnt_;
+  uint64_t rjctdHistCnt_;
+  // The number of failed domination tests that had a signature matching that
+  // of an evicted entry, i.e. the dominations that may have been lost.
+  uint64_t lostHistDmntnCnt_;
+  // The signatures of the evicted entries, each hashed to one bit.
+  BitVector *evctdSigs_;
+
+  // The number of relaxed feasibility checks and the time spent in them in
+  // nanoseconds.
+  uint64_t rlxdChkCnt_;
+  uint64_t rlxdChkTime_;
 
   // A list of insts whose lower bounds have been tightened to be used for
   // efficient untightening
@@ -386,6 +496,17 @@ protected:
   LinkedList<SchedInstruction> *bkwrdTightndLst_;
   LinkedList<SchedInstruction> *dirctTightndLst_;
 
+  // The unscheduled instructions by forward lower bound, which limits the
+  // tightening after each step to the instructions whose bound can change.
+  FrwrdLwrBoundIndex lwrBoundIndx_;
+  // The instructions whose lower bounds are raised directly in a step.
+  std::vector<SchedInstruction *> tightnCands_;
+
+  // The changes to the lower bounds and the slot counts since the root node.
+  // Each tree node keeps a mark into it, and backtracking pops back to the
+  // mark of the node that becomes current.
+  UndoTrail trail_;
+
   // A list of insts which got fixed in certain cycles to be used for
   // efficient unfixing
   LinkedList<SchedInstruction> *fxdLst_;
@@ -415,17 +536,30 @@ protected:
   bool alctrsSetup_;
   MemAlloc<BinHashTblEntry<HistEnumTreeNode>> *hashTblEntryAlctr_;
   EnumTreeNodeAlloc *nodeAlctr_;
-
-  InstCount *tmpLwrBounds_;
+  // The ready list of the search. Stepping forward saves its state and
+  // backtracking restores it, so all the nodes on the current path share it.
+  ReadyList *enumRdyLst_;
 
   int memAllocBlkSize_;
 
   HistEnumTreeNode *tmpHstryNode_;
 
-  BitVector *bitVctr1_;
-  BitVector *bitVctr2_;
   SchedInstruction **lastInsts_;
-  SchedInstruction **othrLastInsts_;
+
+  // The number of the last issue slots whose instructions a history node
+  // keeps for domination tests.
+  InstCount histWndwSize_;
+  // The number of 64-bit words in a history node's set of scheduled insts.
+  InstCount histSchduldWordCnt_;
+  // Arenas for the arrays of the history nodes.
+  ArrayMemAlloc<InstCount> *histInstNumsAlctr_;
+  ArrayMemAlloc<uint64_t> *histSchduldAlctr_;
+  ArrayMemAlloc<InstCount> *histRsrvAlctr_;
+  // The arrays of the temporary history node.
+  InstCount *tmpHistInstNums_;
+  uint64_t *tmpHistSchduld_;
+  // The window of a history node that does not keep its own.
+  InstCount *histWndwBuf_;
 
   int fsblSchedCnt_;
   int imprvmntCnt_;
@@ -446,6 +580,16 @@ protected:
   // history domination
   HistEnumTreeNode *mostRecentMatchingHistNode_ = nullptr;
 
+  // The state shared with the other threads when this enumerator is one of
+  // several searching the same target length in parallel, or NULL.
+  ParallelEnumContext *prllCntxt_ = nullptr;
+  // The subproblem that this thread is searching in a parallel search, or
+  // NULL while it expands the tree down to the split depth.
+  const SubProblemPool::Prefix *prllSubProb_ = nullptr;
+  // Whether this enumerator records the global statistics. When enumerating
+  // in parallel, only the main thread's enumerator does.
+  bool rcrdStats_ = true;
+
   inline void ClearState_();
   inline bool IsStateClear_();
 
@@ -486,6 +630,15 @@ protected:
   // by scheduling the given instruction next
   bool WasDmnntSubProbExmnd_(SchedInstruction *inst, EnumTreeNode *&newNode);
 
+  // Adds the subtree rooted at the given node at the split depth to the
+  // subproblems of the parallel search.
+  void AddSubProb_(EnumTreeNode *node);
+  // Does the given branch from the current node leave the path to the
+  // subproblem that this thread is searching?
+  inline bool IsOffSubProbPath_(SchedInstruction *inst);
+  // Is the subtree below the given node being shared with other threads?
+  inline bool IsSubProbShared_(EnumTreeNode *node);
+
   bool TightnLwrBounds_(SchedInstruction *inst);
   void UnTightnLwrBounds_(SchedInstruction *newInst);
   void CmtLwrBoundTightnng_();
@@ -494,9 +647,14 @@ protected:
   void UnFixInsts_(SchedInstruction *newInst);
   void CmtInstFxng_();
 
-  void RestoreCrntLwrBounds_(SchedInstruction *unschduldInst);
+  // Undoes the changes pushed to the trail since the current node was
+  // entered. unschduldInst is the instruction that is being unscheduled, if
+  // any, whose fixing in the relaxed schedule is also undone.
+  void PopTrail_(SchedInstruction *unschduldInst);
+  inline void SetAvlblSlots_(IssueType issuType, InstCount slotCnt);
+  inline void SetAvlblSlotsInCrntCycle_(IssueType issuType, int16_t slotCnt);
 
-  inline void CreateNewRdyLst_();
+  inline void InitRdyLst_();
   bool RlxdSchdul_(EnumTreeNode *newNode);
 
   inline InstCount GetCycleNumFrmTime_(InstCount time);
@@ -512,6 +670,8 @@ protected:
   virtual void SetupAllocators_();
   virtual void FreeAllocators_();
   virtual void ResetAllocators_();
+  // Resets the state of the search other than the allocators and the history.
+  void ResetSrchState_();
 
   inline bool getIsTwoPass() { return IsTwoPassEnabled_; }
   inline bool getIsSecondPass() { return IsSecondPass_; }
@@ -525,6 +685,17 @@ protected:
 
   void PrintLog_();
 
+  // Inserts the history of the given archived node into the history table,
+  // evicting other entries if needed to stay within the memory limit.
+  void InsrtHistNode_(EnumTreeNode *node);
+  // Evicts entries, preferably from the bucket of the given signature, until
+  // a node of the given size fits within the memory limit. Returns false if
+  // it could not.
+  bool MakeRoomForHistNode_(InstSignature sig, size_t nodeBytes);
+  // Frees an evicted history node if it is no longer needed, and then its
+  // ancestors that are no longer needed either.
+  void FreeEvctdHistNode_(HistEnumTreeNode *histNode);
+
   FUNC_RESULT FindFeasibleSchedule_(InstSchedule *sched, InstCount trgtLngth,
                                     Milliseconds deadline);
 
@@ -554,6 +725,11 @@ public:
   // Get the number of nodes that have been examined
   inline uint64_t GetNodeCnt();
 
+  // The number of relaxed feasibility checks, and the time taken by them in
+  // nanoseconds.
+  uint64_t GetRlxdChkCnt() const { return rlxdChkCnt_; }
+  uint64_t GetRlxdChkTime() const { return rlxdChkTime_; }
+
   inline int GetSearchCnt();
 
   inline bool IsHistDom();
@@ -563,6 +739,25 @@ public:
   // (Chris)
   inline bool IsSchedForRPOnly() const { return SchedForRPOnly_; }
 
+  // Makes this enumerator one of several threads searching the same target
+  // length, or a stand-alone enumerator again if cntxt is NULL. The enumerator
+  // of the main thread must be attached first, since it provides the shared
+  // history table.
+  void SetParallelContext(ParallelEnumContext *cntxt, bool isMainThrd);
+  // Limits the search of a parallel enumerator to the subtree below the given
+  // partial schedule, or lifts the limit if subProb is NULL. Without a limit,
+  // the enumerator stops at the split depth and adds the subtrees there to
+  // the subproblems of the search instead of searching them.
+  void SetSubProb(const SubProblemPool::Prefix *subProb) {
+    prllSubProb_ = subProb;
+  }
+  // Prepares for searching the next subproblem of a parallel search. Unlike
+  // Reset(), this keeps the history table, which the threads share.
+  void ResetForSubProb();
+
+  // Reports the usage of the history table's shards.
+  void LogHistTableStats();
+
   // Calculates the schedule and returns it in the passed argument.
   FUNC_RESULT FindSchedule(InstSchedule *sched, SchedRegion *rgn) {
     return RES_ERROR;
@@ -696,26 +891,12 @@ void EnumTreeNode::LegalInstFound() {
 }
 /*****************************************************************************/
 
-inline void EnumTreeNode::SetSlotAvlblty(InstCount avlblSlots[],
-                                         int16_t avlblSlotsInCrntCycle[]) {
-  int16_t issuTypeCnt = enumrtr_->issuTypeCnt_;
-
-  for (int16_t i = 0; i < issuTypeCnt; i++) {
-    avlblSlots_[i] = avlblSlots[i];
-    avlblSlotsInCrntCycle_[i] = avlblSlotsInCrntCycle[i];
-  }
+inline void EnumTreeNode::SetTrailMark(UndoTrail::Mark mark) {
+  trailMark_ = mark;
 }
 /*****************************************************************************/
 
-inline void EnumTreeNode::GetSlotAvlblty(InstCount avlblSlots[],
-                                         int16_t avlblSlotsInCrntCycle[]) {
-  int16_t issuTypeCnt = enumrtr_->issuTypeCnt_;
-
-  for (int16_t i = 0; i < issuTypeCnt; i++) {
-    avlblSlots[i] = avlblSlots_[i];
-    avlblSlotsInCrntCycle[i] = avlblSlotsInCrntCycle_[i];
-  }
-}
+inline UndoTrail::Mark EnumTreeNode::GetTrailMark() { return trailMark_; }
 /*****************************************************************************/
 
 inline InstCount EnumTreeNode::GetBranchCnt(bool &isEmpty) {
@@ -727,28 +908,6 @@ inline InstCount EnumTreeNode::GetBranchCnt(bool &isEmpty) {
 InstCount EnumTreeNode::GetBranchCnt() { return brnchCnt_; }
 /**************************************************************************/
 
-void EnumTreeNode::GetLwrBounds(DIRECTION dir, InstCount lwrBounds[]) {
-  InstCount i;
-  InstCount *nodeLwrBounds;
-  InstCount instCnt = enumrtr_->totInstCnt_;
-
-  assert(dir == DIR_FRWRD);
-  nodeLwrBounds = frwrdLwrBounds_;
-
-  for (i = 0; i < instCnt; i++) {
-    lwrBounds[i] = nodeLwrBounds[i];
-  }
-}
-/**************************************************************************/
-
-InstCount *EnumTreeNode::GetLwrBounds(DIRECTION dir) {
-  InstCount *nodeLwrBounds;
-  assert(dir == DIR_FRWRD);
-  nodeLwrBounds = frwrdLwrBounds_;
-  return nodeLwrBounds;
-}
-/**************************************************************************/
-
 InstCount EnumTreeNode::GetCrntBranchNum() { return crntBrnchNum_; }
 /**************************************************************************/
 
@@ -1017,20 +1176,33 @@ inline bool Enumerator::IsStateClear_() {
 }
 /****************************************************************************/
 
-inline uint64_t Enumerator::GetNodeCnt() { return exmndNodeCnt_; }
+inline void Enumerator::SetAvlblSlots_(IssueType issuType, InstCount slotCnt) {
+  if (slotCnt != avlblSlots_[issuType]) {
+    trail_.Push(TK_AVLBL_SLOTS, issuType, avlblSlots_[issuType]);
+    avlblSlots_[issuType] = slotCnt;
+  }
+}
 /****************************************************************************/
 
-inline int Enumerator::GetSearchCnt() { return iterNum_; }
+inline void Enumerator::SetAvlblSlotsInCrntCycle_(IssueType issuType,
+                                                  int16_t slotCnt) {
+  if (slotCnt != avlblSlotsInCrntCycle_[issuType]) {
+    trail_.Push(TK_AVLBL_SLOTS_IN_CYCLE, issuType,
+                avlblSlotsInCrntCycle_[issuType]);
+    avlblSlotsInCrntCycle_[issuType] = slotCnt;
+  }
+}
 /****************************************************************************/
 
-inline void Enumerator::CreateNewRdyLst_() {
-  ReadyList *oldLst = rdyLst_;
+inline uint64_t Enumerator::GetNodeCnt() { return exmndNodeCnt_; }
+/****************************************************************************/
 
-  rdyLst_ = new ReadyList(dataDepGraph_, prirts_);
+inline int Enumerator::GetSearchCnt() { return iterNum_; }
+/****************************************************************************/
 
-  if (oldLst != NULL) {
-    rdyLst_->CopyList(oldLst);
-  }
+inline void Enumerator::InitRdyLst_() {
+  rdyLst_ = enumRdyLst_;
+  rdyLst_->Reset();
 }
 /****************************************************************************/
 
@@ -1067,25 +1239,70 @@ bool Enumerator::IsHistDom() { return prune_.histDom; }
 bool Enumerator::IsRlxdPrnng() { return prune_.rlxd; }
 /******************************************************************************/
 
-inline EnumTreeNodeAlloc::EnumTreeNodeAlloc(int maxSize)
-    : MemAlloc<EnumTreeNode>(maxSize, maxSize) {}
+bool Enumerator::IsSubProbShared_(EnumTreeNode *node) {
+  return prllCntxt_ != NULL && node->GetTime() < prllCntxt_->SplitDepth;
+}
+/******************************************************************************/
+
+bool Enumerator::IsOffSubProbPath_(SchedInstruction *inst) {
+  if (prllSubProb_ == NULL || !IsSubProbShared_(crntNode_))
+    return false;
+
+  InstCount instNum = inst == NULL ? SCHD_STALL : inst->GetNum();
+  return instNum != (*prllSubProb_)[crntNode_->GetTime()];
+}
+/******************************************************************************/
+
+inline EnumTreeNodeAlloc::EnumTreeNodeAlloc(int maxSize) {
+  maxSize_ = maxSize;
+  nodes_ = new EnumTreeNode[maxSize];
+  wtrMark_ = 0;
+}
 /****************************************************************************/
 
-inline EnumTreeNodeAlloc::~EnumTreeNodeAlloc() {}
+inline EnumTreeNodeAlloc::~EnumTreeNodeAlloc() {
+  delete[] nodes_;
+  for (EnumTreeNode::ExaminedInst *exmndInst : freeExmndInsts_)
+    delete exmndInst;
+}
 /****************************************************************************/
 
 inline EnumTreeNode *EnumTreeNodeAlloc::Alloc(EnumTreeNode *prevNode,
                                               SchedInstruction *inst,
                                               Enumerator *enumrtr) {
-  EnumTreeNode *node = GetObject();
+  InstCount depth = prevNode == NULL ? 0 : prevNode->time_ + 1;
+  assert(depth < maxSize_ && depth <= wtrMark_);
+  EnumTreeNode *node = nodes_ + depth;
   node->Construct(prevNode, inst, enumrtr);
+  wtrMark_ = depth + 1;
   return node;
 }
 /****************************************************************************/
 
 inline void EnumTreeNodeAlloc::Free(EnumTreeNode *node) {
-  node->Clean();
-  FreeObject(node);
+  assert(node == nodes_ + node->time_);
+  wtrMark_ = node->time_;
+}
+/****************************************************************************/
+
+inline void EnumTreeNodeAlloc::Reset() { wtrMark_ = 0; }
+/****************************************************************************/
+
+inline EnumTreeNode::ExaminedInst *
+EnumTreeNodeAlloc::AllocExmndInst(SchedInstruction *inst, bool wasRlxInfsbl) {
+  if (freeExmndInsts_.empty())
+    return new EnumTreeNode::ExaminedInst(inst, wasRlxInfsbl, NULL);
+
+  EnumTreeNode::ExaminedInst *exmndInst = freeExmndInsts_.back();
+  freeExmndInsts_.pop_back();
+  exmndInst->Construct(inst, wasRlxInfsbl);
+  return exmndInst;
+}
+/****************************************************************************/
+
+inline void
+EnumTreeNodeAlloc::FreeExmndInst(EnumTreeNode::ExaminedInst *exmndInst) {
+  freeExmndInsts_.push_back(exmndInst);
 }
 /****************************************************************************/
 
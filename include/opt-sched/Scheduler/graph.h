@@ -12,6 +12,7 @@ Last Update:  Mar. 2011
 #include "opt-sched/Scheduler/bit_vector.h"
 #include "opt-sched/Scheduler/defines.h"
 #include "opt-sched/Scheduler/lnkd_lst.h"
+#include <vector>
 
 namespace llvm {
 namespace opt_sched {
@@ -86,7 +87,9 @@ public:
   // Adds a new edge to the successor list and does some magic.
   // TODO(max): Elaborate on magic.
   void AddScsr(GraphEdge *edge);
-  // Adds a new node as a recursive successor.
+  // Adds a new node as a recursive successor. If the recursive successor list
+  // has been built, the node is appended to it, so the list stays complete but
+  // may no longer be in topological order.
   void AddRcrsvScsr(GraphNode *node);
   // Removes the last edge from the successor list and optionally deletes
   // the edge object. scsr must be the destination node of that edge.
@@ -102,7 +105,9 @@ public:
   // Adds a new edge to the predecessor list and does some magic.
   // TODO(max): Elaborate on magic.
   void AddPrdcsr(GraphEdge *edge);
-  // Adds a new node as a recursive predecessor.
+  // Adds a new node as a recursive predecessor. If the recursive predecessor
+  // list has been built, the node is appended to it, so the list stays
+  // complete but may no longer be in topological order.
   void AddRcrsvPrdcsr(GraphNode *node);
   // Removes the last edge from the predecessor list and optionally deletes
   // the edge object. scsr must be the destination node of that edge.
@@ -121,10 +126,6 @@ public:
   // Finds the predecessor edge from this node to the target node. Returns
   // null if not found.
   GraphEdge *FindPrdcsr(GraphNode *trgtNode);
-  // Fills the node's recursive predecessors or recursive successors list by
-  // doing a depth first traversal either up the predecessor tree or down the
-  // successor tree.
-  void FindRcrsvNghbrs(DIRECTION dir, DirAcycGraph *graph);
   // Adds the specified node to this node' recursive predecessor or successor
   // list, depending on which direction is specified.
   void AddRcrsvNghbr(GraphNode *nghbr, DIRECTION dir);
@@ -203,8 +204,19 @@ public:
   // Allocates memory for the node's predecessor or successor list and bitset,
   // depending on the specified direction.
   void AllocRcrsvInfo(DIRECTION dir, UDT_GNODES nodeCnt);
+  // Makes the node's predecessor or successor bitset view a row of the
+  // transitive closure of a graph, dropping the old list.
+  void AttachRcrsvInfo(DIRECTION dir, BitVector::Unit *row,
+                       UDT_GNODES nodeCnt);
+  // Builds the node's recursive predecessor or successor list from its
+  // bitset. nodes maps node numbers to the nodes of the graph.
+  void BldRcrsvNghbrLst(DIRECTION dir, GraphNode **nodes);
   // Returns the node's recursive predecessor or successor list, depending on
-  // the specified direction.
+  // the specified direction, or NULL if DirAcycGraph::BldRcrsvNghbrLsts() has
+  // not built it. The list is in topological order: the recursive
+  // predecessors go from the root down towards the node, and the recursive
+  // successors from the leaf back towards it. Callers that do not need the
+  // order should use the bitset.
   LinkedList<GraphNode> *GetRcrsvNghbrLst(DIRECTION dir);
   LinkedList<GraphNode> *GetRecursiveSuccessors();
   LinkedList<GraphNode> *GetRecursivePredecessors();
@@ -267,9 +279,6 @@ private:
 protected:
   // TODO(max): Document what this is.
   bool FindScsr_(GraphNode *&crntScsr, UDT_GNODES trgtNum, UDT_GLABEL trgtLbl);
-  // Actually implements the functionality of FindRcrsvNghbrs().
-  void FindRcrsvNghbrs_(GraphNode *root, DIRECTION dir, DirAcycGraph *graph);
-
   // Returns the node's predecessor or successor list, depending on
   // the specified direction.
   LinkedList<GraphEdge> *GetNghbrLst(DIRECTION dir);
@@ -317,9 +326,17 @@ public:
   // Calculates the topological order of the graph's nodes by performing a
   // depth-first traversal.
   FUNC_RESULT DepthFirstSearch();
-  // Fills the recursive predecessor or successor lists for each node in the
-  // graph, depending on the specified direction.
+  // Computes the recursive predecessors or successors of each node in the
+  // graph, depending on the specified direction. The results are stored in
+  // one bit matrix, one row per node, and each node's bitset views its row.
+  // The recursive neighbor lists are dropped, since building them for every
+  // node takes quadratic time and only a few callers need them.
   FUNC_RESULT FindRcrsvNghbrs(DIRECTION dir);
+  // Builds the recursive neighbor lists in the given direction of the nodes
+  // that do not have one yet, from the rows found by FindRcrsvNghbrs(). This
+  // must be called before the graph is shared with other threads, so that
+  // reading a list never changes the graph.
+  void BldRcrsvNghbrLsts(DIRECTION dir);
 
   inline void CycleDetected() { cycleDetected_ = true; }
 
@@ -354,6 +371,12 @@ protected:
   // Has a cycle been detected in this graph?
   bool cycleDetected_;
 
+  // The transitive closure of the graph in each direction, with the bits of
+  // each node in a row of rcrsvRowUnitCnt_ units, indexed by node number.
+  std::vector<BitVector::Unit> rcrsvScsrRows_;
+  std::vector<BitVector::Unit> rcrsvPrdcsrRows_;
+  int rcrsvRowUnitCnt_;
+
   // Creates a new edge between two nodes with the given numbers with the
   // given label.
   void CreateEdge_(UDT_GNODES frmNodeNum, UDT_GNODES toNodeNum, UDT_GLABEL lbl);
@@ -381,12 +404,14 @@ inline void GraphNode::AddScsr(GraphEdge *edge) {
 }
 
 inline void GraphNode::AddRcrsvPrdcsr(GraphNode *node) {
-  rcrsvPrdcsrLst_->InsrtElmnt(node);
+  if (rcrsvPrdcsrLst_ != NULL)
+    rcrsvPrdcsrLst_->InsrtElmnt(node);
   isRcrsvPrdcsr_->SetBit(node->GetNum());
 }
 
 inline void GraphNode::AddRcrsvScsr(GraphNode *node) {
-  rcrsvScsrLst_->InsrtElmnt(node);
+  if (rcrsvScsrLst_ != NULL)
+    rcrsvScsrLst_->InsrtElmnt(node);
   isRcrsvScsr_->SetBit(node->GetNum());
 }
 
@@ -529,11 +554,11 @@ inline LinkedList<GraphNode> *GraphNode::GetRcrsvNghbrLst(DIRECTION dir) {
 }
 
 inline LinkedList<GraphNode> *GraphNode::GetRecursiveSuccessors() {
-  return rcrsvScsrLst_;
+  return GetRcrsvNghbrLst(DIR_FRWRD);
 }
 
 inline LinkedList<GraphNode> *GraphNode::GetRecursivePredecessors() {
-  return rcrsvPrdcsrLst_;
+  return GetRcrsvNghbrLst(DIR_BKWRD);
 }
 
 inline BitVector *GraphNode::GetRcrsvNghbrBitVector(DIRECTION dir) {
@@ -571,11 +596,11 @@ inline bool GraphNode::IsRcrsvNghbr(DIRECTION dir, GraphNode *node) const {
 }
 
 inline UDT_GEDGES GraphNode::GetRcrsvPrdcsrCnt() const {
-  return rcrsvPrdcsrLst_->GetElmntCnt();
+  return isRcrsvPrdcsr_->GetOneCnt();
 }
 
 inline UDT_GEDGES GraphNode::GetRcrsvScsrCnt() const {
-  return rcrsvScsrLst_->GetElmntCnt();
+  return isRcrsvScsr_->GetOneCnt();
 }
 
 inline LinkedList<GraphEdge> *GraphNode::GetNghbrLst(DIRECTION dir) {
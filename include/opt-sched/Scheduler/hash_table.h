@@ -12,8 +12,13 @@ Last Update:  Mar. 2011
 #include "opt-sched/Scheduler/lnkd_lst.h"
 #include "opt-sched/Scheduler/logger.h"
 #include "opt-sched/Scheduler/mem_mngr.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <cstring>
 #include <limits>
+#include <memory>
+#include <new>
 
 namespace llvm {
 namespace opt_sched {
@@ -24,6 +29,7 @@ typedef unsigned int UDT_HASHTBL_CPCTY;
 
 const int DFLT_HASHTBL_SIZE = 4048;
 const int MAX_HASHBITS = 22;
+const int DFLT_HASHTBL_SHARD_BITS = 4;
 const UDT_HASHTBL_CPCTY DFLT_HASHTBL_CPCTY =
     std::numeric_limits<UDT_HASHTBL_CPCTY>::max();
 
@@ -228,6 +234,119 @@ private:
   void UpdtLastMax_(HashTblEntry<T> *maxEntry, UDT_HASHVAL maxHash);
 };
 
+// The usage counters of one shard of a ShardedBinHashTable.
+struct HashTblShardStats {
+  // The number of entries inserted into the shard since it was constructed.
+  uint64_t insrtCnt = 0;
+  // The number of searches started in the shard.
+  uint64_t srchCnt = 0;
+  // The number of matches returned by the searches.
+  uint64_t hitCnt = 0;
+  // The number of entries skipped by the searches because their key differed
+  // from the search key.
+  uint64_t cllsnCnt = 0;
+  // The number of entries removed by EvictElement().
+  uint64_t evictCnt = 0;
+  // The length of the longest list in the shard.
+  UDT_HASHTBL_CPCTY maxListSize = 0;
+};
+
+// A hash table for binary keys that several threads can insert into and
+// search at the same time without locking. Entries are only ever added to the
+// head of their list, and are only removed by Clear() and EvictElement(),
+// which must not run concurrently with any other operation. Each thread
+// searches with its own cursor, and the lists are walked from the most recent
+// entry to the oldest, like GetLastMatch()/GetPrevMatch() of BinHashTable.
+// The buckets are grouped into shards, each of which keeps its own usage
+// counters so that the table can be sized. The counters are relaxed atomics,
+// so no counts are lost, but a counter read while other threads update it may
+// not include their latest updates.
+template <class T> class ShardedBinHashTable {
+public:
+  // The state of one search.
+  class SrchCrsr {
+    friend class ShardedBinHashTable;
+
+    BinHashTblEntry<T> *srchPtr_ = NULL;
+    UDT_HASHKEY srchKey_ = 0;
+    int shard_ = 0;
+  };
+
+  ShardedBinHashTable(int16_t keyBitCnt, int16_t hashBitCnt,
+                      int16_t shardBitCnt = DFLT_HASHTBL_SHARD_BITS);
+  ~ShardedBinHashTable();
+
+  // Forgets all entries. The entries are not deleted, since they are owned by
+  // the allocators passed to InsertElement().
+  void Clear();
+
+  void InsertElement(UDT_HASHKEY key, T *elmnt,
+                     MemAlloc<BinHashTblEntry<T>> *entryAlctr);
+
+  UDT_HASHVAL HashKey(UDT_HASHKEY key) const;
+  UDT_HASHTBL_CPCTY GetListSize(UDT_HASHKEY key) const;
+  UDT_HASHTBL_CPCTY GetEntryCnt() const;
+
+  T *GetLastMatch(UDT_HASHKEY key, SrchCrsr &crsr);
+  // If the last call to GetLastMatch() or GetPrevMatch() with this cursor has
+  // returned NULL, then GetPrevMatch() should not be called again.
+  T *GetPrevMatch(SrchCrsr &crsr);
+
+  // Removes one entry from the list of the given key's hash value and returns
+  // its element and key, or NULL if the list is empty. The entry is chosen
+  // among all the entries of the list, whatever their keys;
+  // isBetterVictim(a, b) tells whether element a should be removed rather than
+  // element b, and ties go to the oldest entry. The entry is returned to
+  // entryAlctr, which must be the allocator it came from. This must not run
+  // concurrently with any other operation.
+  template <class Cmp>
+  T *EvictElement(UDT_HASHKEY key, Cmp isBetterVictim,
+                  MemAlloc<BinHashTblEntry<T>> *entryAlctr,
+                  UDT_HASHKEY &evctdKey);
+
+  // Finds the first non-empty list at or after the list of the given key's
+  // hash value, wrapping around, and returns the key of its most recent entry.
+  // Returns false if the table is empty. This must not run concurrently with
+  // any other operation.
+  bool FindPpultdList(UDT_HASHKEY key, UDT_HASHKEY &ppultdKey) const;
+
+  int GetShardCnt() const { return 1 << shardBitCnt_; }
+  HashTblShardStats GetShardStats(int shard) const;
+  // Counts the non-empty buckets of a shard. This walks the whole shard.
+  UDT_HASHTBL_CPCTY GetPpultdBktCnt(int shard) const;
+
+private:
+  // The counters of each shard are on their own cache line, so that threads
+  // working in different shards do not contend for them.
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> insrtCnt{0};
+    std::atomic<uint64_t> srchCnt{0};
+    std::atomic<uint64_t> hitCnt{0};
+    std::atomic<uint64_t> cllsnCnt{0};
+    std::atomic<uint64_t> evictCnt{0};
+    std::atomic<UDT_HASHTBL_CPCTY> entryCnt{0};
+    std::atomic<UDT_HASHTBL_CPCTY> maxListSize{0};
+  };
+
+  uint16_t keyBitCnt_;
+  uint16_t hashBitCnt_;
+  uint16_t shardBitCnt_;
+  int16_t hashRShft_;
+
+  // array of the most recent entry of each list
+  std::atomic<BinHashTblEntry<T> *> *lastEntry_;
+  // array of list sizes
+  std::atomic<UDT_HASHTBL_CPCTY> *entryCnts_;
+  // The memory of the shards. Operator new only aligns to the alignment of
+  // the fundamental types, so the shards are placed at the first aligned
+  // address in it.
+  char *shardBuf_;
+  Shard *shards_;
+
+  int GetShard_(UDT_HASHVAL hashVal) const;
+  void FindPrevMatch_(SrchCrsr &crsr);
+};
+
 template <class T> class StrHashTable : public HashTable<T> {
 public:
   StrHashTable(UDT_HASHVAL size = DFLT_HASHTBL_SIZE, bool useIndx = false,
@@ -922,6 +1041,235 @@ FUNC_RESULT StrHashTable<T>::InsertElement(const char *name, T *elmnt) {
   return RES_SUCCESS;
 }
 
+template <class T>
+ShardedBinHashTable<T>::ShardedBinHashTable(int16_t keyBitCnt,
+                                            int16_t hashBitCnt,
+                                            int16_t shardBitCnt) {
+  assert(keyBitCnt <= (int16_t)(8 * sizeof(UDT_HASHKEY)));
+  assert(hashBitCnt <= keyBitCnt);
+  keyBitCnt_ = keyBitCnt;
+  hashBitCnt_ = hashBitCnt;
+  shardBitCnt_ = std::min(shardBitCnt, hashBitCnt);
+  hashRShft_ = keyBitCnt_ - hashBitCnt_;
+
+  UDT_HASHVAL tblSize = (UDT_HASHVAL)1 << hashBitCnt_;
+  lastEntry_ = new std::atomic<BinHashTblEntry<T> *>[tblSize];
+  entryCnts_ = new std::atomic<UDT_HASHTBL_CPCTY>[tblSize];
+
+  size_t shardBytes = GetShardCnt() * sizeof(Shard);
+  size_t bufBytes = shardBytes + alignof(Shard);
+  shardBuf_ = new char[bufBytes];
+  void *shardMem = shardBuf_;
+  shards_ = (Shard *)std::align(alignof(Shard), shardBytes, shardMem, bufBytes);
+  for (int i = 0; i < GetShardCnt(); i++)
+    new (&shards_[i]) Shard();
+
+  for (UDT_HASHVAL i = 0; i < tblSize; i++) {
+    lastEntry_[i].store(NULL, std::memory_order_relaxed);
+    entryCnts_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+template <class T> ShardedBinHashTable<T>::~ShardedBinHashTable() {
+  delete[] lastEntry_;
+  delete[] entryCnts_;
+  for (int i = 0; i < GetShardCnt(); i++)
+    shards_[i].~Shard();
+  delete[] shardBuf_;
+}
+
+template <class T> void ShardedBinHashTable<T>::Clear() {
+  if (GetEntryCnt() == 0)
+    return;
+
+  UDT_HASHVAL tblSize = (UDT_HASHVAL)1 << hashBitCnt_;
+  for (UDT_HASHVAL i = 0; i < tblSize; i++) {
+    lastEntry_[i].store(NULL, std::memory_order_relaxed);
+    entryCnts_[i].store(0, std::memory_order_relaxed);
+  }
+  for (int i = 0; i < GetShardCnt(); i++)
+    shards_[i].entryCnt.store(0, std::memory_order_relaxed);
+}
+
+template <class T>
+inline UDT_HASHVAL ShardedBinHashTable<T>::HashKey(UDT_HASHKEY key) const {
+  return (UDT_HASHVAL)(key >> hashRShft_);
+}
+
+template <class T>
+inline int ShardedBinHashTable<T>::GetShard_(UDT_HASHVAL hashVal) const {
+  return (int)(hashVal >> (hashBitCnt_ - shardBitCnt_));
+}
+
+template <class T>
+void ShardedBinHashTable<T>::InsertElement(
+    UDT_HASHKEY key, T *elmnt, MemAlloc<BinHashTblEntry<T>> *entryAlctr) {
+  assert(entryAlctr != NULL);
+  UDT_HASHVAL hashVal = HashKey(key);
+  Shard &shard = shards_[GetShard_(hashVal)];
+
+  BinHashTblEntry<T> *newEntry = entryAlctr->GetObject();
+  newEntry->Construct(key, elmnt, hashVal);
+
+  // Publish the entry only after it has been fully constructed, so that
+  // concurrent searches never see a partial entry.
+  BinHashTblEntry<T> *prevEntry =
+      lastEntry_[hashVal].load(std::memory_order_relaxed);
+  do {
+    newEntry->SetPrev(prevEntry);
+  } while (!lastEntry_[hashVal].compare_exchange_weak(
+      prevEntry, newEntry, std::memory_order_release,
+      std::memory_order_relaxed));
+
+  UDT_HASHTBL_CPCTY listSize =
+      entryCnts_[hashVal].fetch_add(1, std::memory_order_relaxed) + 1;
+  shard.entryCnt.fetch_add(1, std::memory_order_relaxed);
+  shard.insrtCnt.fetch_add(1, std::memory_order_relaxed);
+
+  UDT_HASHTBL_CPCTY maxListSize =
+      shard.maxListSize.load(std::memory_order_relaxed);
+  while (listSize > maxListSize &&
+         !shard.maxListSize.compare_exchange_weak(maxListSize, listSize,
+                                                  std::memory_order_relaxed)) {
+  }
+}
+
+template <class T>
+UDT_HASHTBL_CPCTY ShardedBinHashTable<T>::GetListSize(UDT_HASHKEY key) const {
+  return entryCnts_[HashKey(key)].load(std::memory_order_relaxed);
+}
+
+template <class T>
+UDT_HASHTBL_CPCTY ShardedBinHashTable<T>::GetEntryCnt() const {
+  UDT_HASHTBL_CPCTY entryCnt = 0;
+  for (int i = 0; i < GetShardCnt(); i++)
+    entryCnt += shards_[i].entryCnt.load(std::memory_order_relaxed);
+  return entryCnt;
+}
+
+template <class T>
+T *ShardedBinHashTable<T>::GetLastMatch(UDT_HASHKEY key, SrchCrsr &crsr) {
+  UDT_HASHVAL srchHash = HashKey(key);
+  crsr.srchKey_ = key;
+  crsr.shard_ = GetShard_(srchHash);
+  crsr.srchPtr_ = lastEntry_[srchHash].load(std::memory_order_acquire);
+  shards_[crsr.shard_].srchCnt.fetch_add(1, std::memory_order_relaxed);
+
+  FindPrevMatch_(crsr);
+  return crsr.srchPtr_ == NULL ? NULL : crsr.srchPtr_->GetElmnt();
+}
+
+template <class T> T *ShardedBinHashTable<T>::GetPrevMatch(SrchCrsr &crsr) {
+  assert(crsr.srchPtr_ != NULL);
+  crsr.srchPtr_ = (BinHashTblEntry<T> *)crsr.srchPtr_->GetPrev();
+
+  FindPrevMatch_(crsr);
+  return crsr.srchPtr_ == NULL ? NULL : crsr.srchPtr_->GetElmnt();
+}
+
+template <class T>
+void ShardedBinHashTable<T>::FindPrevMatch_(SrchCrsr &crsr) {
+  Shard &shard = shards_[crsr.shard_];
+  uint64_t cllsnCnt = 0;
+
+  for (; crsr.srchPtr_ != NULL;
+       crsr.srchPtr_ = (BinHashTblEntry<T> *)crsr.srchPtr_->GetPrev()) {
+    if (crsr.srchPtr_->GetKey() == crsr.srchKey_)
+      break;
+    cllsnCnt++;
+  }
+
+  if (cllsnCnt != 0)
+    shard.cllsnCnt.fetch_add(cllsnCnt, std::memory_order_relaxed);
+  if (crsr.srchPtr_ != NULL)
+    shard.hitCnt.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <class T>
+template <class Cmp>
+T *ShardedBinHashTable<T>::EvictElement(
+    UDT_HASHKEY key, Cmp isBetterVictim,
+    MemAlloc<BinHashTblEntry<T>> *entryAlctr, UDT_HASHKEY &evctdKey) {
+  UDT_HASHVAL hashVal = HashKey(key);
+  BinHashTblEntry<T> *victim =
+      lastEntry_[hashVal].load(std::memory_order_relaxed);
+  if (victim == NULL)
+    return NULL;
+
+  // The entry that was inserted right after the victim, if any.
+  BinHashTblEntry<T> *victimNxt = NULL;
+  BinHashTblEntry<T> *nxtEntry = victim;
+  for (BinHashTblEntry<T> *crntEntry = (BinHashTblEntry<T> *)victim->GetPrev();
+       crntEntry != NULL;
+       crntEntry = (BinHashTblEntry<T> *)crntEntry->GetPrev()) {
+    if (!isBetterVictim(victim->GetElmnt(), crntEntry->GetElmnt())) {
+      victim = crntEntry;
+      victimNxt = nxtEntry;
+    }
+    nxtEntry = crntEntry;
+  }
+
+  BinHashTblEntry<T> *victimPrev = (BinHashTblEntry<T> *)victim->GetPrev();
+  if (victimNxt == NULL)
+    lastEntry_[hashVal].store(victimPrev, std::memory_order_relaxed);
+  else
+    victimNxt->SetPrev(victimPrev);
+
+  Shard &shard = shards_[GetShard_(hashVal)];
+  entryCnts_[hashVal].fetch_sub(1, std::memory_order_relaxed);
+  shard.entryCnt.fetch_sub(1, std::memory_order_relaxed);
+  shard.evictCnt.fetch_add(1, std::memory_order_relaxed);
+
+  T *elmnt = victim->GetElmnt();
+  evctdKey = victim->GetKey();
+  entryAlctr->FreeObject(victim);
+  return elmnt;
+}
+
+template <class T>
+bool ShardedBinHashTable<T>::FindPpultdList(UDT_HASHKEY key,
+                                            UDT_HASHKEY &ppultdKey) const {
+  UDT_HASHVAL bktCnt = (UDT_HASHVAL)1 << hashBitCnt_;
+  UDT_HASHVAL hashVal = HashKey(key);
+  for (UDT_HASHVAL i = 0; i < bktCnt; i++) {
+    UDT_HASHVAL bkt = (hashVal + i) & (bktCnt - 1);
+    BinHashTblEntry<T> *entry = lastEntry_[bkt].load(std::memory_order_relaxed);
+    if (entry != NULL) {
+      ppultdKey = entry->GetKey();
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class T>
+HashTblShardStats ShardedBinHashTable<T>::GetShardStats(int shard) const {
+  assert(shard >= 0 && shard < GetShardCnt());
+  const Shard &crntShard = shards_[shard];
+  HashTblShardStats stats;
+  stats.insrtCnt = crntShard.insrtCnt.load(std::memory_order_relaxed);
+  stats.srchCnt = crntShard.srchCnt.load(std::memory_order_relaxed);
+  stats.hitCnt = crntShard.hitCnt.load(std::memory_order_relaxed);
+  stats.cllsnCnt = crntShard.cllsnCnt.load(std::memory_order_relaxed);
+  stats.evictCnt = crntShard.evictCnt.load(std::memory_order_relaxed);
+  stats.maxListSize = crntShard.maxListSize.load(std::memory_order_relaxed);
+  return stats;
+}
+
+template <class T>
+UDT_HASHTBL_CPCTY ShardedBinHashTable<T>::GetPpultdBktCnt(int shard) const {
+  assert(shard >= 0 && shard < GetShardCnt());
+  UDT_HASHVAL shardSize = (UDT_HASHVAL)1 << (hashBitCnt_ - shardBitCnt_);
+  UDT_HASHVAL frstHash = (UDT_HASHVAL)shard * shardSize;
+  UDT_HASHTBL_CPCTY ppultdBktCnt = 0;
+
+  for (UDT_HASHVAL i = frstHash; i < frstHash + shardSize; i++) {
+    if (entryCnts_[i].load(std::memory_order_relaxed) != 0)
+      ppultdBktCnt++;
+  }
+  return ppultdBktCnt;
+}
+
 } // namespace opt_sched
 } // namespace llvm
 
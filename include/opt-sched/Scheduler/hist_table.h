@@ -25,6 +25,11 @@ namespace opt_sched {
 class EnumTreeNode;
 class Enumerator;
 
+// Only one in this many history nodes on a path keeps its own copy of the
+// window and of the set of scheduled instructions. The nodes in between keep
+// just their instruction and are completed from the nearest such node above.
+const int HIST_CHKPNT_INTRVL = 8;
+
 // The history version of a tree node to be kept in the history table
 class HistEnumTreeNode {
 public:
@@ -38,12 +43,15 @@ public:
   bool IsPrdcsrViaStalls(HistEnumTreeNode *othrNode);
   HistEnumTreeNode *GetParent();
   void Clean();
+  // Returns the arrays of a node that is no longer needed to the allocators
+  // of the enumerator that constructed it.
+  void FreeArrays(Enumerator *enumrtr);
   void ReplaceParent(HistEnumTreeNode *newParent);
   // Does the scheduled inst. list of this node match that of the given node
   bool DoesMatch(EnumTreeNode *node, Enumerator *enumrtr);
-  // Is the sub-problem at this node dominated by the given node's?
-  bool IsDominated(EnumTreeNode *node, Enumerator *enumrtr);
-  // Does the sub-problem at this node dominate the given node's?
+  // Does the sub-problem at this node dominate the given node's? The given
+  // node must be the one being probed, whose lower bounds the instructions
+  // currently hold.
   virtual bool DoesDominate(EnumTreeNode *node, Enumerator *enumrtr);
   virtual void Construct(EnumTreeNode *node, bool isTemp);
   virtual void SetCostInfo(EnumTreeNode *node, bool isTemp,
@@ -52,6 +60,22 @@ public:
   void
   SetSuffix(const std::shared_ptr<std::vector<SchedInstruction *>> &suffix);
   std::vector<InstCount> GetPrefix() const;
+  // The approximate memory taken by this node, including what it allocates.
+  virtual size_t GetMemSize(Enumerator *enumrtr);
+
+  // Bookkeeping for evicting nodes from a memory-bounded history table.
+  // A node that was evicted from the table may only be freed once none of
+  // the nodes kept for its children refer to it anymore.
+  void AddRtndChld() { rtndChldCnt_++; }
+  void RemoveRtndChld() {
+    assert(rtndChldCnt_ > 0);
+    rtndChldCnt_--;
+  }
+  bool HasRtndChldrn() const { return rtndChldCnt_ != 0; }
+  void SetEvctd() { isEvctd_ = true; }
+  bool IsEvctd() const { return isEvctd_; }
+  uint64_t GetLastMatchTime() const { return lastMatchTime_; }
+  void SetLastMatchTime(uint64_t time) { lastMatchTime_ = time; }
 
 protected:
   HistEnumTreeNode *prevNode_;
@@ -60,30 +84,62 @@ protected:
   // This is equal to the length of the path from the root node to this node.
   InstCount time_;
 
-  SchedInstruction *inst_;
+  // The number of the instruction scheduled at this node, or SCHD_STALL.
+  // Instructions are kept by number rather than by pointer so that a node
+  // archived by one thread can be examined against the graph of another.
+  InstCount instNum_;
 
 #ifdef IS_DEBUG
   bool isCnstrctd_;
 #endif
 
   bool crntCycleBlkd_;
-  ReserveSlot *rsrvSlots_;
+  // Whether any unpipelined instructions were in flight at this node.
+  bool hasRsrvSlots_;
+
+  // The number of instructions scheduled up to this node.
+  InstCount schduldCnt_;
+  // The instruction numbers scheduled in the last issue slots, starting
+  // with this node's. This and the set of instructions scheduled up to this
+  // node, one bit per instruction, are only kept by checkpoint nodes and are
+  // NULL in the others.
+  InstCount *lastInstNums_;
+  uint64_t *instsSchduld_;
+  // The end cycle of the reservation of each issue slot (INVALID_VALUE if the
+  // slot is not reserved), or NULL if no slot is reserved.
+  InstCount *rsrvEndCycles_;
 
   // (Chris)
   std::shared_ptr<std::vector<SchedInstruction *>> suffix_ = nullptr;
 
-  InstCount SetLastInsts_(SchedInstruction *lastInsts[], InstCount thisTime,
-                          InstCount minTimeToExmn);
-  void SetInstsSchduld_(BitVector *instsSchduld);
-  // Does this history node dominate the given node or history node?
-  bool DoesDominate_(EnumTreeNode *node, HistEnumTreeNode *othrHstry,
-                     ENUMTREE_NODEMODE mode, Enumerator *enumrtr,
-                     InstCount shft);
-  void SetLwrBounds_(InstCount lwrBounds[], SchedInstruction *lastInsts[],
-                     InstCount thisTime, InstCount minTimeToExmn,
-                     Enumerator *enumrtr);
-  void CmputNxtAvlblCycles_(Enumerator *enumrtr, InstCount instsPerType[],
+  // The number of this node's children that are kept in the history table
+  // or are still needed by their own children.
+  InstCount rtndChldCnt_;
+  // Whether this node has been evicted from the history table.
+  bool isEvctd_;
+  // When this node was last matched by a history domination test, in
+  // examined nodes.
+  uint64_t lastMatchTime_;
+
+  InstCount SetLastInsts_(SchedInstruction *lastInsts[],
+                          const InstCount *instNums, InstCount thisTime,
+                          InstCount minTimeToExmn, Enumerator *enumrtr);
+  // Fills in the arrays of this node from the given node and its parent.
+  void SetArrays_(EnumTreeNode *node, bool isTemp);
+  // Copies the first cnt entries of this node's window, walking up to the
+  // nearest checkpoint node if this node is not one.
+  void CopyLastInstNums_(InstCount *instNums, InstCount cnt);
+  // Copies the set of instructions scheduled up to this node.
+  void CopyInstsSchduld_(uint64_t *instsSchduld, InstCount wordCnt);
+  // Returns this node's window, which is rebuilt in a buffer of the
+  // enumerator if this node is not a checkpoint node.
+  const InstCount *GetLastInstNums_(Enumerator *enumrtr);
+  // Does this history node dominate the given node?
+  bool DoesDominate_(EnumTreeNode *node, Enumerator *enumrtr, InstCount shft);
+  void CmputNxtAvlblCycles_(Enumerator *enumrtr, const InstCount *instNums,
+                            InstCount instsPerType[],
                             InstCount nxtAvlblCycles[]);
+  size_t GetAlctdMemSize_(Enumerator *enumrtr);
 
   virtual void Init_();
   void AllocLastInsts_(ArrayMemAlloc<SchedInstruction *> *lastInstsAlctr,
@@ -91,7 +147,6 @@ protected:
   bool IsAbslutDmnnt_();
   InstCount GetMinTimeToExmn_(InstCount nodeTime, Enumerator *enumrtr);
   InstCount GetLwrBound_(SchedInstruction *inst, int16_t issuRate);
-  void SetRsrvSlots_(EnumTreeNode *node);
 };
 
 class CostHistEnumTreeNode : public HistEnumTreeNode {
@@ -103,6 +158,7 @@ public:
   // Does the sub-problem at this node dominate the given node's?
   bool DoesDominate(EnumTreeNode *node, Enumerator *enumrtr);
   void SetCostInfo(EnumTreeNode *node, bool isTemp, Enumerator *enumrtr);
+  size_t GetMemSize(Enumerator *enumrtr) override;
 
 protected:
   // Why do we need to copy this data from region->tree_node->hist_node
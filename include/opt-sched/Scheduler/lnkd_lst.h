@@ -276,6 +276,24 @@ public:
   Entry<T> *GetTopEntry() const { return topEntry_; }
   Entry<T> *GetBottomEntry() const { return bottomEntry_; }
 
+  // The position of the iterator. It can be saved and restored later, as long
+  // as the entry it refers to is in the list again by then.
+  struct ItrtrState {
+    Entry<T> *rtrvEntry;
+    bool itrtrReset;
+    bool wasTopRmvd;
+    bool wasBottomRmvd;
+  };
+  ItrtrState GetItrtrState() const {
+    return {rtrvEntry_, itrtrReset_, wasTopRmvd_, wasBottomRmvd_};
+  }
+  void SetItrtrState(const ItrtrState &state) {
+    rtrvEntry_ = state.rtrvEntry;
+    itrtrReset_ = state.itrtrReset;
+    wasTopRmvd_ = state.wasTopRmvd;
+    wasBottomRmvd_ = state.wasBottomRmvd;
+  }
+
 protected:
   explicit LinkedList(std::unique_ptr<EntryAllocator<T>> Allocator);
 
@@ -363,6 +381,22 @@ public:
   CopyList(PriorityList<T, K> const *const otherLst,
            llvm::MutableArrayRef<KeyedEntry<T, unsigned long> *> keyedEntries_);
 
+  // Removes the "current" element like RmvCrntElmnt(), but keeps its entry
+  // and returns it, along with the entry that followed it, so that it can be
+  // put back in place with RestoreEntry().
+  KeyedEntry<T, K> *DetachCrntEntry(KeyedEntry<T, K> *&next);
+  // Puts an entry back in the list before next, or at the bottom if next is
+  // NULL, with the given key. Unlike BoostEntry(), no search is done, so the
+  // caller must pass the place where the entry was.
+  void RestoreEntry(KeyedEntry<T, K> *entry, K key, KeyedEntry<T, K> *next);
+  // Takes an entry out of the list. If free = false, the entry is kept so
+  // that it can be put back with RestoreEntry().
+  void RmvEntry(KeyedEntry<T, K> *entry, bool free = true) {
+    LinkedList<T>::RmvEntry_(entry, free);
+  }
+  // Frees an entry that was detached from the list.
+  void FreeEntry(KeyedEntry<T, K> *entry) { LinkedList<T>::FreeEntry_(entry); }
+
 protected:
   // Creates and returns a keyed entry. For dynamically-sized lists, new
   // memory is allocated. For fixed-size lists, existing memory is used.
@@ -757,6 +791,8 @@ void PriorityList<T, K>::BoostEntry(KeyedEntry<T, K> *entry, K newKey) {
     if (entry == LinkedList<T>::bottomEntry_ || next->key <= newKey)
       return;
 
+    // If no entry below has a key that is not larger, it goes to the bottom.
+    next = NULL;
     for (crnt = entry->GetNext(); crnt != NULL; crnt = crnt->GetNext()) {
       if (crnt->key <= newKey) {
         next = crnt;
@@ -798,6 +834,25 @@ void PriorityList<T, K>::CopyList(
   LinkedList<T>::itrtrReset_ = otherLst->itrtrReset_;
 }
 
+template <class T, class K>
+KeyedEntry<T, K> *PriorityList<T, K>::DetachCrntEntry(KeyedEntry<T, K> *&next) {
+  KeyedEntry<T, K> *entry = (KeyedEntry<T, K> *)LinkedList<T>::rtrvEntry_;
+  assert(entry != NULL);
+  LinkedList<T>::wasTopRmvd_ = entry == LinkedList<T>::topEntry_;
+  LinkedList<T>::wasBottomRmvd_ = entry == LinkedList<T>::bottomEntry_;
+  next = entry->GetNext();
+  LinkedList<T>::rtrvEntry_ = entry->GetPrev();
+  LinkedList<T>::RmvEntry_(entry, false);
+  return entry;
+}
+
+template <class T, class K>
+void PriorityList<T, K>::RestoreEntry(KeyedEntry<T, K> *entry, K key,
+                                      KeyedEntry<T, K> *next) {
+  entry->key = key;
+  InsrtEntry_(entry, next);
+}
+
 template <class T, class K>
 KeyedEntry<T, K> *PriorityList<T, K>::AllocEntry_(T *element, K key) {
   return LinkedList<T>::template AllocEntry_<KeyedEntry<T, K>>(
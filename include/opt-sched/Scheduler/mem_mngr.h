@@ -68,7 +68,7 @@ public:
   // Returns an allocated array of objects.
   inline T *GetArray() { return MemAlloc<T>::GetObjects_(arraySize_); }
   // Frees an array of objects and recycle it for future use.
-  inline void FreeArray(T *array) { FreeObject(array); }
+  inline void FreeArray(T *array) { MemAlloc<T>::FreeObject(array); }
 
 protected:
   // The size of each array.
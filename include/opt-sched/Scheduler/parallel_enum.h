@@ -0,0 +1,87 @@
+#ifndef OPTSCHED_ENUM_PARALLEL_ENUM_H
+#define OPTSCHED_ENUM_PARALLEL_ENUM_H
+
+#include "opt-sched/Scheduler/defines.h"
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace llvm {
+namespace opt_sched {
+
+class HistEnumTreeNode;
+template <class T> class ShardedBinHashTable;
+
+// The best cost found so far by any of the threads scheduling a region.
+// Regions consult it when pruning by cost so that an improvement found by one
+// thread immediately tightens the search of the others. An incumbent can be
+// nested in an Outer one, such as that of an ACO run alongside the enumerator,
+// whose improvements it then sees as well.
+class SharedIncumbent {
+public:
+  explicit SharedIncumbent(InstCount InitCost,
+                           const SharedIncumbent *Outer = nullptr)
+      : BestCost(InitCost), Outer(Outer) {}
+
+  InstCount get() const {
+    InstCount Cost = BestCost.load(std::memory_order_relaxed);
+    return Outer == nullptr ? Cost : std::min(Cost, Outer->get());
+  }
+
+  // Lowers the shared cost to Cost if that is an improvement. Returns true if
+  // the shared cost was lowered.
+  bool offer(InstCount Cost);
+
+private:
+  std::atomic<InstCount> BestCost;
+  const SharedIncumbent *Outer;
+};
+
+// Hands out the subproblems at the split depth of the enumeration tree. One
+// thread first expands the tree down to the split depth and adds the partial
+// schedules it reaches there, in the order in which it reaches them. Then all
+// the threads take the subproblems one at a time. Since threads that finish a
+// subtree early go on to take the next one, the load balances itself.
+class SubProblemPool {
+public:
+  // A partial schedule, as the instruction numbers (or SCHD_STALL) scheduled
+  // in each slot from the root.
+  using Prefix = std::vector<InstCount>;
+
+  // Adds a subproblem. This may not be called once the subproblems are being
+  // taken.
+  void add(const Prefix &P) { SubProbs.push_back(P); }
+
+  // Takes the next subproblem that no thread has taken yet. Returns false if
+  // there is none left.
+  bool take(Prefix &P);
+
+  int getSubProbCnt() const { return static_cast<int>(SubProbs.size()); }
+
+private:
+  std::vector<Prefix> SubProbs;
+  std::atomic<size_t> NxtSubProb{0};
+};
+
+// The state shared by all the threads enumerating one target length.
+struct ParallelEnumContext {
+  ParallelEnumContext(InstCount InitCost, InstCount SplitDepth,
+                      const SharedIncumbent *OuterIncumbent = nullptr)
+      : Incumbent(InitCost, OuterIncumbent), SplitDepth(SplitDepth) {}
+
+  SharedIncumbent Incumbent;
+  SubProblemPool SubProblems;
+  // The depth (in issue slots) at which subtrees are distributed.
+  const InstCount SplitDepth;
+  // The history table shared by all the threads, if history domination is
+  // enabled, so that a subproblem examined by one thread can prune the search
+  // of the others.
+  ShardedBinHashTable<HistEnumTreeNode> *History = nullptr;
+  // The memory taken by the entries of History, if its size is limited.
+  std::atomic<uint64_t> HistBytes{0};
+};
+
+} // namespace opt_sched
+} // namespace llvm
+
+#endif
@@ -0,0 +1,73 @@
+/*******************************************************************************
+Description:  Keeps the final pheromone tables of ACO runs, so that a later run
+              on the same DAG, such as the second pass of the two-pass
+              scheduler or a recompile of an unchanged function, can start
+              from them instead of from a uniform table.
+*******************************************************************************/
+
+#ifndef OPTSCHED_PHEROMONE_CACHE_H
+#define OPTSCHED_PHEROMONE_CACHE_H
+
+#include "opt-sched/Scheduler/aco_select.h"
+#include "llvm/ADT/ArrayRef.h"
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace llvm {
+namespace opt_sched {
+
+class DataDepGraph;
+
+class PheromoneCache {
+public:
+  // Keeps the tables in memory, and in Dir if it is not empty, which makes
+  // them outlive the process.
+  explicit PheromoneCache(std::string Dir = "");
+
+  // The cache shared by all the ACO runs of the process, which keeps its files
+  // in ACO_PHEROMONE_CACHE_DIR.
+  static PheromoneCache &getInstance();
+
+  // A hash of the instructions of DDG and the dependences between them. A
+  // table can only be reused by a DAG whose instructions are numbered the same
+  // way. Latencies and artificial edges are left out, since they differ
+  // between the passes of the two-pass scheduler.
+  static uint64_t hashDag(DataDepGraph *DDG);
+
+  // Copies the table stored for the DAG into Tbl. Returns false, leaving Tbl
+  // unchanged, if no table of the same size is stored.
+  bool load(const std::string &DagID, uint64_t DagHash,
+            MutableArrayRef<pheromone_cell_t> Tbl);
+  // Stores Tbl as the table of the DAG, replacing any earlier one.
+  void store(const std::string &DagID, uint64_t DagHash,
+             ArrayRef<pheromone_cell_t> Tbl);
+
+  // The tables kept in memory are dropped, oldest first, once they hold more
+  // than this many cells.
+  static const size_t MaxCellCnt = 1 << 24;
+
+private:
+  using Key = std::pair<std::string, uint64_t>;
+
+  std::string getPath_(const Key &K) const;
+  bool readFile_(const Key &K, std::vector<pheromone_cell_t> &Tbl) const;
+  void writeFile_(const Key &K, ArrayRef<pheromone_cell_t> Tbl) const;
+  void insert_(const Key &K, std::vector<pheromone_cell_t> Tbl);
+
+  std::mutex Lock;
+  std::string Dir;
+  std::map<Key, std::vector<pheromone_cell_t>> Tbls;
+  // The keys of Tbls, in the order they were inserted.
+  std::deque<Key> Order;
+  size_t CellCnt = 0;
+};
+
+} // namespace opt_sched
+} // namespace llvm
+
+#endif
@@ -17,6 +17,8 @@ namespace opt_sched {
 namespace RandomGen {
 // Initialize the random number generator with a seed.
 void SetSeed(int32_t iseed);
+// Get the seed last passed to SetSeed().
+int32_t GetSeed();
 // Get a random 32-bit value.
 uint32_t GetRand32();
 // Get a random 32-bit value within a given range, inclusive.
@@ -28,6 +30,29 @@ uint64_t GetRand64();
 void GetRandBits(uint16_t bitCnt, unsigned char *dest);
 } // namespace RandomGen
 
+// A xoshiro256** generator with its own state. Unlike RandomGen, which is a
+// single global generator, each user owns a stream, seeded from the global
+// seed and from what it is generating numbers for, so that its numbers do not
+// depend on what else drew random numbers before it or on other threads.
+class RandomStream {
+public:
+  explicit RandomStream(uint64_t seed = 0) { Seed(seed); }
+
+  void Seed(uint64_t seed);
+  // Get a random 64-bit value.
+  uint64_t GetRand64();
+  // Get a random double in [0, 1).
+  double GetRandDouble() { return (GetRand64() >> 11) * (1.0 / (1ULL << 53)); }
+
+  // Derive a new seed from seed and a value or a string, e.g. the ID of the
+  // region that the stream is for.
+  static uint64_t MixSeed(uint64_t seed, uint64_t value);
+  static uint64_t MixSeedWithStr(uint64_t seed, const char *str);
+
+private:
+  uint64_t state_[4];
+};
+
 } // namespace opt_sched
 } // namespace llvm
 
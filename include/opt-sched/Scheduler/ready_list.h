@@ -21,12 +21,24 @@ Last Update:  Sept. 2013
 namespace llvm {
 namespace opt_sched {
 
+// The data structures that a ready list can keep its instructions in.
+enum READY_LIST_ENGINE {
+  // A linked list sorted by priority.
+  RLE_LINKED,
+  // An array sorted by priority. Adding and removing instructions moves the
+  // ones below them, but there is no allocation per instruction and the list
+  // is traversed sequentially, which is faster for lists of the sizes seen
+  // in practice.
+  RLE_FLAT
+};
+
 // A priority list of instruction that are ready to schedule at a given point
 // during the scheduling process.
 class ReadyList {
 public:
   // Constructs a ready list for the specified dependence graph with the
-  // specified priorities.
+  // specified priorities. The data structure used is chosen by the
+  // READY_LIST_ENGINE setting.
   ReadyList(DataDepGraph *dataDepGraph, SchedPriorities prirts);
   // Destroys the ready list and deallocates the memory used by it.
   ~ReadyList();
@@ -70,6 +82,17 @@ public:
   // Copies this list to another. Both lists must be empty.
   void CopyList(ReadyList *otherLst);
 
+  // Saves the state of the list, including the position of its iterator,
+  // so that it can be brought back with RestoreState(). Until then, the
+  // changes made to the list are recorded rather than copying the list, so
+  // restoring takes time proportional to the number of changes. States are
+  // restored in the reverse order in which they were saved. While a state is
+  // saved, the instructions added by AddLatestSubLists() are taken out of the
+  // list by RestoreState() rather than by RemoveLatestSubList().
+  void SaveState();
+  // Undoes all the changes made since the last saved state and discards it.
+  void RestoreState();
+
   // Searches the list for an instruction, returning whether it has been found
   // or not and writing the number of times it was found into hitCnt.
   bool FindInst(SchedInstruction *inst, int &hitCnt);
@@ -90,9 +113,41 @@ private:
   // An ordered vector of priorities
   SchedPriorities prirts_;
 
-  // The priority list containing the actual instructions.
+  // The hot fields of the graph's instructions, from which the critical path
+  // and last-use count parts of the keys are read.
+  SchedInstStore *instStore_;
+
+  // An instruction in the flat list.
+  struct FlatEntry {
+    SchedInstruction *inst;
+    unsigned long key;
+    // The order of the entry among those with equal keys, which is the same
+    // as in the linked list: an instruction that is added or raised to a key
+    // goes after the ones that have it already, and one that is lowered to a
+    // key goes before them.
+    long seq;
+  };
+
+  READY_LIST_ENGINE engn_;
+
+  // The priority list containing the actual instructions, when the linked
+  // engine is used.
   PriorityList<SchedInstruction> prirtyLst_;
 
+  // The instructions in decreasing order of key and then increasing order of
+  // seq, when the flat engine is used.
+  llvm::SmallVector<FlatEntry, 0> flatLst_;
+  // The position of the instruction last returned by the iterator.
+  int flatIndx_;
+  // Whether the iterator starts over at the top of the flat list.
+  bool flatItrtrReset_;
+  // The seq of the next instruction added to the flat list or raised to a
+  // higher key, which is above those of all the instructions in the list.
+  long flatSeq_;
+  // The seq of the next instruction lowered to a smaller key, which is below
+  // those of all the instructions in the list.
+  long flatLowSeq_;
+
   // TODO(max): Document.
   LinkedList<SchedInstruction> latestSubLst_;
 
@@ -100,6 +155,49 @@ private:
   llvm::SmallVector<KeyedEntry<SchedInstruction, unsigned long> *, 0>
       keyedEntries_;
 
+  // The kinds of changes recorded while a state is saved.
+  enum CHANGE_KIND {
+    // An instruction was added by AddInst().
+    CK_INSRT,
+    // An instruction was added by AddLatestSubLists().
+    CK_INSRT_LATEST,
+    // An instruction was removed by RemoveNextPriorityInst().
+    CK_RMV,
+    // The key of an instruction was changed by UpdatePriorities().
+    CK_KEY
+  };
+
+  // A change made to the list while a state is saved.
+  struct Change {
+    CHANGE_KIND kind;
+    SchedInstruction *inst;
+    // The key of the changed instruction before the change.
+    unsigned long key;
+    // The key of the changed instruction after a key change.
+    unsigned long newKey;
+    // The seq of the changed entry of the flat list, and its seq after a key
+    // change.
+    long seq;
+    long newSeq;
+    // The changed entry of the linked list, and the entry that followed it
+    // before the change.
+    KeyedEntry<SchedInstruction, unsigned long> *entry;
+    KeyedEntry<SchedInstruction, unsigned long> *next;
+  };
+
+  // A saved state of the list.
+  struct SavedState {
+    // The number of changes recorded when the state was saved.
+    size_t chngCnt;
+    LinkedList<SchedInstruction>::ItrtrState itrtr;
+    int flatIndx;
+    bool flatItrtrReset;
+  };
+
+  // The changes made since the oldest saved state, oldest first.
+  llvm::SmallVector<Change, 0> chngs_;
+  llvm::SmallVector<SavedState, 0> svdStates_;
+
   // Is there a priority scheme that needs to be changed dynamically
   //    bool isDynmcPrirty_;
 
@@ -125,6 +223,25 @@ private:
   // to the ready list already.
   void AddLatestSubList_(LinkedList<SchedInstruction> *lst);
 
+  // Adds an instruction to the list, recording the addition as a change of
+  // the given kind if a state is saved.
+  void AddInst_(SchedInstruction *inst, CHANGE_KIND kind);
+
+  // Records a change if a state is saved.
+  void RecordChange_(const Change &chng);
+
+  // Undoes a change to the linked or the flat list.
+  void UndoLinkedChange_(const Change &chng);
+  void UndoFlatChange_(const Change &chng);
+
+  // Returns the position in the flat list of the entry with the given key
+  // and seq, or where it would be inserted.
+  int GetFlatPos_(unsigned long key, long seq) const;
+  // Inserts an entry in the flat list at its position.
+  void InsrtFlatEntry_(const FlatEntry &entry);
+  // Removes the entry with the given key and seq from the flat list.
+  void RmvFlatEntry_(unsigned long key, long seq);
+
   // Calculates a new priority key given an existing key of size keySize by
   // appending bitCnt bits holding the value val, assuming val < maxVal.
   static void AddPrirtyToKey_(unsigned long &key, int16_t &keySize,
@@ -11,6 +11,7 @@ Last Update:  Mar. 2011
 #include "opt-sched/Scheduler/data_dep.h"
 #include "opt-sched/Scheduler/gen_sched.h"
 #include "opt-sched/Scheduler/hash_table.h"
+#include <vector>
 
 namespace llvm {
 namespace opt_sched {
@@ -112,11 +113,42 @@ class RJ_RelaxedScheduler : public RelaxedScheduler {
 private:
   InstCount chkdInstCnt_;
 
+  // Whether feasibility checks repair the relaxed schedule found by the last
+  // check instead of building a new one.
+  bool useIncrmntl_;
+  // Whether the last check found a relaxed schedule, which the fields below
+  // describe, and the current and last cycles it was found for.
+  bool hasRlxdSched_;
+  InstCount rlxdCrntCycle_;
+  InstCount rlxdLastCycle_;
+  // The cycle of each unfixed instruction in the relaxed schedule, or
+  // INVALID_VALUE if it has to be placed again.
+  std::vector<InstCount> rlxdCycles_;
+  // The number of unfixed instructions placed in each cell, i.e. each cycle of
+  // each issue type, and a list of them linked by instruction index.
+  std::vector<int16_t> cellUsage_;
+  std::vector<InstCount> cellHeads_;
+  std::vector<InstCount> nxtInCell_;
+  std::vector<InstCount> prevInCell_;
+  // The instructions that have to be placed again, because they were unfixed
+  // or their release times passed their cycles since the last check, and the
+  // cells that fixed instructions took slots from.
+  std::vector<SchedInstruction *> unplcdInsts_;
+  std::vector<InstCount> fxdCells_;
+
   void Initialize_(bool setPrirtyLst);
   void InitChkng_(InstCount crntCycle);
   void EndChkng_(InstCount crntCycle);
   bool FixInsts_(LinkedList<SchedInstruction> *fxdLst);
 
+  inline InstCount GetCell_(IssueType issuType, InstCount cycle);
+  void ResetRlxdSched_();
+  void PlaceInst_(SchedInstruction *inst, InstCount cycle);
+  void UnplaceInst_(SchedInstruction *inst);
+  // Repairs the relaxed schedule of the last check. Returns false if some
+  // instruction could not be placed, leaving the schedule invalid.
+  bool RepairRlxdSched_(InstCount crntCycle, InstCount lastCycle);
+
 public:
   RJ_RelaxedScheduler(DataDepStruct *dataDepGraph, MachineModel *machMdl,
                       InstCount uprBound, DIRECTION schedDir,
@@ -133,6 +165,22 @@ public:
   // the given last cycle. Return true if this is feasible and false if not
   bool SchdulAndChkFsblty(InstCount crntCycle, InstCount lastCycle);
 
+  // Makes the feasibility checks keep the relaxed schedule they find, so that
+  // ChkFsbltyIncrmntly() can repair it rather than start over.
+  void SetIncrmntl(bool useIncrmntl);
+
+  // Like SchdulAndChkFsblty(), but first tries to repair the relaxed schedule
+  // of the last check. Only the instructions that lost their slots to fixed
+  // instructions, sit before the current cycle or before their release times,
+  // or were unfixed since are placed again, earliest deadline first. Does a
+  // full check if there is no schedule to repair or the repair fails.
+  bool ChkFsbltyIncrmntly(InstCount crntCycle, InstCount lastCycle);
+
+  // Tells the scheduler that the release time of an inst was raised. If the
+  // inst now sits before its release time in the relaxed schedule, it is
+  // placed again by the next repair.
+  void TightnReleaseTime(SchedInstruction *inst);
+
   bool CmputDynmcLwrBound(InstCount trgtLastCycle, InstCount trgtLwrBound,
                           InstCount &schedLwrBound);
 
@@ -154,6 +202,12 @@ private:
   // relative to the sub-graph's leaf.
   PriorityList<SchedInstruction> *subGraphInstLst_;
 
+  // The number of threads that find the bounds of a full graph.
+  int thrdCnt_;
+
+  // The scratch state of one thread finding the bounds of a full graph.
+  struct SubGraphWrkr;
+
   void Initialize_();
   void InitSubGraph_();
 
@@ -161,8 +215,24 @@ private:
   // in the specified direction.
   InstCount SchdulSubGraph_(SchedInstruction *inst, DIRECTION dir);
 
+  // Finds the bounds of the instructions of a full graph. Each subgraph is
+  // read from the transitive closure and sorted by counting, and the
+  // instructions at the same depth, whose subgraphs do not depend on each
+  // other's bounds, are divided among the threads.
+  InstCount FindFullGraphSchedule_();
+  // Like SchdulSubGraph_(), but for a full graph, using the scratch state of
+  // the calling thread.
+  InstCount SchdulFullSubGraph_(SchedInstruction *leaf, SubGraphWrkr &wrkr);
+
   InstCount CmputReleaseTime_(SchedInstruction *inst);
 
+protected:
+  // Finds the bounds of the instructions one subgraph at a time with
+  // SchdulSubGraph_(), walking the recursive neighbor lists, which must have
+  // been built. Used for subgraphs, and gives the same bounds as
+  // FindFullGraphSchedule_() for a full graph.
+  InstCount FindListSchedule_();
+
 public:
   LC_RelaxedScheduler(DataDepStruct *dataDepGraph, MachineModel *machMdl,
                       InstCount uprBound, DIRECTION schedDir);
@@ -323,6 +393,12 @@ void RJ_RelaxedScheduler::Initialize(bool setPrirtyLst) {
 }
 /*****************************************************************************/
 
+InstCount RJ_RelaxedScheduler::GetCell_(IssueType issuType, InstCount cycle) {
+  assert(0 <= cycle && cycle < schedUprBound_);
+  return issuType * schedUprBound_ + cycle;
+}
+/*****************************************************************************/
+
 } // namespace opt_sched
 } // namespace llvm
 
@@ -13,7 +13,9 @@ Last Update:  Sept. 2013
 #include "opt-sched/Scheduler/hash_table.h"
 #include "opt-sched/Scheduler/machine_model.h"
 #include "llvm/ADT/ArrayRef.h"
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace llvm {
 namespace opt_sched {
@@ -110,6 +112,38 @@ class Register;
 // There is a circular dependence between SchedInstruction and SchedRange.
 class SchedRange;
 
+// The fields of a graph's instructions that the scheduler reads for many
+// instructions at a time. Each field is kept in its own array indexed by
+// instruction number, so that a scan over the instructions loads only the
+// field it needs rather than whole SchedInstruction objects. The accessors
+// of SchedInstruction and SchedRange read and write these arrays, and hot
+// loops may index them directly.
+class SchedInstStore {
+public:
+  explicit SchedInstStore(InstCount instCnt = 0);
+
+  // Resizes the store to hold instCnt instructions and resets all the fields.
+  void Resize(InstCount instCnt);
+  InstCount GetInstCnt() const { return (InstCount)schedCycles.size(); }
+
+  // The static lower bounds, computed before scheduling starts.
+  std::vector<InstCount> frwrdLwrBounds;
+  std::vector<InstCount> bkwrdLwrBounds;
+  // The dynamic lower bounds of the instruction's current range.
+  std::vector<InstCount> crntFrwrdLwrBounds;
+  std::vector<InstCount> crntBkwrdLwrBounds;
+  // The deadline of the current range, i.e. the last cycle of the target
+  // length minus the current backward lower bound.
+  std::vector<InstCount> crntDeadlines;
+  // The cycle in which the instruction is scheduled, or SCHD_UNSCHDULD.
+  std::vector<InstCount> schedCycles;
+  std::vector<IssueType> issuTypes;
+  std::vector<InstCount> crtclPathsFrmRoot;
+  std::vector<InstCount> crtclPathsFrmLeaf;
+  // The number of live registers for which the instruction is the last use.
+  std::vector<int16_t> lastUseCnts;
+};
+
 // An object of this class contains all the information that a scheduler
 // needs to keep track of for an instruction. This class is derived from
 // GraphNode, since, from the scheduler's point of view, an instruction is a
@@ -138,10 +172,14 @@ public:
   //   fileUB: The static upper bound on this instruction's scheduling as
   //     provided in the input file.
   //   model: The machine model used by this instruction.
+  //   store: The store holding the hot fields of the graph's instructions,
+  //     in which this instruction takes the entry of its number. If NULL,
+  //     the instruction keeps its fields in a store of its own.
   SchedInstruction(InstCount num, const string &name, InstType instType,
                    const string &opCode, InstCount maxInstCnt, int nodeID,
                    InstCount fileSchedCycle, InstCount fileSchedOrder,
-                   InstCount fileLB, InstCount fileUB, MachineModel *model);
+                   InstCount fileLB, InstCount fileUB, MachineModel *model,
+                   SchedInstStore *store = NULL);
   // Deallocates the memory used by the instruction and destroys the object.
   ~SchedInstruction();
 
@@ -177,7 +215,10 @@ public:
   // file.
   InstCount GetFileSchedCycle() const;
   // Returns the instruction's forward or backward lower bound.
-  InstCount GetLwrBound(DIRECTION dir) const;
+  InstCount GetLwrBound(DIRECTION dir) const {
+    return dir == DIR_FRWRD ? store_->frwrdLwrBounds[storeIndx_]
+                            : store_->bkwrdLwrBounds[storeIndx_];
+  }
 
   /***************************************************************************
    * Iterators                                                               *
@@ -265,7 +306,10 @@ public:
   // Returns the critical path distance of this instruction from the root of
   // leaf, depending on dir. Assumes that the path has already been
   // calculated.
-  InstCount GetCrtclPath(DIRECTION dir) const;
+  InstCount GetCrtclPath(DIRECTION dir) const {
+    return dir == DIR_FRWRD ? store_->crtclPathsFrmRoot[storeIndx_]
+                            : store_->crtclPathsFrmLeaf[storeIndx_];
+  }
 
   // Notifies this instruction that one of its predecessors has been scheduled
   // in a certain cycle. If that was the last predecessor to schedule, this
@@ -292,22 +336,31 @@ public:
   // Sets the instruction issue type to a given value.
   void SetIssueType(IssueType type);
   // Returns the issue type of the instruction.
-  IssueType GetIssueType() const;
+  IssueType GetIssueType() const { return store_->issuTypes[storeIndx_]; }
 
   // Returns whether the instruction has been scheduled. If the cycle argument
   // is provided, it is filled with the cycle to which this instruction has
   // been scheduled.
-  bool IsSchduld(InstCount *cycle = NULL) const;
+  bool IsSchduld(InstCount *cycle = NULL) const {
+    InstCount schedCycle = store_->schedCycles[storeIndx_];
+    if (cycle)
+      *cycle = schedCycle;
+    return schedCycle != SCHD_UNSCHDULD;
+  }
 
   // Returns the cycle to which this instruction has been scheduled.
-  InstCount GetSchedCycle() const;
+  InstCount GetSchedCycle() const { return store_->schedCycles[storeIndx_]; }
   // Returns the slot to which this instruction has been scheduled.
   InstCount GetSchedSlot() const;
 
   // Returns the number of the deadline cycle for this instruction.
-  InstCount GetCrntDeadline() const;
+  InstCount GetCrntDeadline() const {
+    return IsSchduld() ? GetSchedCycle() : store_->crntDeadlines[storeIndx_];
+  }
   // Returns the release time for this instruction.
-  InstCount GetCrntReleaseTime() const;
+  InstCount GetCrntReleaseTime() const {
+    return IsSchduld() ? GetSchedCycle() : GetCrntLwrBound(DIR_FRWRD);
+  }
   // Returns the relaxed cycle number for this instruction.
   // TODO(ghassan): Elaborate.
   InstCount GetRlxdCycle() const;
@@ -316,7 +369,10 @@ public:
   void SetRlxdCycle(InstCount cycle);
 
   // Returns the instruction's current lower bound in the given direction.
-  InstCount GetCrntLwrBound(DIRECTION dir) const;
+  InstCount GetCrntLwrBound(DIRECTION dir) const {
+    return dir == DIR_FRWRD ? store_->crntFrwrdLwrBounds[storeIndx_]
+                            : store_->crntBkwrdLwrBounds[storeIndx_];
+  }
   // Sets the instruction's current lower bound in the given direction.
   void SetCrntLwrBound(DIRECTION dir, InstCount bound);
 
@@ -338,6 +394,9 @@ public:
   void UnTightnLwrBounds();
   // Marks the instruction as not tightened.
   void CmtLwrBoundTightnng();
+  // Returns the lower bound in the given direction before it was tightened.
+  // Only valid until the tightening is undone or committed.
+  InstCount GetPrevLwrBound(DIRECTION dir) const;
 
   // Sets the instruction's signature.
   void SetSig(InstSignature sig);
@@ -425,9 +484,11 @@ public:
   void ComputeAdjustedUseCnt(SchedInstruction *inst);
 
   int16_t CmputLastUseCnt();
-  int16_t GetLastUseCnt() { return lastUseCnt_; }
+  int16_t GetLastUseCnt() { return store_->lastUseCnts[storeIndx_]; }
 
-  InstType GetCrtclPathFrmRoot() { return crtclPathFrmRoot_; }
+  InstType GetCrtclPathFrmRoot() {
+    return store_->crtclPathsFrmRoot[storeIndx_];
+  }
 
   friend class SchedRange;
 
@@ -440,8 +501,6 @@ protected:
   int nodeID_;
   // The type of this instruction.
   InstType instType_;
-  // The issue type of this instruction.
-  IssueType issuType_;
   // The order of this instruction in the input file's schedule.
   InstCount fileSchedOrder_;
   // The issue cycle of this instruction in the input file's schedule.
@@ -452,28 +511,25 @@ protected:
   // The number of successors of this instruction.
   InstCount scsrCnt_;
 
-  // The minimum cycle in which this instruction can be scheduled, given its
-  // data and resource constraints.
-  InstCount frwrdLwrBound_;
-
-  // The maximum cycle (measured backwards relative to the leaf node) in which
-  // this instruction can be scheduled, given its data and resource
-  // constraints. The leaf node's upper bound in this scheme is always zero
-  // and the root node's upper bound is always equal to the leaf node's lower
-  // bound.
-  InstCount bkwrdLwrBound_;
+  // The store holding the issue type, the static lower bounds, the critical
+  // paths, the scheduled cycle and the last-use count of this instruction,
+  // and the index of the instruction in it. The forward lower bound is the
+  // minimum cycle in which this instruction can be scheduled, given its data
+  // and resource constraints. The backward lower bound is the maximum cycle,
+  // measured backwards relative to the leaf node, in which it can be
+  // scheduled. The leaf node's backward bound is always zero and the root
+  // node's is always equal to the leaf node's forward bound.
+  SchedInstStore *store_;
+  InstCount storeIndx_;
+  // The store of an instruction that was not given one, such as the root or
+  // leaf of a subgraph.
+  std::unique_ptr<SchedInstStore> ownStore_;
 
   // The absolute forward lower bound of this instruction.
   InstCount abslutFrwrdLwrBound_;
   //  The absolute backward lower bound of this instruction.
   InstCount abslutBkwrdLwrBound_;
 
-  // The critical-path distance of this instruction from the root.
-  InstCount crtclPathFrmRoot_;
-
-  // The critical-path distance of this instruction from the leaf.
-  InstCount crtclPathFrmLeaf_;
-
   // Whether memory has been allocated for this instruction's data structures.
   bool memAllocd_;
 
@@ -510,8 +566,6 @@ protected:
   InstCount unschduldScsrCnt_;
   /***************************************************************************/
 
-  // The cycle in which this instruction is currently scheduled.
-  InstCount crntSchedCycle_;
   // The slot in which this instruction is currently scheduled.
   InstCount crntSchedSlot_;
   // TODO(ghassan): Document.
@@ -561,9 +615,6 @@ protected:
   // The number of uses minus live-out registers. Live-out registers are uses
   // in the artifical leaf instruction.
   int16_t adjustedUseCnt_;
-  // The number of live virtual registers for which this instruction is
-  // the last use. This value changes dynamically during scheduling
-  int16_t lastUseCnt_;
   /***************************************************************************/
 
   // Whether this instruction blocks its cycle, i.e. does not allow other
@@ -651,14 +702,15 @@ public:
            LinkedList<SchedInstruction> *fxdLst);
   // Returns whether the range is tightened in the given direction.
   bool IsTightnd(DIRECTION dir) const;
+  // Returns the lower bound in the given direction before it was tightened.
+  InstCount GetPrevLwrBound(DIRECTION dir) const;
 
 protected:
-  // The forward lower bound.
-  // TODO(ghassan): Elaborate.
-  InstCount frwrdLwrBound_;
-  // The backward lower bound.
-  // TODO(ghassan): Elaborate.
-  InstCount bkwrdLwrBound_;
+  // The store holding the forward and backward lower bounds and the deadline
+  // of this range, which are those of its instruction, and the index of the
+  // instruction in it.
+  SchedInstStore *store_;
+  InstCount indx_;
 
   // The last cycle number in the current target length. It is equal to the
   // target schedule length minus one.
@@ -682,6 +734,9 @@ protected:
   // A pointer to the instruction that owns this range.
   SchedInstruction *inst_;
 
+  // Sets the forward or backward lower bound of this range, keeping the
+  // deadline in step with the backward one.
+  void SetLwrBound_(DIRECTION dir, InstCount bound);
   // Returns the sum of the range's forward and backward lower bounds.
   InstCount GetLwrBoundSum_() const;
   // Returns whether the bounds of this range may produce a feasible schedule.
@@ -17,6 +17,9 @@ Last Update:  Jan. 2020
 #include "opt-sched/Scheduler/data_dep.h"
 // For Enumerator, LengthCostEnumerator, EnumTreeNode and Pruning.
 #include "opt-sched/Scheduler/enumerator.h"
+// For SharedIncumbent.
+#include "opt-sched/Scheduler/parallel_enum.h"
+#include <algorithm>
 
 namespace llvm {
 namespace opt_sched {
@@ -60,8 +63,13 @@ public:
   inline int getSpillCostLwrBound() { return SpillCostLwrBound_; }
   inline InstCount GetExecCostLwrBound() { return ExecCostLwrBound_; }
   inline InstCount GetRPCostLwrBound() { return RpCostLwrBound_; }
-  // Returns the best cost found so far for this region.
-  inline InstCount GetBestCost() { return bestCost_; }
+  // Returns the best cost found so far for this region. When enumerating in
+  // parallel, this includes the costs found by the other threads.
+  inline InstCount GetBestCost() {
+    if (sharedBestCost_ == NULL)
+      return bestCost_;
+    return std::min(bestCost_, sharedBestCost_->get());
+  }
   // Returns the heuristic cost for this region.
   inline InstCount GetHeuristicCost() { return hurstcCost_; }
   // Return the spill cost for first pass of this region
@@ -75,6 +83,11 @@ public:
 
   // Gets the un-normalized incremental RP cost for the region(used by ACO)
   virtual InstCount getUnnormalizedIncrementalRPCost() const = 0;
+  // Gets lower bounds on the normalized total cost and on the normalized
+  // spill cost of any schedule that completes the current partial schedule,
+  // given a lower bound on its length (used by ACO)
+  virtual InstCount getPartialCostLwrBound(InstCount lngthLwrBound) = 0;
+  virtual InstCount getPartialNormSpillCostLwrBound() = 0;
   // Get schedLength for best-so-far sched
   inline InstCount getBestSchedLength() { return bestSchedLngth_; }
 
@@ -148,6 +161,20 @@ public:
   bool enumFoundSchedule() { return EnumFoundSchedule; }
   void setEnumFoundSchedule() { EnumFoundSchedule = true; }
 
+  // The number of tree nodes examined by the enumerator, or 0 if the region
+  // did not reach it.
+  uint64_t getEnumNodeCnt() const { return EnumNodeCnt; }
+  // The time the enumerator ran for, or 0 if the region did not reach it.
+  Milliseconds getEnumTime() const { return EnumTime; }
+  // The number of relaxed feasibility checks done by the enumerator, and the
+  // time taken by them in microseconds.
+  uint64_t getRlxdChkCnt() const { return RlxdChkCnt; }
+  uint64_t getRlxdChkTime() const { return RlxdChkTime; }
+  // The number of ACO iterations run on this region, and the time taken by
+  // them.
+  uint64_t getAcoIterCnt() const { return AcoIterCnt; }
+  Milliseconds getAcoTime() const { return AcoRunTime; }
+
 private:
   // The algorithm to use for calculated lower bounds.
   LB_ALG lbAlg_;
@@ -183,6 +210,15 @@ private:
   /// Indicate whether the B&B enumerator found any schedule.
   bool EnumFoundSchedule;
 
+  // The number of nodes examined by the last enumeration, and its duration.
+  uint64_t EnumNodeCnt = 0;
+  Milliseconds EnumTime = 0;
+  uint64_t RlxdChkCnt = 0;
+  uint64_t RlxdChkTime = 0;
+  // The total number of ACO iterations and ACO time over all runs of ACO.
+  uint64_t AcoIterCnt = 0;
+  Milliseconds AcoRunTime = 0;
+
   // The absolute cost lower bound to be used as a ref for normalized costs.
   InstCount costLwrBound_ = 0;
 
@@ -194,6 +230,9 @@ private:
   InstCount bestSchedLngth_;
   InstCount BestSpillCost_;
 
+  // The best cost shared with the other threads when enumerating in parallel.
+  SharedIncumbent *sharedBestCost_ = NULL;
+
   // (Chris): The cost function. Defaults to PERP.
   SPILL_COST_FUNCTION spillCostFunc_ = SCF_PERP;
 
@@ -247,7 +286,17 @@ protected:
   // protected accessors:
   SchedulerType GetHeuristicSchedulerType() const { return HeurSchedType_; }
 
-  void SetBestCost(InstCount bestCost) { bestCost_ = bestCost; }
+  void SetBestCost(InstCount bestCost) {
+    bestCost_ = bestCost;
+    if (sharedBestCost_ != NULL)
+      sharedBestCost_->offer(bestCost);
+  }
+
+  void setSharedBestCost(SharedIncumbent *SharedBestCost) {
+    sharedBestCost_ = SharedBestCost;
+  }
+
+  SharedIncumbent *getSharedBestCost() const { return sharedBestCost_; }
 
   void SetBestSchedLength(InstCount bestSchedLngth) {
     bestSchedLngth_ = bestSchedLngth;
@@ -273,6 +322,16 @@ protected:
   // TODO(max): Document.
   void UseFileBounds_();
 
+  // Repeats the setup of mainRgn on this region, which must have been built
+  // from the same DAG. mainRgn must already have its bounds computed. The
+  // relaxed lower bounds are recomputed if cmputRlxdBounds is set, and copied
+  // otherwise. Returns false if the two regions disagree.
+  bool SetupWorkerRgn_(SchedRegion *mainRgn, bool cmputRlxdBounds);
+  // Prepares this region, which must have been built from the same DAG as
+  // mainRgn, to enumerate alongside it on another thread. mainRgn must already
+  // have its bounds computed. Returns false if the two regions disagree.
+  bool SetupParallelWorker_(SchedRegion *mainRgn, Milliseconds lngthTimeout);
+
   // Top-level function for enumerative scheduling
   FUNC_RESULT Optimize_(Milliseconds startTime, Milliseconds rgnTimeout,
                         Milliseconds lngthTimeout);
@@ -322,8 +381,32 @@ protected:
   // (Chris) Get the SLIL for each set
   virtual const std::vector<int> &GetSLIL_() const = 0;
 
+  // Sets up the copies of this region that ACO constructs ants with on other
+  // threads. Returns no regions if ACO should run on this thread alone.
+  virtual std::vector<SchedRegion *> SetupAcoWrkrs_() { return {}; }
+  virtual void FreeAcoWrkrs_() {}
+
+  // Sets up the copy of this region that ACO schedules on another thread
+  // while this region is enumerated. Returns NULL if ACO cannot be pipelined
+  // with the enumerator.
+  virtual SchedRegion *SetupPipelinedAcoWrkr_() { return NULL; }
+  virtual void FreePipelinedAcoWrkr_() {}
+
+  // Runs ACO on this region, stopping at Deadline if it is not INVALID_VALUE.
   FUNC_RESULT runACO(InstSchedule *ReturnSched, InstSchedule *InitSched,
-                     bool IsPostBB);
+                     bool IsPostBB, Milliseconds Deadline = INVALID_VALUE);
+
+  // An ACO run on another thread alongside the enumerator.
+  struct AcoPipeline;
+  // Starts ACO from InitSched on AcoRgn, which SetupPipelinedAcoWrkr_() set
+  // up. Until the pipeline is finished, the cost of each better schedule that
+  // ACO finds becomes the best cost that this region is enumerated against.
+  AcoPipeline *StartPipelinedAco_(SchedRegion *AcoRgn, InstSchedule *InitSched,
+                                  Milliseconds Deadline);
+  // Stops the ACO of Pipeline, waits for it and frees the pipeline. Returns
+  // the best schedule that ACO found, as a schedule of this region, or NULL if
+  // ACO failed.
+  InstSchedule *FinishPipelinedAco_(AcoPipeline *Pipeline);
 };
 
 } // namespace opt_sched
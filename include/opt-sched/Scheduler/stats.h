@@ -288,6 +288,7 @@ extern IntDistributionStat regionBuildTime;
 extern IntDistributionStat heuristicTime;
 extern IntDistributionStat AcoTime;
 extern IntDistributionStat boundComputationTime;
+extern IntDistributionStat relaxedBoundTime;
 extern IntDistributionStat enumerationTime;
 extern IntDistributionStat enumerationToHeuristicTimeRatio;
 extern IntDistributionStat verificationTime;
@@ -299,6 +300,14 @@ extern IntDistributionStat traversedHistoryListSize;
 extern IntDistributionStat historyDominationPosition;
 extern IntDistributionStat historyDominationPositionToListSize;
 extern IntDistributionStat historyTableInitializationTime;
+extern IntDistributionStat historyShardEntries;
+extern IntDistributionStat historyShardCollisions;
+extern IntDistributionStat historyShardMaxListSize;
+extern IntDistributionStat historyEvictions;
+extern IntDistributionStat historyRejections;
+extern IntDistributionStat historyDominationsLostToEviction;
+extern IntDistributionStat historyPeakMemory;
+extern IntDistributionStat historyDominationCheckTime;
 
 extern IntDistributionStat scheduledLatency;
 
@@ -334,6 +343,8 @@ extern IntStat negativeLowerBoundMismatchCount;
 extern IntStat signatureDominationTests;
 extern IntStat signatureMatches;
 extern IntStat signatureAliases;
+extern IntStat historySignatureTests;
+extern IntStat historySignatureAliases;
 extern IntStat subsetMatches;
 extern IntStat absoluteDominationHits;
 extern IntStat positiveDominationHits;
@@ -0,0 +1,70 @@
+/*******************************************************************************
+Description:  Defines a trail of state changes for the enumerator. Each change
+              pushes a small typed record holding the value it overwrote, and
+              backtracking pops the records back to a mark saved when the tree
+              node was entered, undoing the changes newest first.
+*******************************************************************************/
+
+#ifndef OPTSCHED_ENUM_UNDO_TRAIL_H
+#define OPTSCHED_ENUM_UNDO_TRAIL_H
+
+#include "opt-sched/Scheduler/defines.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace llvm {
+namespace opt_sched {
+
+// The kinds of state recorded on the trail.
+enum TRAIL_KIND : int16_t {
+  // The forward lower bound of the instruction with the number in indx.
+  TK_FRWRD_LWR_BOUND,
+  // The available slots in the target length of the issue type in indx.
+  TK_AVLBL_SLOTS,
+  // The available slots in the current cycle of the issue type in indx.
+  TK_AVLBL_SLOTS_IN_CYCLE
+};
+
+struct TrailEntry {
+  TRAIL_KIND kind;
+  InstCount indx;
+  // The value before the change.
+  InstCount val;
+};
+
+class UndoTrail {
+public:
+  typedef size_t Mark;
+
+  void Push(TRAIL_KIND kind, InstCount indx, InstCount val) {
+    entries_.push_back({kind, indx, val});
+  }
+
+  // Returns the mark to pop back to in order to undo the changes pushed from
+  // now on.
+  Mark GetMark() const { return entries_.size(); }
+
+  // Pops the entries pushed after the mark, newest first, passing each one to
+  // undo.
+  template <typename UndoFunc> void PopTo(Mark mark, UndoFunc undo) {
+    assert(mark <= entries_.size());
+    while (entries_.size() > mark) {
+      undo(entries_.back());
+      entries_.pop_back();
+    }
+  }
+
+  void Reset() { entries_.clear(); }
+
+  size_t GetSize() const { return entries_.size(); }
+
+private:
+  std::vector<TrailEntry> entries_;
+};
+
+} // namespace opt_sched
+} // namespace llvm
+
+#endif
@@ -1,15 +1,20 @@
 #include "opt-sched/Scheduler/aco.h"
 #include "opt-sched/Scheduler/config.h"
 #include "opt-sched/Scheduler/data_dep.h"
+#include "opt-sched/Scheduler/parallel_enum.h"
+#include "opt-sched/Scheduler/pheromone_cache.h"
 #include "opt-sched/Scheduler/random.h"
 #include "opt-sched/Scheduler/ready_list.h"
 #include "opt-sched/Scheduler/register.h"
 #include "opt-sched/Scheduler/sched_region.h"
+#include "opt-sched/Scheduler/utilities.h"
 #include "llvm/ADT/STLExtras.h"
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <limits>
 #include <sstream>
+#include <thread>
 
 using namespace llvm::opt_sched;
 
@@ -18,11 +23,6 @@ static void PrintInstruction(SchedInstruction *inst);
 #endif
 void PrintSchedule(InstSchedule *schedule);
 
-double RandDouble(double min, double max) {
-  double rand = (double)RandomGen::GetRand32() / INT32_MAX;
-  return (rand * (max - min)) + min;
-}
-
 #define DBG_SRS 0
 
 #if DBG_SRS
@@ -71,6 +71,9 @@ ACOScheduler::ACOScheduler(DataDepGraph *dataDepGraph,
       schedIni.GetInt("ACO2P_ANT_PER_ITERATION", ants_per_iteration1p);
   ants_per_iteration = ants_per_iteration1p;
   print_aco_trace = schedIni.GetBool("ACO_TRACE");
+  ScalarSelect = schedIni.GetBool("ACO_SCALAR_SELECTION", false);
+  AbortByBound = schedIni.GetBool("ACO_ABORT_BY_BOUND", true);
+  UsePheromoneCache = schedIni.GetBool("ACO_PHEROMONE_CACHE", false);
   IsTwoPassEn = schedIni.GetBool("USE_TWO_PASS");
   DCFOption = ParseDCFOpt(schedIni.GetString("ACO_DUAL_COST_FN_ENABLE", "OFF"));
 
@@ -98,8 +101,6 @@ ACOScheduler::ACOScheduler(DataDepGraph *dataDepGraph,
   std::cerr << "decay_factor===="<<decay_factor<<"\n\n";
   std::cerr << "ants_per_iteration===="<<ants_per_iteration<<"\n\n";
   */
-  int pheromone_size = (count_ + 1) * count_;
-  pheromone_.resize(pheromone_size);
   InitialSchedule = nullptr;
 }
 
@@ -108,8 +109,8 @@ ACOScheduler::~ACOScheduler() { delete rdyLst_; }
 // Pheromone table lookup
 // -1 means no instruction, so e.g. pheromone(-1, 10) gives pheromone on path
 // from empty schedule to schedule only containing instruction 10
-pheromone_t &ACOScheduler::Pheromone(SchedInstruction *from,
-                                     SchedInstruction *to) {
+pheromone_cell_t &ACOScheduler::Pheromone(SchedInstruction *from,
+                                          SchedInstruction *to) {
   assert(to != NULL);
   int fromNum = -1;
   if (from != NULL)
@@ -117,11 +118,11 @@ pheromone_t &ACOScheduler::Pheromone(SchedInstruction *from,
   return Pheromone(fromNum, to->GetNum());
 }
 
-pheromone_t &ACOScheduler::Pheromone(InstCount from, InstCount to) {
+pheromone_cell_t &ACOScheduler::Pheromone(InstCount from, InstCount to) {
   int row = 0;
   if (from != -1)
     row = from + 1;
-  return pheromone_[(row * count_) + to];
+  return PheromoneTbl_[(row * count_) + to];
 }
 
 double ACOScheduler::Score(SchedInstruction *from, Choice choice) {
@@ -200,6 +201,11 @@ bool ACOScheduler::shouldReplaceSchedule(InstSchedule *OldSched,
   }
 }
 
+double ACOScheduler::RandDouble(double min, double max) {
+  double rand = AntRand_.GetRandDouble();
+  return (rand * (max - min)) + min;
+}
+
 DCF_OPT ACOScheduler::ParseDCFOpt(const std::string &opt) {
   if (opt == "OFF")
     return DCF_OPT::OFF;
@@ -214,6 +220,13 @@ DCF_OPT ACOScheduler::ParseDCFOpt(const std::string &opt) {
                            false);
 }
 
+void ACOScheduler::ScoreChoices(const llvm::ArrayRef<Choice> &ready,
+                                SchedInstruction *lastInst) {
+  Scores_.resize(ready.size());
+  for (size_t i = 0; i < ready.size(); i++)
+    Scores_[i] = Score(lastInst, ready[i]);
+}
+
 Choice ACOScheduler::SelectInstruction(const llvm::ArrayRef<Choice> &ready,
                                        SchedInstruction *lastInst) {
 #if TWO_STEP
@@ -226,17 +239,12 @@ Choice ACOScheduler::SelectInstruction(const llvm::ArrayRef<Choice> &ready,
   if (RandDouble(0, 1) < choose_best_chance) {
     if (print_aco_trace)
       std::cerr << "choose_best, use fixed bias: " << use_fixed_bias << "\n";
-    pheromone_t max = -1;
-    Choice maxChoice;
-    for (auto &choice : ready) {
-      if (Score(lastInst, choice) > max) {
-        max = Score(lastInst, choice);
-        maxChoice = choice;
-      }
-    }
-    return maxChoice;
+    ScoreChoices(ready, lastInst);
+    return ready[ScalarSelect ? AcoSelect::argMaxScalar(Scores_)
+                              : AcoSelect::argMax(Scores_)];
   }
 #endif
+  // A tournament only looks at the scores of the two choices it draws.
   if (use_tournament) {
     int POPULATION_SIZE = ready.size();
     int r_pos = (int)(RandDouble(0, 1) * POPULATION_SIZE);
@@ -245,6 +253,8 @@ Choice ACOScheduler::SelectInstruction(const llvm::ArrayRef<Choice> &ready,
     Choice r = ready[r_pos];
     Choice s = ready[s_pos];
     //    Choice t = ready[t_pos];
+    pheromone_t rScore = Score(lastInst, r);
+    pheromone_t sScore = Score(lastInst, s);
     if (print_aco_trace) {
       std::cerr << "tournament Start \n";
       std::cerr << "array_size:" << POPULATION_SIZE << "\n";
@@ -252,12 +262,11 @@ Choice ACOScheduler::SelectInstruction(const llvm::ArrayRef<Choice> &ready,
       std::cerr << "s:\t" << s_pos << "\n";
       //        std::cerr<<"t:\t"<<t_pos<<"\n";
 
-      std::cerr << "Score r" << Score(lastInst, r) << "\n";
-      std::cerr << "Score s" << Score(lastInst, s) << "\n";
+      std::cerr << "Score r" << rScore << "\n";
+      std::cerr << "Score s" << sScore << "\n";
       //         std::cerr<<"Score t"<<Score(lastInst, t)<<"\n";
     }
-    if (Score(lastInst, r) >=
-        Score(lastInst, s)) //&& Score(lastInst, r) >= Score(lastInst, t))
+    if (rScore >= sScore) //&& Score(lastInst, r) >= Score(lastInst, t))
       return r;
     //     else if (Score(lastInst, s) >= Score(lastInst, r) && Score(lastInst,
     //     s) >= Score(lastInst, t))
@@ -265,22 +274,24 @@ Choice ACOScheduler::SelectInstruction(const llvm::ArrayRef<Choice> &ready,
     else
       return s;
   }
-  pheromone_t sum = 0;
-  for (auto choice : ready)
-    sum += Score(lastInst, choice);
+  ScoreChoices(ready, lastInst);
+  pheromone_t sum =
+      ScalarSelect ? AcoSelect::sumScalar(Scores_) : AcoSelect::sum(Scores_);
   pheromone_t point = RandDouble(0, sum);
-  for (auto choice : ready) {
-    point -= Score(lastInst, choice);
-    if (point <= 0)
-      return choice;
-  }
+  size_t Indx = ScalarSelect ? AcoSelect::rouletteScalar(Scores_, point)
+                             : AcoSelect::roulette(Scores_, point);
+  if (Indx < ready.size())
+    return ready[Indx];
   std::cerr << "returning last instruction" << std::endl;
+  // The roulette has subtracted all the scores from the point.
   assert(point < 0.001); // floats should not be this inaccurate
   return ready.back();
 }
 
 std::unique_ptr<InstSchedule>
-ACOScheduler::FindOneSchedule(InstCount TargetRPCost) {
+ACOScheduler::FindOneSchedule(uint64_t AntSeed, InstCount TargetRPCost,
+                              InstCount CostUprBound) {
+  AntRand_.Seed(AntSeed);
   SchedInstruction *lastInst = NULL;
   std::unique_ptr<InstSchedule> schedule =
       llvm::make_unique<InstSchedule>(machMdl_, dataDepGraph_, true);
@@ -353,6 +364,16 @@ ACOScheduler::FindOneSchedule(InstCount TargetRPCost) {
       }
 #endif
 
+      // Stop the ant once it cannot beat the cost it has to beat.
+      if (CostUprBound != MaxCost && !ready.empty() &&
+          CmputAntCostLwrBound_(ready) > CostUprBound) {
+        ++AbortedAntCnt;
+        SavedAntStepCnt += totInstCnt_ - schduldInstCnt_;
+        delete rdyLst_;
+        rdyLst_ = new ReadyList(dataDepGraph_, prirts_);
+        return nullptr;
+      }
+
       if (!ready.empty()) {
         Choice Sel = SelectInstruction(ready, lastInst);
         waitUntil = Sel.readyOn;
@@ -365,7 +386,7 @@ ACOScheduler::FindOneSchedule(InstCount TargetRPCost) {
       if (inst != NULL) {
 #if USE_ACS
         // local pheromone decay
-        pheromone_t *pheromone = &Pheromone(lastInst, inst);
+        pheromone_cell_t *pheromone = &Pheromone(lastInst, inst);
         *pheromone =
             (1 - local_decay) * *pheromone + local_decay * initialValue_;
 #endif
@@ -423,6 +444,32 @@ ACOScheduler::FindOneSchedule(InstCount TargetRPCost) {
   return schedule;
 }
 
+InstCount ACOScheduler::CmputAntCostLwrBound_(llvm::ArrayRef<Choice> ready) {
+  // Every unscheduled instruction is a choice or a successor of one, and the
+  // successors have smaller backward bounds, so the choices bound the length.
+  InstCount LngthLwrBound = 0;
+  for (const Choice &C : ready) {
+    InstCount Cycle = std::max(crntCycleNum_, C.readyOn);
+    LngthLwrBound = std::max(LngthLwrBound,
+                             Cycle + C.inst->GetLwrBound(DIR_BKWRD) + 1);
+  }
+
+  // Measure the cost that shouldReplaceSchedule() compares.
+  if (IsTwoPassEn)
+    return rgn_->getPartialNormSpillCostLwrBound();
+  return rgn_->getPartialCostLwrBound(LngthLwrBound);
+}
+
+InstCount ACOScheduler::AntCostUprBound_(InstSchedule *IterationBest) {
+  // An ant that costs more than the iteration best is discarded anyway. The
+  // second pass does not compare by a single cost.
+  if (!AbortByBound || !IterationBest ||
+      (IsTwoPassEn && rgn_->IsSecondPass()))
+    return MaxCost;
+  return !IsTwoPassEn ? IterationBest->GetCost()
+                      : IterationBest->GetNormSpillCost();
+}
+
 FUNC_RESULT ACOScheduler::FindSchedule(InstSchedule *schedule_out,
                                        SchedRegion *region) {
   rgn_ = region;
@@ -449,14 +496,22 @@ FUNC_RESULT ACOScheduler::FindSchedule(InstSchedule *schedule_out,
   // compute the relative maximum score inverse
   ScRelMax = rgn_->GetHeuristicCost();
 
+  // Each ant draws from its own random stream, derived from the global seed,
+  // the region, the pass, and the ant's place in the run. The ants are then
+  // the same whatever ran before and however many threads construct them.
+  PassSeed_ = RandomStream::MixSeedWithStr(RandomGen::GetSeed(),
+                                           dataDepGraph_->GetDagID());
+  PassSeed_ = RandomStream::MixSeed(PassSeed_, (IsFirst ? 0 : 2) + IsPostBB);
+
   // initialize pheromone
   // for this, we need the cost of the pure heuristic schedule
   int pheromone_size = (count_ + 1) * count_;
-  for (int i = 0; i < pheromone_size; i++)
-    pheromone_[i] = 1;
+  pheromone_.assign(pheromone_size, 1);
+  PheromoneTbl_ = pheromone_.data();
   initialValue_ = 1;
   const InstCount MaxRPTarget = std::numeric_limits<InstCount>::max();
-  std::unique_ptr<InstSchedule> heuristicSched = FindOneSchedule(MaxRPTarget);
+  std::unique_ptr<InstSchedule> heuristicSched =
+      FindOneSchedule(AntSeed_(0, 0), MaxRPTarget);
   InstCount heuristicCost =
       heuristicSched->GetCost() + 1; // prevent divide by zero
   InstCount InitialCost = InitialSchedule ? InitialSchedule->GetCost() : 0;
@@ -469,26 +524,75 @@ FUNC_RESULT ACOScheduler::FindSchedule(InstSchedule *schedule_out,
 #else
   initialValue_ = (double)ants_per_iteration / heuristicCost;
 #endif
-  for (int i = 0; i < pheromone_size; i++)
-    pheromone_[i] = initialValue_;
   std::cerr << "initialValue_" << initialValue_ << std::endl;
 
+  // Start from the pheromone that an earlier run left on the same DAG, if
+  // there is one. The table is clamped to the same range whatever the costs,
+  // so it carries over between passes with different cost functions.
+  uint64_t DagHash = 0;
+  bool IsWarmStart = false;
+  if (UsePheromoneCache) {
+    DagHash = PheromoneCache::hashDag(dataDepGraph_);
+    IsWarmStart = PheromoneCache::getInstance().load(dataDepGraph_->GetDagID(),
+                                                     DagHash, pheromone_);
+  }
+  if (IsWarmStart)
+    Logger::Info("ACO starts from the pheromone of an earlier run");
+  else
+    std::fill(pheromone_.begin(), pheromone_.end(), initialValue_);
+
   std::unique_ptr<InstSchedule> bestSchedule = std::move(InitialSchedule);
   if (bestSchedule) {
     UpdatePheromone(bestSchedule.get());
   }
   writePheromoneGraph("initial");
 
+  // The ant workers construct their ants with this iteration's settings and
+  // read this scheduler's pheromone. The ant edges and the trace are only
+  // recorded on this thread.
+  bool IsPrll = !AntWrkrs_.empty() && !IsDbg && !print_aco_trace;
+  for (ACOScheduler *Wrkr : AntWrkrs_) {
+    Wrkr->AbortedAntCnt = 0;
+    Wrkr->SavedAntStepCnt = 0;
+    Wrkr->heuristicImportance_ = heuristicImportance_;
+    Wrkr->fixed_bias = fixed_bias;
+    Wrkr->initialValue_ = initialValue_;
+    Wrkr->PheromoneTbl_ = PheromoneTbl_;
+  }
+  if (IsPrll)
+    Logger::Info("ACO constructs ants on %d threads",
+                 (int)AntWrkrs_.size() + 1);
+
+  // Except for the first ant, stop the ants whose RP cost exceeds the target.
+  InstCount AntTarget =
+      rgn_->GetSpillCostFunc() != SCF_SLIL ? TargetNSC : MaxRPTarget;
   int noImprovement = 0; // how many iterations with no improvement
   int iterations = 0;
+  IterationCnt = 0;
+  AbortedAntCnt = 0;
+  SavedAntStepCnt = 0;
   while (true) {
     std::unique_ptr<InstSchedule> iterationBest;
+    std::vector<std::unique_ptr<InstSchedule>> AntScheds;
+    if (IsPrll)
+      AntScheds = FindAntSchedulesPrll_(iterations + 1, AntTarget);
     for (int i = 0; i < ants_per_iteration; i++) {
-      CrntAntEdges.clear();
-      std::unique_ptr<InstSchedule> schedule = FindOneSchedule(
-          i && rgn_->GetSpillCostFunc() != SCF_SLIL ? TargetNSC : MaxRPTarget);
-      if (print_aco_trace)
-        PrintSchedule(schedule.get());
+      std::unique_ptr<InstSchedule> schedule;
+      if (IsPrll) {
+        schedule = std::move(AntScheds[i]);
+      } else {
+        CrntAntEdges.clear();
+        schedule = FindOneSchedule(AntSeed_(iterations + 1, i),
+                                   i ? AntTarget : MaxRPTarget,
+                                   AntCostUprBound_(iterationBest.get()));
+      }
+      if (print_aco_trace) {
+        // An aborted ant has no schedule.
+        if (schedule)
+          PrintSchedule(schedule.get());
+        else
+          std::cerr << "aborted" << std::endl;
+      }
       ++localCmp;
       if (iterationBest && bestSchedule &&
           !(!IsFirst && iterationBest->GetNormSpillCost() <=
@@ -502,6 +606,7 @@ FUNC_RESULT ACOScheduler::FindSchedule(InstSchedule *schedule_out,
       }
     }
     ++globalCmp;
+    ++IterationCnt;
     if (IsFirst || iterationBest->GetNormSpillCost() <= TargetNSC) {
       UpdatePheromone(iterationBest.get());
     } else
@@ -524,6 +629,8 @@ FUNC_RESULT ACOScheduler::FindSchedule(InstSchedule *schedule_out,
                    rgn_->GetRPCostLwrBound());
       if (IsDbg)
         BestAntEdges = IterAntEdges;
+      if (Incumbent_)
+        Incumbent_->offer(bestSchedule->GetCost());
 
       noImprovement = 0;
       if (bestSchedule && bestSchedule->GetCost() == 0)
@@ -538,14 +645,38 @@ FUNC_RESULT ACOScheduler::FindSchedule(InstSchedule *schedule_out,
 
     writePheromoneGraph("iteration" + std::to_string(iterations));
     iterations++;
+
+    if (StopRequest_ && StopRequest_->load(std::memory_order_relaxed)) {
+      Logger::Info("ACO stopped by the enumerator after %d iterations",
+                   iterations);
+      break;
+    }
+    if (Deadline_ != INVALID_VALUE &&
+        Utilities::GetProcessorTime() >= Deadline_) {
+      Logger::Info("ACO used up its time budget after %d iterations",
+                   iterations);
+      break;
+    }
   }
 
   Logger::Info("localCmp:%d,localCmpRej:%d,globalCmp:%d,globalCmpRej:%d",
                localCmp, localCmpRej, globalCmp, globalCmpRej);
 
+  for (ACOScheduler *Wrkr : AntWrkrs_) {
+    AbortedAntCnt += Wrkr->AbortedAntCnt;
+    SavedAntStepCnt += Wrkr->SavedAntStepCnt;
+  }
+  Logger::Event("AcoBoundAborts", "aborted_ants", AbortedAntCnt, //
+                "saved_steps", SavedAntStepCnt);
+
+  if (UsePheromoneCache)
+    PheromoneCache::getInstance().store(dataDepGraph_->GetDagID(), DagHash,
+                                        pheromone_);
+
   Logger::Event(IsPostBB ? "AcoPostSchedComplete" : "ACOSchedComplete", "cost",
                 bestSchedule->GetCost(), "iterations", iterations,
-                "improvement", InitialCost - bestSchedule->GetCost());
+                "improvement", InitialCost - bestSchedule->GetCost(),
+                "warm_start", IsWarmStart);
   PrintSchedule(bestSchedule.get());
   schedule_out->Copy(bestSchedule.release());
 
@@ -553,6 +684,37 @@ FUNC_RESULT ACOScheduler::FindSchedule(InstSchedule *schedule_out,
   return RES_SUCCESS;
 }
 
+std::vector<std::unique_ptr<InstSchedule>>
+ACOScheduler::FindAntSchedulesPrll_(int Iteration, InstCount TargetRPCost) {
+  const InstCount MaxRPTarget = std::numeric_limits<InstCount>::max();
+  std::vector<std::unique_ptr<InstSchedule>> Scheds(ants_per_iteration);
+  size_t ThrdCnt = AntWrkrs_.size() + 1;
+
+  // Each thread bounds its ants by the best of its own earlier ants. That only
+  // stops ants that would not have been the iteration best, so the iteration
+  // best does not depend on the number of threads.
+  auto findSchedules = [&](size_t ThrdNum) {
+    ACOScheduler *Schdulr = ThrdNum == 0 ? this : AntWrkrs_[ThrdNum - 1];
+    InstSchedule *ThrdBest = nullptr;
+    for (size_t i = ThrdNum; i < Scheds.size(); i += ThrdCnt) {
+      Scheds[i] = Schdulr->FindOneSchedule(AntSeed_(Iteration, i),
+                                           i ? TargetRPCost : MaxRPTarget,
+                                           Schdulr->AntCostUprBound_(ThrdBest));
+      if (Scheds[i] &&
+          shouldReplaceSchedule(ThrdBest, Scheds[i].get(), /*IsGlobal=*/false))
+        ThrdBest = Scheds[i].get();
+    }
+  };
+
+  std::vector<std::thread> Thrds;
+  for (size_t i = 1; i < ThrdCnt; i++)
+    Thrds.emplace_back(findSchedules, i);
+  findSchedules(0);
+  for (std::thread &Thrd : Thrds)
+    Thrd.join();
+  return Scheds;
+}
+
 void ACOScheduler::UpdatePheromone(InstSchedule *schedule) {
   // I wish InstSchedule allowed you to just iterate over it, but it's got this
   // cycle and slot thing which needs to be accounted for
@@ -567,7 +729,7 @@ void ACOScheduler::UpdatePheromone(InstSchedule *schedule) {
   while (instNum != INVALID_VALUE) {
     SchedInstruction *inst = dataDepGraph_->GetInstByIndx(instNum);
 
-    pheromone_t *pheromone = &Pheromone(lastInst, inst);
+    pheromone_cell_t *pheromone = &Pheromone(lastInst, inst);
 #if USE_ACS
     // ACS update rule includes decay
     // only the arcs on the current solution are decayed
@@ -584,12 +746,14 @@ void ACOScheduler::UpdatePheromone(InstSchedule *schedule) {
 
 #if !USE_ACS
   // decay pheromone
-  for (int i = 0; i < count_; i++) {
-    for (int j = 0; j < count_; j++) {
-      pheromone_t &PhPtr = Pheromone(i, j);
-      PhPtr *= (1 - decay_factor);
-      PhPtr = fmax(1, fmin(8, PhPtr));
-    }
+  // The rows from the instructions are contiguous, so this is a single pass
+  // that the compiler can vectorize. The row from the empty schedule is not
+  // decayed.
+  pheromone_cell_t *Row = &Pheromone(0, 0);
+  const pheromone_cell_t Keep = 1 - decay_factor;
+  for (int i = 0, e = count_ * count_; i < e; i++) {
+    pheromone_cell_t Ph = Row[i] * Keep;
+    Row[i] = Ph < 1 ? 1 : (Ph > 8 ? 8 : Ph);
   }
 #endif
   if (print_aco_trace)
@@ -668,6 +832,23 @@ void PrintSchedule(InstSchedule *schedule) {
   schedule->ResetInstIter();
 }
 
+void ACOScheduler::addAntWorker(ACOScheduler *Wrkr, SchedRegion *Rgn) {
+  assert(Wrkr->count_ == count_ && "The ant worker has a different DAG");
+  Wrkr->rgn_ = Rgn;
+  AntWrkrs_.push_back(Wrkr);
+}
+
+uint64_t ACOScheduler::AntSeed_(int Iteration, size_t Ant) const {
+  return RandomStream::MixSeed(RandomStream::MixSeed(PassSeed_, Iteration),
+                               Ant);
+}
+
+void ACOScheduler::setPipeline(SharedIncumbent *Incumbent,
+                               const std::atomic<bool> *Stop) {
+  Incumbent_ = Incumbent;
+  StopRequest_ = Stop;
+}
+
 void ACOScheduler::setInitialSched(InstSchedule *Sched) {
   if (Sched) {
     InitialSchedule =
@@ -0,0 +1,99 @@
+#include "opt-sched/Scheduler/aco_select.h"
+#include <cassert>
+
+using namespace llvm::opt_sched;
+
+using AcoSelect::LaneCnt;
+
+static_assert(LaneCnt == 4, "The unrolled kernels combine the lanes in pairs");
+
+size_t AcoSelect::argMax(ArrayRef<pheromone_t> Scores) {
+  assert(!Scores.empty());
+  size_t Cnt = Scores.size();
+  size_t i = 0;
+
+  // Find the highest score in lanes, then the first score equal to it. Taking
+  // the maximum is exact, so this picks the same score as the scalar version.
+  pheromone_t LaneMax[LaneCnt] = {-1, -1, -1, -1};
+  for (; i + LaneCnt <= Cnt; i += LaneCnt)
+    for (size_t l = 0; l < LaneCnt; l++)
+      LaneMax[l] = Scores[i + l] > LaneMax[l] ? Scores[i + l] : LaneMax[l];
+
+  pheromone_t Max = LaneMax[0];
+  for (size_t l = 1; l < LaneCnt; l++)
+    Max = LaneMax[l] > Max ? LaneMax[l] : Max;
+  for (; i < Cnt; i++)
+    Max = Scores[i] > Max ? Scores[i] : Max;
+
+  for (i = 0; i < Cnt; i++)
+    if (Scores[i] == Max)
+      return i;
+  return 0;
+}
+
+pheromone_t AcoSelect::sum(ArrayRef<pheromone_t> Scores) {
+  size_t Cnt = Scores.size();
+  size_t i = 0;
+
+  pheromone_t LaneSum[LaneCnt] = {0, 0, 0, 0};
+  for (; i + LaneCnt <= Cnt; i += LaneCnt)
+    for (size_t l = 0; l < LaneCnt; l++)
+      LaneSum[l] += Scores[i + l];
+
+  pheromone_t Sum = (LaneSum[0] + LaneSum[1]) + (LaneSum[2] + LaneSum[3]);
+  for (; i < Cnt; i++)
+    Sum += Scores[i];
+  return Sum;
+}
+
+size_t AcoSelect::roulette(ArrayRef<pheromone_t> Scores, pheromone_t &Point) {
+  size_t Cnt = Scores.size();
+  size_t i = 0;
+
+  // Skip whole blocks of lanes while the point lies beyond them, then find the
+  // score within the block that the point falls in.
+  for (; i + LaneCnt <= Cnt; i += LaneCnt) {
+    pheromone_t Block =
+        (Scores[i] + Scores[i + 1]) + (Scores[i + 2] + Scores[i + 3]);
+    if (Point - Block <= 0)
+      break;
+    Point -= Block;
+  }
+
+  for (; i < Cnt; i++) {
+    Point -= Scores[i];
+    if (Point <= 0)
+      return i;
+  }
+  return Cnt;
+}
+
+size_t AcoSelect::argMaxScalar(ArrayRef<pheromone_t> Scores) {
+  assert(!Scores.empty());
+  pheromone_t Max = -1;
+  size_t MaxIndx = 0;
+  for (size_t i = 0; i < Scores.size(); i++) {
+    if (Scores[i] > Max) {
+      Max = Scores[i];
+      MaxIndx = i;
+    }
+  }
+  return MaxIndx;
+}
+
+pheromone_t AcoSelect::sumScalar(ArrayRef<pheromone_t> Scores) {
+  pheromone_t Sum = 0;
+  for (pheromone_t Score : Scores)
+    Sum += Score;
+  return Sum;
+}
+
+size_t AcoSelect::rouletteScalar(ArrayRef<pheromone_t> Scores,
+                                 pheromone_t &Point) {
+  for (size_t i = 0; i < Scores.size(); i++) {
+    Point -= Scores[i];
+    if (Point <= 0)
+      return i;
+  }
+  return Scores.size();
+}
@@ -22,6 +22,7 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <utility>
 
 extern bool OPTSCHED_gPrintSpills;
@@ -76,6 +77,10 @@ BBWithSpill::BBWithSpill(const OptSchedTarget *OST_, DataDepGraph *dataDepGraph,
 /****************************************************************************/
 
 BBWithSpill::~BBWithSpill() {
+  FreePrllWrkrs_();
+  FreeAcoWrkrs_();
+  FreePipelinedAcoWrkr_();
+
   if (enumrtr_ != NULL) {
     delete enumrtr_;
   }
@@ -205,11 +210,10 @@ static InstCount ComputeSLILStaticLowerBound(int64_t regTypeCnt_,
                              ->GetRcrsvNghbrBitVector(DIR_BKWRD);
         assert(recSuccBV->GetSize() == recPredBV->GetSize() &&
                "Successor list size doesn't match predecessor list size!");
-        for (int k = 0; k < recSuccBV->GetSize(); ++k) {
-          if (recSuccBV->GetBit(k) & recPredBV->GetBit(k)) {
-            if (def->AddToInterval(dataDepGraph_->GetInstByIndx(k))) {
-              ++closureLowerBound;
-            }
+        auto betweenBV = recSuccBV->And(recPredBV);
+        for (int k : betweenBV->GetSetBits()) {
+          if (def->AddToInterval(dataDepGraph_->GetInstByIndx(k))) {
+            ++closureLowerBound;
           }
         }
       }
@@ -330,9 +334,65 @@ InstCount BBWithSpill::cmputSpillCostLwrBound() {
         ComputeSLILStaticLowerBound(regTypeCnt_, regFiles_, dataDepGraph_);
     dynamicSlilLowerBound_ = spillCostLwrBound;
     staticSlilLowerBound_ = spillCostLwrBound;
+    CmputSlilIntrvlRegs_();
   }
   return spillCostLwrBound;
 }
+/*****************************************************************************/
+
+// Calls f on each instruction in the live interval of reg and on each
+// instruction in its possible live interval that is not in the live interval.
+template <typename Func>
+static void ForEachIntrvlInst(const Register *reg, Func f) {
+  for (const SchedInstruction *inst : reg->GetLiveInterval())
+    f(inst);
+  for (const SchedInstruction *inst : reg->GetPossibleLiveInterval())
+    if (!reg->IsInInterval(inst))
+      f(inst);
+}
+
+void BBWithSpill::CmputSlilIntrvlRegs_() {
+  InstCount instCnt = dataDepGraph_->GetInstCnt();
+  slilIntrvlBgn_.assign(instCnt * regTypeCnt_ + 1, 0);
+  slilIntrvlRegs_.clear();
+
+  // Count the registers of each instruction and type, then turn the counts
+  // into the start of each entry and fill the entries in.
+  for (int16_t i = 0; i < regTypeCnt_; i++)
+    for (int j = 0; j < regFiles_[i].GetRegCnt(); j++)
+      ForEachIntrvlInst(regFiles_[i].GetReg(j),
+                        [&](const SchedInstruction *in) {
+                          slilIntrvlBgn_[in->GetNum() * regTypeCnt_ + i + 1]++;
+                        });
+
+  for (size_t k = 1; k < slilIntrvlBgn_.size(); k++)
+    slilIntrvlBgn_[k] += slilIntrvlBgn_[k - 1];
+  slilIntrvlRegs_.resize(slilIntrvlBgn_.back());
+
+  std::vector<int> nxt(slilIntrvlBgn_.begin(), slilIntrvlBgn_.end() - 1);
+  for (int16_t i = 0; i < regTypeCnt_; i++)
+    for (int j = 0; j < regFiles_[i].GetRegCnt(); j++)
+      ForEachIntrvlInst(regFiles_[i].GetReg(j),
+                        [&](const SchedInstruction *in) {
+                          int entry = in->GetNum() * regTypeCnt_ + i;
+                          slilIntrvlRegs_[nxt[entry]++] = j;
+                        });
+}
+/*****************************************************************************/
+
+int BBWithSpill::CntLiveRegsOutsideIntrvls_(const SchedInstruction *inst,
+                                            int16_t regType) const {
+  int liveCnt = liveRegs_[regType].GetOneCnt();
+  // No intervals were computed, so none of the live registers is in one.
+  if (slilIntrvlBgn_.empty())
+    return liveCnt;
+
+  int entry = inst->GetNum() * regTypeCnt_ + regType;
+  for (int k = slilIntrvlBgn_[entry]; k < slilIntrvlBgn_[entry + 1]; k++)
+    if (liveRegs_[regType].GetBit(slilIntrvlRegs_[k]))
+      liveCnt--;
+  return liveCnt;
+}
 
 /*****************************************************************************/
 
@@ -354,6 +414,31 @@ InstCount BBWithSpill::getUnnormalizedIncrementalRPCost() const {
 }
 /*****************************************************************************/
 
+InstCount BBWithSpill::CmputPartialSpillCostLwrBound_() {
+  switch (GetSpillCostFunc()) {
+  case SCF_SLIL:
+    return dynamicSlilLowerBound_;
+  case SCF_SPILLS:
+    // Only known once the complete schedule is register allocated.
+    return 0;
+  default:
+    // The other cost functions only grow as instructions are scheduled.
+    return crntSpillCost_;
+  }
+}
+/*****************************************************************************/
+
+InstCount BBWithSpill::getPartialCostLwrBound(InstCount lngthLwrBound) {
+  return CmputPartialSpillCostLwrBound_() * SCW_ +
+         lngthLwrBound * schedCostFactor_ - GetCostLwrBound();
+}
+/*****************************************************************************/
+
+InstCount BBWithSpill::getPartialNormSpillCostLwrBound() {
+  return CmputPartialSpillCostLwrBound_() * SCW_ - GetRPCostLwrBound();
+}
+/*****************************************************************************/
+
 void BBWithSpill::InitForSchdulng() {
   InitForCostCmputtn_();
 
@@ -573,14 +658,7 @@ void BBWithSpill::UpdateSpillInfoForSchdul_(SchedInstruction *inst,
     // (Chris): Compute sum of live range lengths at this point
     if (needsSLIL()) {
       sumOfLiveIntervalLengths_[i] += liveRegs_[i].GetOneCnt();
-      for (int j = 0; j < liveRegs_[i].GetSize(); ++j) {
-        if (liveRegs_[i].GetBit(j)) {
-          const Register *reg = regFiles_[i].GetReg(j);
-          if (!reg->IsInInterval(inst) && !reg->IsInPossibleInterval(inst)) {
-            ++dynamicSlilLowerBound_;
-          }
-        }
-      }
+      dynamicSlilLowerBound_ += CntLiveRegsOutsideIntrvls_(inst, i);
     }
   }
 
@@ -634,15 +712,8 @@ void BBWithSpill::UpdateSpillInfoForUnSchdul_(SchedInstruction *inst) {
   // (Chris): Update the SLIL for all live regs at this point.
   if (needsSLIL()) {
     for (int i = 0; i < regTypeCnt_; ++i) {
-      for (int j = 0; j < liveRegs_[i].GetSize(); ++j) {
-        if (liveRegs_[i].GetBit(j)) {
-          const Register *reg = regFiles_[i].GetReg(j);
-          sumOfLiveIntervalLengths_[i]--;
-          if (!reg->IsInInterval(inst) && !reg->IsInPossibleInterval(inst)) {
-            --dynamicSlilLowerBound_;
-          }
-        }
-      }
+      sumOfLiveIntervalLengths_[i] -= liveRegs_[i].GetOneCnt();
+      dynamicSlilLowerBound_ -= CntLiveRegsOutsideIntrvls_(inst, i);
       assert(sumOfLiveIntervalLengths_[i] >= 0 &&
              "UpdateSpillInfoForUnSchdul_: SLIL negative!");
     }
@@ -806,12 +877,18 @@ FUNC_RESULT BBWithSpill::Enumerate_(Milliseconds startTime,
       (rgnTimeout == INVALID_VALUE) ? INVALID_VALUE : startTime + lngthTimeout;
   assert(lngthDeadline <= rgnDeadline);
 
+  bool isPrll = prllWrkrCnt_ > 0 && mkPrllWrkr_ && !isTwoPassEnabled() &&
+                SetupPrllWrkrs_(lngthTimeout);
+
   for (trgtLngth = schedLwrBound_; trgtLngth <= schedUprBound_; trgtLngth++) {
     InitForSchdulng();
     Logger::Event("Enumerating", "target_length", trgtLngth);
 
-    rslt = enumrtr_->FindFeasibleSchedule(enumCrntSched_, trgtLngth, this,
-                                          costLwrBound, lngthDeadline);
+    if (isPrll)
+      rslt = EnumeratePrll_(trgtLngth, costLwrBound, lngthDeadline);
+    else
+      rslt = enumrtr_->FindFeasibleSchedule(enumCrntSched_, trgtLngth, this,
+                                            costLwrBound, lngthDeadline);
     if (rslt == RES_TIMEOUT)
       timeout = true;
     HandlEnumrtrRslt_(rslt, trgtLngth);
@@ -853,6 +930,8 @@ FUNC_RESULT BBWithSpill::Enumerate_(Milliseconds startTime,
   stats::lengths.Record(iterCnt);
 #endif
 
+  FreePrllWrkrs_();
+
   // Failure to find a feasible sched. in the last iteration is still
   // considered an overall success
   if (rslt == RES_SUCCESS || rslt == RES_FAIL) {
@@ -865,6 +944,211 @@ FUNC_RESULT BBWithSpill::Enumerate_(Milliseconds startTime,
 }
 /*****************************************************************************/
 
+void BBWithSpill::setParallelWorkerFactory(
+    std::function<ParallelEnumWorker()> mkWrkr) {
+  mkPrllWrkr_ = std::move(mkWrkr);
+}
+/*****************************************************************************/
+
+void BBWithSpill::setParallelEnum(int wrkrCnt, InstCount splitDepth) {
+  prllWrkrCnt_ = wrkrCnt;
+  prllSplitDepth_ = splitDepth;
+}
+/*****************************************************************************/
+
+void BBWithSpill::setParallelAco(int wrkrCnt) { acoWrkrCnt_ = wrkrCnt; }
+/*****************************************************************************/
+
+bool BBWithSpill::SetupPrllWrkrs_(Milliseconds lngthTimeout) {
+  // The workers are set up on this thread, since setting up an enumerator
+  // draws from the global random number generator.
+  for (int i = 0; i < prllWrkrCnt_; i++) {
+    prllWrkrs_.push_back(mkPrllWrkr_());
+    BBWithSpill *wrkr = prllWrkrs_.back().Rgn.get();
+
+    if (!wrkr->SetupParallelWorker_(this, lngthTimeout)) {
+      Logger::Info("Failed to set up parallel enumeration. Enumerating "
+                   "serially.");
+      FreePrllWrkrs_();
+      return false;
+    }
+
+    wrkr->optmlSpillCost_ = optmlSpillCost_;
+  }
+
+  return true;
+}
+/*****************************************************************************/
+
+void BBWithSpill::FreePrllWrkrs_() {
+  for (ParallelEnumWorker &wrkr : prllWrkrs_) {
+    delete wrkr.Rgn->enumCrntSched_;
+    delete wrkr.Rgn->enumBestSched_;
+  }
+
+  prllWrkrs_.clear();
+}
+/*****************************************************************************/
+
+std::vector<SchedRegion *> BBWithSpill::SetupAcoWrkrs_() {
+  std::vector<SchedRegion *> rgns;
+  if (acoWrkrCnt_ <= 0 || !mkPrllWrkr_ || isTwoPassEnabled())
+    return rgns;
+
+  // As with the enumeration workers, these are set up on this thread.
+  for (int i = 0; i < acoWrkrCnt_; i++) {
+    acoWrkrs_.emplace_back();
+    if (!SetupAcoWrkr_(acoWrkrs_.back())) {
+      Logger::Info("Failed to set up parallel ACO. Running ACO serially.");
+      FreeAcoWrkrs_();
+      return {};
+    }
+
+    rgns.push_back(acoWrkrs_.back().Rgn.get());
+  }
+
+  return rgns;
+}
+/*****************************************************************************/
+
+void BBWithSpill::FreeAcoWrkrs_() { acoWrkrs_.clear(); }
+/*****************************************************************************/
+
+SchedRegion *BBWithSpill::SetupPipelinedAcoWrkr_() {
+  if (!mkPrllWrkr_ || isTwoPassEnabled())
+    return NULL;
+
+  if (!SetupAcoWrkr_(pipelinedAcoWrkr_)) {
+    FreePipelinedAcoWrkr_();
+    return NULL;
+  }
+
+  return pipelinedAcoWrkr_.Rgn.get();
+}
+/*****************************************************************************/
+
+void BBWithSpill::FreePipelinedAcoWrkr_() {
+  // The region refers to the DAG, so it goes first.
+  pipelinedAcoWrkr_.Rgn.reset();
+  pipelinedAcoWrkr_.DDG.reset();
+}
+/*****************************************************************************/
+
+bool BBWithSpill::SetupAcoWrkr_(ParallelEnumWorker &wrkr) {
+  wrkr = mkPrllWrkr_();
+  BBWithSpill *rgn = wrkr.Rgn.get();
+  if (!rgn->SetupWorkerRgn_(this, false))
+    return false;
+
+  rgn->recordedCostFunctions = recordedCostFunctions;
+  rgn->NeedsComputeSLIL = NeedsComputeSLIL;
+  return true;
+}
+/*****************************************************************************/
+
+FUNC_RESULT BBWithSpill::EnumeratePrll_(InstCount trgtLngth, int costLwrBound,
+                                        Milliseconds lngthDeadline) {
+  // The threads also see the costs found by a pipelined ACO, if one is running.
+  SharedIncumbent *outerIncumbent = getSharedBestCost();
+  ParallelEnumContext cntxt(GetBestCost(), prllSplitDepth_, outerIncumbent);
+  std::vector<BBWithSpill *> rgns;
+  rgns.push_back(this);
+  for (ParallelEnumWorker &wrkr : prllWrkrs_)
+    rgns.push_back(wrkr.Rgn.get());
+
+  // This thread's enumerator is attached first, since it provides the shared
+  // history table. The global statistics are not thread-safe, so only this
+  // thread records them.
+  for (size_t i = 0; i < rgns.size(); i++) {
+    rgns[i]->setSharedBestCost(&cntxt.Incumbent);
+    rgns[i]->enumrtr_->SetParallelContext(&cntxt, i == 0);
+  }
+
+  // This thread first expands the tree down to the split depth, collecting
+  // the subtrees there. Schedules shorter than the split depth are found
+  // during the expansion.
+  std::vector<FUNC_RESULT> rslts(rgns.size(), RES_FAIL);
+  rslts[0] = enumrtr_->FindFeasibleSchedule(enumCrntSched_, trgtLngth, this,
+                                            costLwrBound, lngthDeadline);
+
+  // Then all the threads search the subtrees, taking the next one as soon as
+  // they are done with the last.
+  auto enumerate = [&](size_t i) {
+    BBWithSpill *rgn = rgns[i];
+    SubProblemPool::Prefix subProb;
+    while (cntxt.SubProblems.take(subProb)) {
+      rgn->enumrtr_->ResetForSubProb();
+      rgn->enumCrntSched_->Reset();
+      rgn->InitForSchdulng();
+      rgn->enumrtr_->SetSubProb(&subProb);
+      FUNC_RESULT rslt = rgn->enumrtr_->FindFeasibleSchedule(
+          rgn->enumCrntSched_, trgtLngth, rgn, costLwrBound, lngthDeadline);
+      rgn->enumrtr_->SetSubProb(NULL);
+
+      if (rslt == RES_SUCCESS && rslts[i] == RES_FAIL)
+        rslts[i] = rslt;
+      if (rslt == RES_TIMEOUT || rslt == RES_ERROR) {
+        rslts[i] = rslt;
+        break;
+      }
+    }
+  };
+
+  if (rslts[0] != RES_TIMEOUT && rslts[0] != RES_ERROR) {
+    std::vector<std::thread> thrds;
+    for (size_t i = 1; i < rgns.size(); i++)
+      thrds.emplace_back(enumerate, i);
+    enumerate(0);
+    for (std::thread &thrd : thrds)
+      thrd.join();
+  }
+
+  for (BBWithSpill *rgn : rgns) {
+    rgn->setSharedBestCost(rgn == this ? outerIncumbent : NULL);
+    rgn->enumrtr_->SetParallelContext(NULL, rgn == this);
+  }
+
+  // Take the best schedule found by any of the threads, then let all the
+  // threads start the next length from it.
+  for (size_t i = 1; i < rgns.size(); i++) {
+    BBWithSpill *wrkr = rgns[i];
+    if (wrkr->GetBestCost() < GetBestCost()) {
+      SetBestCost(wrkr->GetBestCost());
+      SetBestSchedLength(wrkr->getBestSchedLength());
+      optmlSpillCost_ = wrkr->optmlSpillCost_;
+      enumBestSched_->Copy(wrkr->enumBestSched_);
+      bestSched_ = enumBestSched_;
+    }
+  }
+
+  for (size_t i = 1; i < rgns.size(); i++) {
+    BBWithSpill *wrkr = rgns[i];
+    wrkr->SetBestCost(GetBestCost());
+    wrkr->SetBestSchedLength(getBestSchedLength());
+    wrkr->optmlSpillCost_ = optmlSpillCost_;
+    wrkr->enumrtr_->Reset();
+    wrkr->enumCrntSched_->Reset();
+  }
+
+  Logger::Event("ParallelEnumeration", "target_length", trgtLngth, //
+                "threads", rgns.size(),                           //
+                "subproblems", cntxt.SubProblems.getSubProbCnt());
+
+  bool timeout = false;
+  bool success = false;
+  for (FUNC_RESULT rslt : rslts) {
+    if (rslt == RES_ERROR)
+      return RES_ERROR;
+    timeout |= rslt == RES_TIMEOUT;
+    success |= rslt == RES_SUCCESS;
+  }
+
+  if (timeout)
+    return RES_TIMEOUT;
+  return success ? RES_SUCCESS : RES_FAIL;
+}
+/*****************************************************************************/
+
 InstCount BBWithSpill::CmputCostForFunction(SPILL_COST_FUNCTION SpillCF) {
   // return the requested cost
   switch (SpillCF) {
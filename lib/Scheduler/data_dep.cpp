@@ -496,6 +496,7 @@ void DataDepGraph::AllocArrays_(InstCount instCnt) {
   nodeCnt_ = instCnt;
   insts_ = new SchedInstruction *[instCnt_];
   nodes_ = (GraphNode **)insts_;
+  instStore_.Resize(instCnt_);
 
   for (i = 0; i < instCnt_; i++) {
     insts_[i] = NULL;
@@ -828,12 +829,13 @@ SchedInstruction *DataDepGraph::CreateNode_(
     const char *const opCode, int nodeID, InstCount fileSchedOrder,
     InstCount fileSchedCycle, InstCount fileLB, InstCount fileUB, int blkNum) {
 
-  SchedInstruction *newInstPtr;
-  newInstPtr = new SchedInstruction(instNum, instName, instType, opCode,
-                                    2 * instCnt_, nodeID, fileSchedOrder,
-                                    fileSchedCycle, fileLB, fileUB, machMdl_);
   if (instNum < 0 || instNum >= instCnt_)
     llvm::report_fatal_error("Invalid instruction number", false);
+
+  SchedInstruction *newInstPtr;
+  newInstPtr = new SchedInstruction(
+      instNum, instName, instType, opCode, 2 * instCnt_, nodeID, fileSchedOrder,
+      fileSchedCycle, fileLB, fileUB, machMdl_, &instStore_);
   //  Logger::Info("Instruction order = %d, instCnt_ = %d", fileSchedOrder,
   //  instCnt_);
   if (fileSchedOrder > maxFileSchedOrder_)
@@ -1143,16 +1145,18 @@ void DataDepGraph::CmputRltvCrtclPaths_(DIRECTION dir) {
 }
 
 void DataDepGraph::CmputCrtclPathsFrmRcrsvPrdcsr_(SchedInstruction *ref) {
-  LinkedList<GraphNode> *rcrsvScsrLst = ref->GetRcrsvNghbrLst(DIR_FRWRD);
+  BitVector *isRcrsvScsr = ref->GetRcrsvNghbrBitVector(DIR_FRWRD);
   SchedInstruction *inst = GetLeafInst();
-  GraphNode *node;
 
-  assert(rcrsvScsrLst != NULL);
+  assert(isRcrsvScsr != NULL);
 
-  // Visit the nodes in reverse topological order
-  for (node = rcrsvScsrLst->GetLastElmnt(); node != NULL;
-       node = rcrsvScsrLst->GetPrevElmnt()) {
-    inst = (SchedInstruction *)node;
+  // Visit the recursive successors in topological order, which only follow
+  // the reference in it.
+  for (InstCount i = ref->GetTplgclOrdr() + 1; i < instCnt_; i++) {
+    SchedInstruction *scsr = GetInstByTplgclOrdr(i);
+    if (!isRcrsvScsr->GetBit(scsr->GetNum()))
+      continue;
+    inst = scsr;
     inst->CmputCrtclPathFrmRcrsvPrdcsr(ref);
   }
 
@@ -1165,16 +1169,18 @@ void DataDepGraph::CmputCrtclPathsFrmRcrsvPrdcsr_(SchedInstruction *ref) {
 }
 
 void DataDepGraph::CmputCrtclPathsFrmRcrsvScsr_(SchedInstruction *ref) {
-  LinkedList<GraphNode> *rcrsvPrdcsrLst = ref->GetRcrsvNghbrLst(DIR_BKWRD);
+  BitVector *isRcrsvPrdcsr = ref->GetRcrsvNghbrBitVector(DIR_BKWRD);
   SchedInstruction *inst = GetRootInst();
-  GraphNode *node;
 
-  assert(rcrsvPrdcsrLst != NULL);
+  assert(isRcrsvPrdcsr != NULL);
 
-  // Visit the nodes in reverse topological order
-  for (node = rcrsvPrdcsrLst->GetLastElmnt(); node != NULL;
-       node = rcrsvPrdcsrLst->GetPrevElmnt()) {
-    inst = (SchedInstruction *)node;
+  // Visit the recursive predecessors in reverse topological order, which only
+  // precede the reference in it.
+  for (InstCount i = ref->GetTplgclOrdr() - 1; i >= 0; i--) {
+    SchedInstruction *prdcsr = GetInstByTplgclOrdr(i);
+    if (!isRcrsvPrdcsr->GetBit(prdcsr->GetNum()))
+      continue;
+    inst = prdcsr;
     inst->CmputCrtclPathFrmRcrsvScsr(ref);
   }
 
@@ -1981,6 +1987,11 @@ void DataDepSubGraph::AllocRlxdSchdulr_(LB_ALG lbAlg,
     rvrsRlxdSchdulr = RJRvrsRlxdSchdulr_;
     break;
   case LBA_LC:
+    // The LC relaxed schedulers of a subgraph visit the recursive neighbors
+    // of the full graph's instructions in topological order, so the lists of
+    // those must be built before any thread reads them.
+    fullGraph_->BldRcrsvNghbrLsts(DIR_FRWRD);
+    fullGraph_->BldRcrsvNghbrLsts(DIR_BKWRD);
     // if(LCRlxdSchdulr_==NULL)
     LCRlxdSchdulr_ =
         new LC_RelaxedScheduler(this, machMdl_, schedUprBound_, DIR_FRWRD);
@@ -3220,10 +3231,9 @@ bool DataDepGraph::DoesFeedUser(SchedInstruction *inst) {
 #ifdef IS_DEBUG_RP_ONLY
   Logger::Info("Testing inst %d", inst->GetNum());
 #endif
-  LinkedList<GraphNode> *rcrsvSuccs = inst->GetRcrsvNghbrLst(DIR_FRWRD);
-  for (GraphNode *succ = rcrsvSuccs->GetFrstElmnt(); succ != NULL;
-       succ = rcrsvSuccs->GetNxtElmnt()) {
-    SchedInstruction *succInst = static_cast<SchedInstruction *>(succ);
+  BitVector *rcrsvSuccs = inst->GetRcrsvNghbrBitVector(DIR_FRWRD);
+  for (int succNum : rcrsvSuccs->GetSetBits()) {
+    SchedInstruction *succInst = GetInstByIndx(succNum);
 
     int curInstAdjUseCnt = succInst->GetAdjustedUseCnt();
     // Ignore successor instructions that does not close live intervals
@@ -1,5 +1,6 @@
 #include "opt-sched/Scheduler/enumerator.h"
 #include "opt-sched/Scheduler/bb_spill.h"
+#include "opt-sched/Scheduler/config.h"
 #include "opt-sched/Scheduler/hist_table.h"
 #include "opt-sched/Scheduler/logger.h"
 #include "opt-sched/Scheduler/random.h"
@@ -7,7 +8,9 @@
 #include "opt-sched/Scheduler/utilities.h"
 #include "llvm/Support/ErrorHandling.h"
 #include <algorithm>
+#include <chrono>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <sstream>
 
@@ -26,9 +29,6 @@ EnumTreeNode::~EnumTreeNode() {
   assert(isCnstrctd_ || rdyLst_ == NULL);
 
   if (isCnstrctd_) {
-    assert(frwrdLwrBounds_ != NULL);
-    delete[] frwrdLwrBounds_;
-
     assert(exmndInsts_ != NULL);
     for (ExaminedInst *exmndInst = exmndInsts_->GetFrstElmnt();
          exmndInst != NULL; exmndInst = exmndInsts_->GetNxtElmnt()) {
@@ -40,10 +40,7 @@ EnumTreeNode::~EnumTreeNode() {
     assert(chldrn_ != NULL);
     delete chldrn_;
 
-    if (rdyLst_ != NULL)
-      delete rdyLst_;
-    if (rsrvSlots_ != NULL)
-      delete[] rsrvSlots_;
+    delete[] rsrvSlotsBuf_;
   } else {
     assert(isClean_);
   }
@@ -67,6 +64,7 @@ void EnumTreeNode::Init_() {
   cost_ = INVALID_VALUE;
   costLwrBound_ = INVALID_VALUE;
   crntCycleBlkd_ = false;
+  trailMark_ = 0;
   rsrvSlots_ = NULL;
   totalCostIsActualCost_ = false;
   totalCost_ = -1;
@@ -94,7 +92,7 @@ void EnumTreeNode::Construct(EnumTreeNode *prevNode, SchedInstruction *inst,
   if (isCnstrctd_ == false) {
     exmndInsts_ = new LinkedList<ExaminedInst>(instCnt);
     chldrn_ = new LinkedList<HistEnumTreeNode>(instCnt);
-    frwrdLwrBounds_ = new InstCount[instCnt];
+    rsrvSlotsBuf_ = new ReserveSlot[enumrtr_->issuRate_];
   }
 
   if (enumrtr_->IsHistDom()) {
@@ -113,14 +111,10 @@ void EnumTreeNode::Construct(EnumTreeNode *prevNode, SchedInstruction *inst,
 void EnumTreeNode::Reset() {
   assert(isCnstrctd_);
 
-  if (rdyLst_ != NULL) {
-    rdyLst_->Reset();
-  }
-
   if (exmndInsts_ != NULL) {
     for (ExaminedInst *exmndInst = exmndInsts_->GetFrstElmnt();
          exmndInst != NULL; exmndInst = exmndInsts_->GetNxtElmnt()) {
-      delete exmndInst;
+      enumrtr_->nodeAlctr_->FreeExmndInst(exmndInst);
     }
     exmndInsts_->Reset();
   }
@@ -137,15 +131,10 @@ void EnumTreeNode::Clean() {
   assert(isCnstrctd_);
   Reset();
 
-  if (rdyLst_ != NULL) {
-    delete rdyLst_;
-    rdyLst_ = NULL;
-  }
-
-  if (rsrvSlots_ != NULL) {
-    delete[] rsrvSlots_;
-    rsrvSlots_ = NULL;
-  }
+  // The ready list and the reserved slots are owned by the enumerator and by
+  // the node itself respectively, and are reused.
+  rdyLst_ = NULL;
+  rsrvSlots_ = NULL;
 
   isClean_ = true;
 }
@@ -168,18 +157,6 @@ void EnumTreeNode::FormPrtilSchedSig_() {
 }
 /*****************************************************************************/
 
-void EnumTreeNode::SetLwrBounds() { SetLwrBounds(DIR_FRWRD); }
-/*****************************************************************************/
-
-void EnumTreeNode::SetLwrBounds(DIRECTION dir) {
-  assert(dir == DIR_FRWRD);
-  InstCount *&nodeLwrBounds = frwrdLwrBounds_;
-  assert(nodeLwrBounds != NULL);
-  DataDepGraph *dataDepGraph = enumrtr_->dataDepGraph_;
-  dataDepGraph->GetCrntLwrBounds(dir, nodeLwrBounds);
-}
-/*****************************************************************************/
-
 void EnumTreeNode::SetRsrvSlots(int16_t rsrvSlotCnt, ReserveSlot *rsrvSlots) {
   assert(rsrvSlots_ == NULL);
   rsrvSlots_ = NULL;
@@ -190,7 +167,7 @@ void EnumTreeNode::SetRsrvSlots(int16_t rsrvSlotCnt, ReserveSlot *rsrvSlots) {
 
   int issuRate = enumrtr_->machMdl_->GetIssueRate();
 
-  rsrvSlots_ = new ReserveSlot[issuRate];
+  rsrvSlots_ = rsrvSlotsBuf_;
 
   for (int i = 0; i < issuRate; i++) {
     rsrvSlots_[i].strtCycle = rsrvSlots[i].strtCycle;
@@ -250,9 +227,8 @@ void EnumTreeNode::NewBranchExmnd(SchedInstruction *inst, bool isLegal,
 
       if (enumrtr_->prune_.nodeSup) {
         if (!isNodeDmntd) {
-          ExaminedInst *exmndInst;
-          exmndInst =
-              new ExaminedInst(inst, wasRlxInfsbl, enumrtr_->dirctTightndLst_);
+          ExaminedInst *exmndInst =
+              enumrtr_->nodeAlctr_->AllocExmndInst(inst, wasRlxInfsbl);
           exmndInsts_->InsrtElmnt(exmndInst);
         }
       }
@@ -411,9 +387,16 @@ void EnumTreeNode::Archive() {
 EnumTreeNode::ExaminedInst::ExaminedInst(SchedInstruction *inst,
                                          bool wasRlxInfsbl,
                                          LinkedList<SchedInstruction> *) {
+  tightndScsrs_ = NULL;
+  Construct(inst, wasRlxInfsbl);
+}
+/****************************************************************************/
+
+void EnumTreeNode::ExaminedInst::Construct(SchedInstruction *inst,
+                                           bool wasRlxInfsbl) {
+  assert(tightndScsrs_ == NULL);
   inst_ = inst;
   wasRlxInfsbl_ = wasRlxInfsbl;
-  tightndScsrs_ = NULL;
 }
 /****************************************************************************/
 
@@ -432,6 +415,142 @@ EnumTreeNode::ExaminedInst::~ExaminedInst() {
 /****************************************************************************/
 /****************************************************************************/
 
+static uint64_t
+GetElapsedNs(std::chrono::high_resolution_clock::time_point strt) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::high_resolution_clock::now() - strt)
+      .count();
+}
+/****************************************************************************/
+
+static HIST_EVICTION ParseHistEvctnPlcy(const std::string &plcy) {
+  if (plcy == "LEAST_RECENTLY_MATCHED")
+    return HE_LEAST_RECENTLY_MATCHED;
+  else if (plcy == "SHALLOWEST")
+    return HE_SHALLOWEST;
+
+  llvm::report_fatal_error("Unrecognized history eviction policy: " + plcy,
+                           false);
+}
+/****************************************************************************/
+
+FrwrdLwrBoundIndex::FrwrdLwrBoundIndex() {
+  dataDepGraph_ = NULL;
+  instStore_ = NULL;
+  issuTypeCnt_ = 0;
+  bktCnt_ = 0;
+}
+/****************************************************************************/
+
+void FrwrdLwrBoundIndex::Construct(DataDepGraph *dataDepGraph,
+                                   int16_t issuTypeCnt, InstCount bktCnt) {
+  assert(bktCnt > 0);
+  dataDepGraph_ = dataDepGraph;
+  instStore_ = dataDepGraph->GetInstStore();
+  issuTypeCnt_ = issuTypeCnt;
+  bktCnt_ = bktCnt;
+  bktHeads_.assign(issuTypeCnt_ * bktCnt_, INVALID_VALUE);
+  minBkts_.assign(issuTypeCnt_, bktCnt_);
+  InstCount instCnt = dataDepGraph_->GetInstCnt();
+  instBkts_.assign(instCnt, INVALID_VALUE);
+  nxtInsts_.assign(instCnt, INVALID_VALUE);
+  prevInsts_.assign(instCnt, INVALID_VALUE);
+}
+/****************************************************************************/
+
+void FrwrdLwrBoundIndex::Build() {
+  std::fill(bktHeads_.begin(), bktHeads_.end(), INVALID_VALUE);
+  std::fill(minBkts_.begin(), minBkts_.end(), bktCnt_);
+  std::fill(instBkts_.begin(), instBkts_.end(), INVALID_VALUE);
+
+  // Insert in reverse order, so that each bucket lists its instructions by
+  // number.
+  const std::vector<InstCount> &schedCycles = instStore_->schedCycles;
+  for (InstCount i = dataDepGraph_->GetInstCnt() - 1; i >= 0; i--) {
+    if (schedCycles[i] == SCHD_UNSCHDULD)
+      Link_(i, GetBkt_(i));
+  }
+}
+/****************************************************************************/
+
+InstCount FrwrdLwrBoundIndex::GetBkt_(InstCount instNum) const {
+  InstCount lwrBound =
+      std::min(instStore_->crntFrwrdLwrBounds[instNum], bktCnt_ - 1);
+  assert(lwrBound >= 0);
+  return instStore_->issuTypes[instNum] * bktCnt_ + lwrBound;
+}
+/****************************************************************************/
+
+void FrwrdLwrBoundIndex::Link_(InstCount instNum, InstCount bkt) {
+  InstCount head = bktHeads_[bkt];
+  instBkts_[instNum] = bkt;
+  prevInsts_[instNum] = INVALID_VALUE;
+  nxtInsts_[instNum] = head;
+  if (head != INVALID_VALUE)
+    prevInsts_[head] = instNum;
+  bktHeads_[bkt] = instNum;
+
+  InstCount &minBkt = minBkts_[bkt / bktCnt_];
+  minBkt = std::min(minBkt, bkt % bktCnt_);
+}
+/****************************************************************************/
+
+void FrwrdLwrBoundIndex::Unlink_(InstCount instNum) {
+  InstCount prev = prevInsts_[instNum];
+  InstCount nxt = nxtInsts_[instNum];
+  if (prev == INVALID_VALUE)
+    bktHeads_[instBkts_[instNum]] = nxt;
+  else
+    nxtInsts_[prev] = nxt;
+  if (nxt != INVALID_VALUE)
+    prevInsts_[nxt] = prev;
+  instBkts_[instNum] = INVALID_VALUE;
+}
+/****************************************************************************/
+
+void FrwrdLwrBoundIndex::Insert(SchedInstruction *inst) {
+  InstCount instNum = inst->GetNum();
+  assert(instBkts_[instNum] == INVALID_VALUE);
+  Link_(instNum, GetBkt_(instNum));
+}
+/****************************************************************************/
+
+void FrwrdLwrBoundIndex::Remove(SchedInstruction *inst) {
+  assert(instBkts_[inst->GetNum()] != INVALID_VALUE);
+  Unlink_(inst->GetNum());
+}
+/****************************************************************************/
+
+void FrwrdLwrBoundIndex::Update(SchedInstruction *inst) {
+  InstCount instNum = inst->GetNum();
+  if (instBkts_[instNum] == INVALID_VALUE)
+    return;
+
+  InstCount bkt = GetBkt_(instNum);
+  if (bkt != instBkts_[instNum]) {
+    Unlink_(instNum);
+    Link_(instNum, bkt);
+  }
+}
+/****************************************************************************/
+
+void FrwrdLwrBoundIndex::GetInstsBelow(IssueType issuType, InstCount cycle,
+                                       std::vector<SchedInstruction *> &insts) {
+  InstCount frstBkt = issuType * bktCnt_;
+  InstCount &minBkt = minBkts_[issuType];
+
+  while (minBkt < bktCnt_ && bktHeads_[frstBkt + minBkt] == INVALID_VALUE)
+    minBkt++;
+
+  for (InstCount bkt = minBkt; bkt < std::min(cycle, bktCnt_); bkt++) {
+    for (InstCount instNum = bktHeads_[frstBkt + bkt]; instNum != INVALID_VALUE;
+         instNum = nxtInsts_[instNum]) {
+      insts.push_back(dataDepGraph_->GetInstByIndx(instNum));
+    }
+  }
+}
+/****************************************************************************/
+
 Enumerator::Enumerator(DataDepGraph *dataDepGraph, MachineModel *machMdl,
                        InstCount schedUprBound, int16_t sigHashSize,
                        SchedPriorities prirts, Pruning PruningStrategy,
@@ -476,22 +595,49 @@ Enumerator::Enumerator(DataDepGraph *dataDepGraph, MachineModel *machMdl,
   createdNodeCnt_ = 0;
   exmndNodeCnt_ = 0;
   fxdInstCnt_ = 0;
-  minUnschduldTplgclOrdr_ = 0;
   backTrackCnt_ = 0;
   fsblSchedCnt_ = 0;
   imprvmntCnt_ = 0;
   prevTrgtLngth_ = INVALID_VALUE;
   rgn_ = NULL;
 
-  int16_t sigSize = 8 * sizeof(InstSignature) - 1;
+  Config &schedIni = SchedulerOptions::getInstance();
+  histSigBits_ = (int16_t)schedIni.GetInt("HIST_SIGNATURE_BITS", 64);
+  if (histSigBits_ < sigHashSize ||
+      histSigBits_ > (int16_t)(8 * sizeof(InstSignature)))
+    llvm::report_fatal_error("HIST_SIGNATURE_BITS must be at least "
+                             "HIST_TABLE_HASH_BITS and at most 64",
+                             false);
 
   Milliseconds histTableInitTime = Utilities::GetProcessorTime();
 
   exmndSubProbs_ = NULL;
+  ownExmndSubProbs_ = NULL;
+  evctdSigs_ = NULL;
+
+  histMaxBytes_ = (uint64_t)schedIni.GetInt("HIST_TABLE_MAX_MB", 0) << 20;
+  histEvctnPlcy_ = ParseHistEvctnPlcy(
+      schedIni.GetString("HIST_TABLE_EVICTION", "LEAST_RECENTLY_MATCHED"));
+  histBytes_ = 0;
+  peakHistBytes_ = 0;
+  evctdHistCnt_ = 0;
+  rjctdHistCnt_ = 0;
+  lostHistDmntnCnt_ = 0;
+  histSigTestCnt_ = 0;
+  histSigAliasCnt_ = 0;
+  histDmntnChkTime_ = 0;
+  rlxdChkCnt_ = 0;
+  rlxdChkTime_ = 0;
+  rlxdSchdulr_->SetIncrmntl(
+      schedIni.GetBool("RELAXED_PRUNING_INCREMENTAL", true));
 
   if (IsHistDom()) {
-    exmndSubProbs_ =
-        new BinHashTable<HistEnumTreeNode>(sigSize, sigHashSize, true);
+    ownExmndSubProbs_ =
+        new ShardedBinHashTable<HistEnumTreeNode>(histSigBits_, sigHashSize);
+    exmndSubProbs_ = ownExmndSubProbs_;
+
+    if (histMaxBytes_ != 0)
+      evctdSigs_ = new BitVector(1 << sigHashSize);
   }
 
   histTableInitTime = Utilities::GetProcessorTime() - histTableInitTime;
@@ -506,7 +652,8 @@ Enumerator::Enumerator(DataDepGraph *dataDepGraph, MachineModel *machMdl,
   fxdLst_ = new LinkedList<SchedInstruction>(totInstCnt_);
   dirctTightndLst_ = new LinkedList<SchedInstruction>(totInstCnt_);
   bkwrdTightndLst_ = new LinkedList<SchedInstruction>(totInstCnt_);
-  tmpLwrBounds_ = new InstCount[totInstCnt_];
+  lwrBoundIndx_.Construct(dataDepGraph_, issuTypeCnt_, schedUprBound_ + 1);
+  tightnCands_.reserve(totInstCnt_);
 
   SetInstSigs_();
   iterNum_ = 0;
@@ -518,7 +665,8 @@ Enumerator::Enumerator(DataDepGraph *dataDepGraph, MachineModel *machMdl,
 /****************************************************************************/
 
 Enumerator::~Enumerator() {
-  delete exmndSubProbs_;
+  delete ownExmndSubProbs_;
+  delete evctdSigs_;
 
   for (InstCount i = 0; i < schedUprBound_; i++) {
     if (frstRdyLstPerCycle_[i] != NULL) {
@@ -531,7 +679,6 @@ Enumerator::~Enumerator() {
   delete dirctTightndLst_;
   delete fxdLst_;
   delete bkwrdTightndLst_;
-  delete[] tmpLwrBounds_;
   tmpHstryNode_->Clean();
   delete tmpHstryNode_;
 }
@@ -543,16 +690,27 @@ void Enumerator::SetupAllocators_() {
   int maxNodeCnt = issuRate_ * schedUprBound_ + 1;
 
   nodeAlctr_ = new EnumTreeNodeAlloc(maxNodeCnt);
+  enumRdyLst_ = new ReadyList(dataDepGraph_, prirts_);
 
   if (IsHistDom()) {
     hashTblEntryAlctr_ =
         new MemAlloc<BinHashTblEntry<HistEnumTreeNode>>(memAllocBlkSize);
 
-    bitVctr1_ = new BitVector(totInstCnt_);
-    bitVctr2_ = new BitVector(totInstCnt_);
-
     lastInsts_ = new SchedInstruction *[lastInstsEntryCnt];
-    othrLastInsts_ = new SchedInstruction *[totInstCnt_];
+
+    // The window also covers the extra slot that is examined when counting
+    // the instructions of the current cycle. The temporary history node keeps
+    // the reservations of the issue slots after it.
+    histWndwSize_ = lastInstsEntryCnt + 1;
+    histSchduldWordCnt_ = BitWords::getWordCnt(totInstCnt_);
+    histInstNumsAlctr_ =
+        new ArrayMemAlloc<InstCount>(memAllocBlkSize, histWndwSize_);
+    histSchduldAlctr_ =
+        new ArrayMemAlloc<uint64_t>(memAllocBlkSize, histSchduldWordCnt_);
+    histRsrvAlctr_ = new ArrayMemAlloc<InstCount>(memAllocBlkSize, issuRate_);
+    tmpHistInstNums_ = new InstCount[histWndwSize_ + issuRate_];
+    tmpHistSchduld_ = new uint64_t[histSchduldWordCnt_];
+    histWndwBuf_ = new InstCount[histWndwSize_];
   }
 }
 /****************************************************************************/
@@ -560,34 +718,57 @@ void Enumerator::SetupAllocators_() {
 void Enumerator::ResetAllocators_() {
   nodeAlctr_->Reset();
 
-  if (IsHistDom())
+  if (IsHistDom()) {
     hashTblEntryAlctr_->Reset();
+    histInstNumsAlctr_->Reset();
+    histSchduldAlctr_->Reset();
+    histRsrvAlctr_->Reset();
+  }
 }
 /****************************************************************************/
 
 void Enumerator::FreeAllocators_() {
   delete nodeAlctr_;
   nodeAlctr_ = NULL;
+  delete enumRdyLst_;
+  enumRdyLst_ = NULL;
   delete rlxdSchdulr_;
 
   if (IsHistDom()) {
     delete hashTblEntryAlctr_;
     hashTblEntryAlctr_ = NULL;
-    delete bitVctr1_;
-    delete bitVctr2_;
     delete[] lastInsts_;
-    delete[] othrLastInsts_;
+    delete histInstNumsAlctr_;
+    delete histSchduldAlctr_;
+    delete histRsrvAlctr_;
+    delete[] tmpHistInstNums_;
+    delete[] tmpHistSchduld_;
+    delete[] histWndwBuf_;
   }
 }
 /****************************************************************************/
 
 void Enumerator::Reset() {
   if (IsHistDom()) {
-    exmndSubProbs_->Clear(false, hashTblEntryAlctr_);
+    exmndSubProbs_->Clear();
+    histBytes_ = 0;
+    if (evctdSigs_ != NULL)
+      evctdSigs_->Reset();
   }
 
   ResetAllocators_();
+  ResetSrchState_();
+}
+/****************************************************************************/
+
+void Enumerator::ResetForSubProb() {
+  // The history nodes stay allocated, since the shared table refers to them.
+  nodeAlctr_->Reset();
+  ResetSrchState_();
+}
+/****************************************************************************/
 
+void Enumerator::ResetSrchState_() {
   for (InstCount i = 0; i < schedUprBound_; i++) {
     if (frstRdyLstPerCycle_[i] != NULL) {
       frstRdyLstPerCycle_[i]->Reset();
@@ -608,9 +789,9 @@ bool Enumerator::Initialize_(InstSchedule *sched, InstCount trgtLngth) {
   fsblSchedCnt_ = 0;
   imprvmntCnt_ = 0;
   crntSched_ = sched;
-  minUnschduldTplgclOrdr_ = 0;
   backTrackCnt_ = 0;
   iterNum_++;
+  trail_.Reset();
 
   if (ConstrainedScheduler::Initialize_(trgtSchedLngth_, fxdLst_) == false) {
     return false;
@@ -657,6 +838,7 @@ bool Enumerator::Initialize_(InstSchedule *sched, InstCount trgtLngth) {
   rdyLst_ = NULL;
   CreateRootNode_();
   crntNode_ = rootNode_;
+  lwrBoundIndx_.Build();
   ClearState_();
   return true;
 }
@@ -674,28 +856,25 @@ bool Enumerator::InitPreFxdInsts_() {
 
 void Enumerator::SetInstSigs_() {
   InstCount i;
-  int16_t bitsForInstNum = Utilities::clcltBitsNeededToHoldNum(totInstCnt_ - 1);
-
+  InstSignature sigMask = histSigBits_ == 8 * sizeof(InstSignature)
+                              ? ~(InstSignature)0
+                              : ((InstSignature)1 << histSigBits_) - 1;
+
+  // Zobrist signatures: each instruction gets a random key, and the signature
+  // of a partial schedule is the xor of the keys of its instructions. The keys
+  // are mixed from the instruction numbers rather than drawn from the random
+  // generator, so that the copies of the region enumerated by other threads
+  // get the same signatures and can share the history table.
   for (i = 0; i < totInstCnt_; i++) {
     SchedInstruction *inst = dataDepGraph_->GetInstByIndx(i);
-    InstSignature sig = RandomGen::GetRand32();
+    uint64_t key = RandomStream::MixSeed(0, i);
+    InstSignature sig = (InstSignature)key & sigMask;
 
     // ensure it is not zero
     if (sig == 0) {
       sig += 1;
     }
 
-    // left shift by the number of bits needed to encode the instruction number
-    sig <<= bitsForInstNum;
-
-    // now, place the instruction number in the least significant bits
-    sig |= i;
-
-    // sig &= 0x7fffffffffffffff;
-    sig &= 0x7fffffff;
-
-    assert(sig != 0);
-
     inst->SetSig(sig);
   }
 }
@@ -703,9 +882,8 @@ void Enumerator::SetInstSigs_() {
 
 void Enumerator::CreateRootNode_() {
   rootNode_ = nodeAlctr_->Alloc(NULL, NULL, this);
-  CreateNewRdyLst_();
+  InitRdyLst_();
   rootNode_->SetRdyLst(rdyLst_);
-  rootNode_->SetLwrBounds(DIR_FRWRD);
   assert(rsrvSlotCnt_ == 0);
   rootNode_->SetRsrvSlots(rsrvSlotCnt_, rsrvSlots_);
   InitNewNode_(rootNode_);
@@ -1025,6 +1203,16 @@ bool Enumerator::FindNxtFsblBrnch_(EnumTreeNode *&newNode) {
       }
     }
 
+    // Above the split depth of a parallel search, only the branches leading
+    // to this thread's subproblem are followed. The skipped branches are not
+    // passed on, so that missing their deadlines here does not make the node
+    // infeasible.
+    if (IsOffSubProbPath_(inst)) {
+      crntNode_->NewBranchExmnd(NULL, false, false, false, false, DIR_FRWRD,
+                                true);
+      continue;
+    }
+
     exmndNodeCnt_++;
 
 #ifdef IS_DEBUG_INFSBLTY_TESTS
@@ -1138,7 +1326,6 @@ bool Enumerator::ProbeBranch_(SchedInstruction *inst, EnumTreeNode *&newNode,
   state_.instFxd = true;
 
   newNode = nodeAlctr_->Alloc(crntNode_, inst, this);
-  newNode->SetLwrBounds(DIR_FRWRD);
   newNode->SetRsrvSlots(rsrvSlotCnt_, rsrvSlots_);
 
   // If a node (sub-problem) that dominates the candidate node (sub-problem)
@@ -1181,8 +1368,8 @@ bool Enumerator::ProbeIssuSlotFsblty_(SchedInstruction *inst) {
   if (issuType != ISSU_STALL) {
     assert(avlblSlotsInCrntCycle_[issuType] > 0);
     assert(avlblSlots_[issuType] > 0);
-    avlblSlotsInCrntCycle_[issuType]--;
-    avlblSlots_[issuType]--;
+    SetAvlblSlotsInCrntCycle_(issuType, avlblSlotsInCrntCycle_[issuType] - 1);
+    SetAvlblSlots_(issuType, avlblSlots_[issuType] - 1);
     neededSlots_[issuType]--;
     assert(avlblSlots_[issuType] >= neededSlots_[issuType]);
   }
@@ -1196,8 +1383,8 @@ bool Enumerator::ProbeIssuSlotFsblty_(SchedInstruction *inst) {
     // scheduled, because it was not clear then which type was affected
     // by each stall
     if (endOfCycle) {
-      avlblSlots_[i] -= avlblSlotsInCrntCycle_[i];
-      avlblSlotsInCrntCycle_[i] = 0;
+      SetAvlblSlots_(i, avlblSlots_[i] - avlblSlotsInCrntCycle_[i]);
+      SetAvlblSlotsInCrntCycle_(i, 0);
     }
 
     if (avlblSlots_[i] < neededSlots_[i]) {
@@ -1228,7 +1415,7 @@ void Enumerator::RestoreCrntState_(SchedInstruction *inst,
   }
 
   if (state_.issuSlotsProbed) {
-    crntNode_->GetSlotAvlblty(avlblSlots_, avlblSlotsInCrntCycle_);
+    PopTrail_(NULL);
 
     if (inst != NULL) {
       IssueType issuType = inst->GetIssueType();
@@ -1244,8 +1431,9 @@ void Enumerator::StepFrwrd_(EnumTreeNode *&newNode) {
   SchedInstruction *instToSchdul = newNode->GetInst();
   InstCount instNumToSchdul;
 
-  CreateNewRdyLst_();
-  // Let the new node inherit its parent's ready list before we update it
+  // The new node takes over the ready list of its parent, whose state is
+  // restored when backtracking.
+  rdyLst_->SaveState();
   newNode->SetRdyLst(rdyLst_);
 
   if (instToSchdul == NULL) {
@@ -1254,10 +1442,7 @@ void Enumerator::StepFrwrd_(EnumTreeNode *&newNode) {
     instNumToSchdul = instToSchdul->GetNum();
     SchdulInst_(instToSchdul, crntCycleNum_);
     rdyLst_->RemoveNextPriorityInst();
-
-    if (instToSchdul->GetTplgclOrdr() == minUnschduldTplgclOrdr_) {
-      minUnschduldTplgclOrdr_++;
-    }
+    lwrBoundIndx_.Remove(instToSchdul);
   }
 
   crntSched_->AppendInst(instNumToSchdul);
@@ -1266,6 +1451,10 @@ void Enumerator::StepFrwrd_(EnumTreeNode *&newNode) {
   assert(crntCycleNum_ <= trgtSchedLngth_);
 
   if (crntSlotNum_ == 0) {
+    // Record the slot counts that the new cycle resets.
+    for (int16_t i = 0; i < issuTypeCnt_; i++) {
+      SetAvlblSlotsInCrntCycle_(i, slotsPerTypePerCycle_[i]);
+    }
     InitNewCycle_();
   }
 
@@ -1294,7 +1483,7 @@ void Enumerator::InitNewNode_(EnumTreeNode *newNode) {
     assert(crntNode_->GetHistory() != tmpHstryNode_);
   }
 
-  crntNode_->SetSlotAvlblty(avlblSlots_, avlblSlotsInCrntCycle_);
+  crntNode_->SetTrailMark(trail_.GetMark());
 
   UpdtRdyLst_(crntCycleNum_, crntSlotNum_);
   bool isLeaf = schduldInstCnt_ == totInstCnt_;
@@ -1466,17 +1655,20 @@ bool Enumerator::BackTrack_() {
   SchedInstruction *inst = crntNode_->GetInst();
   EnumTreeNode *trgtNode = crntNode_->GetParent();
 
-  rdyLst_->RemoveLatestSubList();
+  rdyLst_->RestoreState();
 
   if (IsHistDom()) {
     assert(!crntNode_->IsArchived());
-    HistEnumTreeNode *crntHstry = crntNode_->GetHistory();
-    exmndSubProbs_->InsertElement(crntNode_->GetSig(), crntHstry,
-                                  hashTblEntryAlctr_);
     SetTotalCostsAndSuffixes(crntNode_, trgtNode, trgtSchedLngth_,
                              rgn_->isTwoPassEnabled(),
                              prune_.useSuffixConcatenation);
     crntNode_->Archive();
+    // Insert the node only after it has been archived, since other threads
+    // may search the table as soon as it is there. Above the split depth of a
+    // parallel search, parts of this node's subtree were searched by other
+    // threads, so it cannot dominate anything.
+    if (!IsSubProbShared_(crntNode_))
+      InsrtHistNode_(crntNode_);
   } else {
     assert(crntNode_->IsArchived() == false);
   }
@@ -1501,7 +1693,6 @@ bool Enumerator::BackTrack_() {
                trgtNode->GetCostLwrBound());
 #endif
 
-  crntNode_->GetSlotAvlblty(avlblSlots_, avlblSlotsInCrntCycle_);
   isCrntCycleBlkd_ = crntNode_->GetCrntCycleBlkd();
 
   if (inst != NULL) {
@@ -1510,7 +1701,7 @@ bool Enumerator::BackTrack_() {
   }
 
   crntSched_->RemoveLastInst();
-  RestoreCrntLwrBounds_(inst);
+  PopTrail_(inst);
 
   if (inst != NULL) {
     // int hitCnt;
@@ -1520,10 +1711,7 @@ bool Enumerator::BackTrack_() {
     UndoRsrvSlots_(inst);
     UnSchdulInst_(inst);
     inst->UnSchedule();
-
-    if (inst->GetTplgclOrdr() == minUnschduldTplgclOrdr_ - 1) {
-      minUnschduldTplgclOrdr_--;
-    }
+    lwrBoundIndx_.Insert(inst);
   }
 
   backTrackCnt_++;
@@ -1531,26 +1719,144 @@ bool Enumerator::BackTrack_() {
 }
 /*****************************************************************************/
 
+void Enumerator::InsrtHistNode_(EnumTreeNode *node) {
+  HistEnumTreeNode *histNode = node->GetHistory();
+
+  if (histMaxBytes_ != 0) {
+    size_t nodeBytes =
+        histNode->GetMemSize(this) + sizeof(BinHashTblEntry<HistEnumTreeNode>);
+    // The entries of a table shared with other threads cannot be evicted,
+    // since the other threads walk its lists without locks and may be reading
+    // them. So the threads stop adding entries once all of them together would
+    // exceed the limit. This only costs pruning: the history is only used to
+    // prune, so a subproblem without an entry is at worst searched again.
+    bool isFull;
+    if (prllCntxt_ != NULL)
+      isFull = prllCntxt_->HistBytes.load(std::memory_order_relaxed) +
+                   nodeBytes >
+               histMaxBytes_;
+    else
+      isFull = !MakeRoomForHistNode_(node->GetSig(), nodeBytes);
+    if (isFull) {
+      rjctdHistCnt_++;
+      // The node is left out of the table and freed right away, unless the
+      // nodes kept for its children still look at it and at its ancestors. It
+      // is then kept as an evicted node until they are freed. Only the nodes
+      // of a shared table, from which nothing is evicted, can be kept so.
+      histBytes_ += nodeBytes;
+      if (prllCntxt_ != NULL && histNode->HasRtndChldrn())
+        prllCntxt_->HistBytes.fetch_add(nodeBytes, std::memory_order_relaxed);
+      if (histNode->GetParent() != NULL)
+        histNode->GetParent()->AddRtndChld();
+      histNode->SetEvctd();
+      FreeEvctdHistNode_(histNode);
+      return;
+    }
+
+    histBytes_ += nodeBytes;
+    uint64_t tblBytes = histBytes_;
+    if (prllCntxt_ != NULL)
+      tblBytes = prllCntxt_->HistBytes.fetch_add(
+                     nodeBytes, std::memory_order_relaxed) +
+                 nodeBytes;
+    peakHistBytes_ = std::max(peakHistBytes_, tblBytes);
+    histNode->SetLastMatchTime(exmndNodeCnt_);
+    if (histNode->GetParent() != NULL)
+      histNode->GetParent()->AddRtndChld();
+  }
+
+  exmndSubProbs_->InsertElement(node->GetSig(), histNode, hashTblEntryAlctr_);
+}
+/****************************************************************************/
+
+bool Enumerator::MakeRoomForHistNode_(InstSignature sig, size_t nodeBytes) {
+  auto isLeastRecentlyMatched = [](HistEnumTreeNode *a, HistEnumTreeNode *b) {
+    return a->GetLastMatchTime() < b->GetLastMatchTime();
+  };
+  auto isShallower = [](HistEnumTreeNode *a, HistEnumTreeNode *b) {
+    return a->GetTime() < b->GetTime();
+  };
+
+  while (histBytes_ + nodeBytes > histMaxBytes_) {
+    // Evict from the bucket of the new entry, or if it is empty, from the next
+    // bucket that is not. Evicted nodes that are still needed by their
+    // children are only freed once those are, so this may take several
+    // evictions, but it only fails once the table is empty.
+    UDT_HASHKEY victimSig = sig;
+    if (exmndSubProbs_->GetListSize(sig) == 0 &&
+        !exmndSubProbs_->FindPpultdList(sig, victimSig))
+      return false;
+
+    UDT_HASHKEY evctdSig;
+    HistEnumTreeNode *victim =
+        histEvctnPlcy_ == HE_SHALLOWEST
+            ? exmndSubProbs_->EvictElement(victimSig, isShallower,
+                                           hashTblEntryAlctr_, evctdSig)
+            : exmndSubProbs_->EvictElement(victimSig, isLeastRecentlyMatched,
+                                           hashTblEntryAlctr_, evctdSig);
+    assert(victim != NULL);
+
+    evctdHistCnt_++;
+    evctdSigs_->SetBit(evctdSig & (evctdSigs_->GetSize() - 1));
+    victim->SetEvctd();
+    FreeEvctdHistNode_(victim);
+  }
+
+  return true;
+}
+/****************************************************************************/
+
+void Enumerator::FreeEvctdHistNode_(HistEnumTreeNode *histNode) {
+  // The nodes of the history table refer to their ancestors to recover their
+  // prefixes, so a node is only freed once it has been evicted and none of
+  // its children is kept anymore.
+  while (histNode != NULL && histNode->IsEvctd() &&
+         !histNode->HasRtndChldrn()) {
+    HistEnumTreeNode *prntNode = histNode->GetParent();
+    histBytes_ -= histNode->GetMemSize(this) +
+                  sizeof(BinHashTblEntry<HistEnumTreeNode>);
+    FreeHistNode_(histNode);
+
+    if (prntNode != NULL)
+      prntNode->RemoveRtndChld();
+    histNode = prntNode;
+  }
+}
+/****************************************************************************/
+
 bool Enumerator::WasDmnntSubProbExmnd_(SchedInstruction *,
                                        EnumTreeNode *&newNode) {
 #ifdef IS_DEBUG_SPD
   stats::signatureDominationTests++;
 #endif
   HistEnumTreeNode *exNode;
+  ShardedBinHashTable<HistEnumTreeNode>::SrchCrsr crsr;
+#ifdef IS_DEBUG_SPD
+  auto chkStrt = std::chrono::high_resolution_clock::now();
+#endif
   int listSize = exmndSubProbs_->GetListSize(newNode->GetSig());
   int trvrsdListSize = 0;
-  stats::historyListSize.Record(listSize);
+  if (rcrdStats_)
+    stats::historyListSize.Record(listSize);
   mostRecentMatchingHistNode_ = nullptr;
   bool mostRecentMatchWasSet = false;
 
-  for (exNode = exmndSubProbs_->GetLastMatch(newNode->GetSig()); exNode != NULL;
-       exNode = exmndSubProbs_->GetPrevMatch()) {
+  for (exNode = exmndSubProbs_->GetLastMatch(newNode->GetSig(), crsr);
+       exNode != NULL; exNode = exmndSubProbs_->GetPrevMatch(crsr)) {
     trvrsdListSize++;
+    histSigTestCnt_++;
 #ifdef IS_DEBUG_SPD
     stats::signatureMatches++;
 #endif
 
-    if (exNode->DoesMatch(newNode, this)) {
+    if (!exNode->DoesMatch(newNode, this)) {
+      // The signatures are equal, but not the scheduled instructions.
+      histSigAliasCnt_++;
+    } else {
+      // Only this thread may write to the nodes it owns.
+      if (histMaxBytes_ != 0 && prllCntxt_ == NULL)
+        exNode->SetLastMatchTime(exmndNodeCnt_);
+
       if (!mostRecentMatchWasSet) {
         mostRecentMatchingHistNode_ =
             (exNode->GetSuffix() != nullptr) ? exNode : nullptr;
@@ -1576,6 +1882,7 @@ bool Enumerator::WasDmnntSubProbExmnd_(SchedInstruction *,
         stats::historyDominationPosition.Record(trvrsdListSize);
         stats::historyDominationPositionToListSize.Record(
             (trvrsdListSize * 100) / listSize);
+        histDmntnChkTime_ += GetElapsedNs(chkStrt);
 #endif
         return true;
       } else {
@@ -1586,14 +1893,112 @@ bool Enumerator::WasDmnntSubProbExmnd_(SchedInstruction *,
     }
   }
 
-  stats::traversedHistoryListSize.Record(trvrsdListSize);
+  if (rcrdStats_)
+    stats::traversedHistoryListSize.Record(trvrsdListSize);
+  if (evctdHistCnt_ != 0 &&
+      evctdSigs_->GetBit(newNode->GetSig() & (evctdSigs_->GetSize() - 1)))
+    lostHistDmntnCnt_++;
+#ifdef IS_DEBUG_SPD
+  histDmntnChkTime_ += GetElapsedNs(chkStrt);
+#endif
   return false;
 }
 /****************************************************************************/
 
+void Enumerator::AddSubProb_(EnumTreeNode *node) {
+  assert(prllCntxt_ != NULL && node->GetTime() == prllCntxt_->SplitDepth);
+  SubProblemPool::Prefix prefix(node->GetTime());
+
+  for (EnumTreeNode *crnt = node; crnt->GetParent() != NULL;
+       crnt = crnt->GetParent()) {
+    prefix[crnt->GetTime() - 1] = crnt->GetInstNum();
+  }
+
+  prllCntxt_->SubProblems.add(prefix);
+}
+/****************************************************************************/
+
+void Enumerator::SetParallelContext(ParallelEnumContext *cntxt,
+                                    bool isMainThrd) {
+  if (IsHistDom()) {
+    if (cntxt != NULL) {
+      if (isMainThrd)
+        cntxt->History = ownExmndSubProbs_;
+      assert(cntxt->History != NULL);
+      exmndSubProbs_ = cntxt->History;
+    } else {
+      // The shared table holds entries allocated by the other threads, which
+      // are about to be reset.
+      if (isMainThrd)
+        ownExmndSubProbs_->Clear();
+      exmndSubProbs_ = ownExmndSubProbs_;
+    }
+  }
+
+  prllCntxt_ = cntxt;
+  rcrdStats_ = cntxt == NULL || isMainThrd;
+}
+/****************************************************************************/
+
+void Enumerator::LogHistTableStats() {
+  if (!IsHistDom())
+    return;
+
+  HashTblShardStats total;
+  uint64_t minShardInsrtCnt = std::numeric_limits<uint64_t>::max();
+  uint64_t maxShardInsrtCnt = 0;
+  int shardCnt = ownExmndSubProbs_->GetShardCnt();
+
+  for (int i = 0; i < shardCnt; i++) {
+    HashTblShardStats shard = ownExmndSubProbs_->GetShardStats(i);
+    total.insrtCnt += shard.insrtCnt;
+    total.srchCnt += shard.srchCnt;
+    total.hitCnt += shard.hitCnt;
+    total.cllsnCnt += shard.cllsnCnt;
+    total.maxListSize = std::max(total.maxListSize, shard.maxListSize);
+    minShardInsrtCnt = std::min(minShardInsrtCnt, shard.insrtCnt);
+    maxShardInsrtCnt = std::max(maxShardInsrtCnt, shard.insrtCnt);
+
+    stats::historyShardEntries.Record(shard.insrtCnt);
+    stats::historyShardCollisions.Record(shard.cllsnCnt);
+    stats::historyShardMaxListSize.Record(shard.maxListSize);
+  }
+
+  Logger::Event("HistoryTableStats", "shards", shardCnt, //
+                "entries", total.insrtCnt,               //
+                "min_shard_entries", minShardInsrtCnt,   //
+                "max_shard_entries", maxShardInsrtCnt,   //
+                "searches", total.srchCnt,               //
+                "hits", total.hitCnt,                    //
+                "collisions", total.cllsnCnt,            //
+                "max_list_size", total.maxListSize,      //
+                "signature_bits", histSigBits_,          //
+                "signature_tests", histSigTestCnt_,      //
+                "signature_aliases", histSigAliasCnt_);
+
+  stats::historySignatureTests += histSigTestCnt_;
+  stats::historySignatureAliases += histSigAliasCnt_;
+#ifdef IS_DEBUG_SPD
+  stats::historyDominationCheckTime.Record(histDmntnChkTime_ / 1000);
+#endif
+
+  if (histMaxBytes_ != 0) {
+    stats::historyEvictions.Record(evctdHistCnt_);
+    stats::historyRejections.Record(rjctdHistCnt_);
+    stats::historyDominationsLostToEviction.Record(lostHistDmntnCnt_);
+    stats::historyPeakMemory.Record(peakHistBytes_ >> 10);
+
+    Logger::Event("HistoryTableEviction", "max_bytes", histMaxBytes_, //
+                  "peak_bytes", peakHistBytes_,                       //
+                  "evicted", evctdHistCnt_,                           //
+                  "rejected", rjctdHistCnt_,                          //
+                  "possibly_lost_dominations", lostHistDmntnCnt_);
+  }
+}
+/****************************************************************************/
+
 bool Enumerator::TightnLwrBounds_(SchedInstruction *newInst) {
   SchedInstruction *inst;
-  InstCount newLwrBound = 0;
   InstCount nxtAvlblCycle[MAX_ISSUTYPE_CNT];
   bool fsbl;
   InstCount i;
@@ -1601,6 +2006,8 @@ bool Enumerator::TightnLwrBounds_(SchedInstruction *newInst) {
   assert(fxdLst_->GetElmntCnt() == 0);
   assert(tightndLst_->GetElmntCnt() == 0);
 
+  tightnCands_.clear();
+
   for (i = 0; i < issuTypeCnt_; i++) {
     // If this slot is filled with a stall then all subsequent slots are
     // going to be filled with stalls
@@ -1613,42 +2020,83 @@ bool Enumerator::TightnLwrBounds_(SchedInstruction *newInst) {
       nxtAvlblCycle[i] =
           avlblSlotsInCrntCycle_[i] == 0 ? crntCycleNum_ + 1 : crntCycleNum_;
     }
+
+    // Only the unscheduled insts whose lower bounds are below the next
+    // available cycle need to be tightened. The others need no deadline check
+    // either. Each unscheduled inst has a lower bound no later than its
+    // deadline, that is a bound sum no greater than the last cycle. SetBounds
+    // checks this when scheduling starts, and SchedRange::TightnLwrBound fails
+    // on any change to a bound that would break it, making the node
+    // infeasible. Untightening only restores earlier bounds. So the insts
+    // this step does not tighten still meet their deadlines, and the ones it
+    // does tighten are checked by TightnLwrBoundRcrsvly.
+    lwrBoundIndx_.GetInstsBelow(i, nxtAvlblCycle[i], tightnCands_);
   }
 
-  for (i = minUnschduldTplgclOrdr_; i < totInstCnt_; i++) {
-    inst = dataDepGraph_->GetInstByTplgclOrdr(i);
-    assert(inst != newInst ||
-           inst->GetCrntLwrBound(DIR_FRWRD) == crntCycleNum_);
+  // Tighten in topological order, which skips the insts that get tightened
+  // recursively through their predecessors.
+  std::sort(tightnCands_.begin(), tightnCands_.end(),
+            [](SchedInstruction *a, SchedInstruction *b) {
+              return a->GetTplgclOrdr() < b->GetTplgclOrdr();
+            });
 
-    if (inst->IsSchduld() == false) {
-      IssueType issuType = inst->GetIssueType();
-      newLwrBound = nxtAvlblCycle[issuType];
+  fsbl = true;
 
-      if (newLwrBound > inst->GetCrntLwrBound(DIR_FRWRD)) {
-#ifdef IS_DEBUG_FLOW
-        Logger::Info("Tightening LB of inst %d from %d to %d", inst->GetNum(),
-                     inst->GetCrntLwrBound(DIR_FRWRD), newLwrBound);
-#endif
-        fsbl = inst->TightnLwrBoundRcrsvly(DIR_FRWRD, newLwrBound, tightndLst_,
-                                           fxdLst_, false);
+  // The candidates are checked against the store, and only the ones that get
+  // tightened are touched.
+  const SchedInstStore &store = *dataDepGraph_->GetInstStore();
 
-        if (fsbl == false) {
-          return false;
-        }
-      }
+  for (SchedInstruction *cand : tightnCands_) {
+    InstCount candNum = cand->GetNum();
+    assert(cand != newInst ||
+           store.crntFrwrdLwrBounds[candNum] == crntCycleNum_);
 
-      assert(inst->GetCrntLwrBound(DIR_FRWRD) >= newLwrBound);
+    // The inst being probed is still in the index.
+    if (store.schedCycles[candNum] != SCHD_UNSCHDULD)
+      continue;
 
-      if (inst->GetCrntLwrBound(DIR_FRWRD) > inst->GetCrntDeadline()) {
-        return false;
+    InstCount newLwrBound = nxtAvlblCycle[store.issuTypes[candNum]];
+
+    if (newLwrBound > store.crntFrwrdLwrBounds[candNum]) {
+#ifdef IS_DEBUG_FLOW
+      Logger::Info("Tightening LB of inst %d from %d to %d", candNum,
+                   store.crntFrwrdLwrBounds[candNum], newLwrBound);
+#endif
+      // Fails if a bound is pushed past the deadline.
+      fsbl = cand->TightnLwrBoundRcrsvly(DIR_FRWRD, newLwrBound, tightndLst_,
+                                         fxdLst_, false);
+
+      if (fsbl == false) {
+        break;
       }
     }
+
+    assert(store.crntFrwrdLwrBounds[candNum] >= newLwrBound);
   }
 
+  // Even if infeasible, record the old bounds so that untightening can pop
+  // them from the trail.
   for (inst = tightndLst_->GetFrstElmnt(); inst != NULL;
        inst = tightndLst_->GetNxtElmnt()) {
+    trail_.Push(TK_FRWRD_LWR_BOUND, inst->GetNum(),
+                inst->GetPrevLwrBound(DIR_FRWRD));
     dataDepGraph_->SetCrntFrwrdLwrBound(inst);
+    lwrBoundIndx_.Update(inst);
+    rlxdSchdulr_->TightnReleaseTime(inst);
+  }
+
+  if (fsbl == false) {
+    return false;
+  }
+
+#ifdef IS_DEBUG_LB_TIGHTENING
+  for (i = 0; i < totInstCnt_; i++) {
+    if (store.schedCycles[i] == SCHD_UNSCHDULD) {
+      assert(store.crntFrwrdLwrBounds[i] >= nxtAvlblCycle[store.issuTypes[i]]);
+      assert(store.crntFrwrdLwrBounds[i] <= store.crntDeadlines[i]);
+    }
   }
+#endif
 
   return FixInsts_(newInst);
 }
@@ -1656,15 +2104,14 @@ bool Enumerator::TightnLwrBounds_(SchedInstruction *newInst) {
 
 void Enumerator::UnTightnLwrBounds_(SchedInstruction *newInst) {
   UnFixInsts_(newInst);
+  PopTrail_(NULL);
 
-  SchedInstruction *inst;
-
-  for (inst = tightndLst_->GetFrstElmnt(); inst != NULL;
+#ifdef IS_DEBUG
+  for (SchedInstruction *inst = tightndLst_->GetFrstElmnt(); inst != NULL;
        inst = tightndLst_->GetNxtElmnt()) {
-    inst->UnTightnLwrBounds();
-    dataDepGraph_->SetCrntFrwrdLwrBound(inst);
     assert(inst->IsFxd() == false);
   }
+#endif
 
   tightndLst_->Reset();
   dirctTightndLst_->Reset();
@@ -1756,31 +2203,42 @@ void Enumerator::CmtInstFxng_() {
 }
 /*****************************************************************************/
 
-void Enumerator::RestoreCrntLwrBounds_(SchedInstruction *unschduldInst) {
-  InstCount *frwrdLwrBounds = crntNode_->GetLwrBounds(DIR_FRWRD);
+void Enumerator::PopTrail_(SchedInstruction *unschduldInst) {
   bool unschduldInstDone = false;
 
-  for (InstCount i = 0; i < totInstCnt_; i++) {
-    SchedInstruction *inst = dataDepGraph_->GetInstByIndx(i);
-    InstCount fxdCycle = 0;
-    bool preFxd = inst->IsFxd();
+  trail_.PopTo(crntNode_->GetTrailMark(), [&](const TrailEntry &entry) {
+    switch (entry.kind) {
+    case TK_FRWRD_LWR_BOUND: {
+      SchedInstruction *inst = dataDepGraph_->GetInstByIndx(entry.indx);
+      InstCount fxdCycle = 0;
+      bool preFxd = inst->IsFxd();
 
-    if (preFxd) {
-      fxdCycle = inst->GetFxdCycle();
-    }
+      if (preFxd) {
+        fxdCycle = inst->GetFxdCycle();
+      }
 
-    inst->SetCrntLwrBound(DIR_FRWRD, frwrdLwrBounds[i]);
-    dataDepGraph_->SetCrntFrwrdLwrBound(inst);
-    bool postFxd = inst->IsFxd();
+      inst->SetCrntLwrBound(DIR_FRWRD, entry.val);
+      dataDepGraph_->SetCrntFrwrdLwrBound(inst);
+      lwrBoundIndx_.Update(inst);
+      bool postFxd = inst->IsFxd();
 
-    if (preFxd && !postFxd) { // if got untightened and unfixed
-      rlxdSchdulr_->UnFixInst(inst, fxdCycle);
+      if (preFxd && !postFxd) { // if got untightened and unfixed
+        rlxdSchdulr_->UnFixInst(inst, fxdCycle);
 
-      if (inst == unschduldInst) {
-        unschduldInstDone = true;
+        if (inst == unschduldInst) {
+          unschduldInstDone = true;
+        }
       }
+      break;
     }
-  }
+    case TK_AVLBL_SLOTS:
+      avlblSlots_[entry.indx] = entry.val;
+      break;
+    case TK_AVLBL_SLOTS_IN_CYCLE:
+      avlblSlotsInCrntCycle_[entry.indx] = (int16_t)entry.val;
+      break;
+    }
+  });
 
   if (unschduldInst != NULL && !unschduldInstDone) {
     // Assume that the instruction has not been unscheduled yet
@@ -1798,30 +2256,13 @@ void Enumerator::RestoreCrntLwrBounds_(SchedInstruction *unschduldInst) {
 
 bool Enumerator::RlxdSchdul_(EnumTreeNode *newNode) {
   assert(newNode != NULL);
-  LinkedList<SchedInstruction> *rsrcFxdLst = new LinkedList<SchedInstruction>;
+  auto chkStrt = std::chrono::high_resolution_clock::now();
 
   bool fsbl =
-      rlxdSchdulr_->SchdulAndChkFsblty(crntCycleNum_, trgtSchedLngth_ - 1);
+      rlxdSchdulr_->ChkFsbltyIncrmntly(crntCycleNum_, trgtSchedLngth_ - 1);
 
-  for (SchedInstruction *inst = rsrcFxdLst->GetFrstElmnt(); inst != NULL;
-       inst = rsrcFxdLst->GetNxtElmnt()) {
-    assert(inst->IsSchduld() == false);
-    fsbl = rlxdSchdulr_->FixInst(inst, inst->GetCrntLwrBound(DIR_FRWRD));
-
-    if (fsbl == false) {
-      return false;
-    }
-
-    fxdLst_->InsrtElmnt(inst);
-    fxdInstCnt_++;
-#ifdef IS_DEBUG_FIX
-    Logger::Info("%d [%d], ", inst->GetNum(), inst->GetFxdCycle());
-#endif
-  }
-
-  assert(rsrcFxdLst->GetElmntCnt() == 0);
-  rsrcFxdLst->Reset();
-  delete rsrcFxdLst;
+  rlxdChkCnt_++;
+  rlxdChkTime_ += GetElapsedNs(chkStrt);
   return fsbl;
 }
 /*****************************************************************************/
@@ -1959,6 +2400,7 @@ HistEnumTreeNode *LengthEnumerator::AllocTempHistNode_(EnumTreeNode *node) {
 /*****************************************************************************/
 
 void LengthEnumerator::FreeHistNode_(HistEnumTreeNode *histNode) {
+  histNode->FreeArrays(this);
   histNode->Clean();
   histNodeAlctr_->FreeObject(histNode);
 }
@@ -2197,6 +2639,17 @@ bool LengthCostEnumerator::ProbeBranch_(SchedInstruction *inst,
     }
   }
 
+  // When enumerating in parallel, the subtrees at the split depth are only
+  // collected while expanding the tree, and searched later by whichever
+  // thread takes them.
+  if (prllCntxt_ != NULL && prllSubProb_ == NULL &&
+      newNode->GetTime() == prllCntxt_->SplitDepth) {
+    AddSubProb_(newNode);
+    rgn_->UnschdulInst(inst, crntCycleNum_, crntSlotNum_,
+                       newNode->GetParent());
+    return false;
+  }
+
   return true;
 }
 /*****************************************************************************/
@@ -2267,9 +2720,8 @@ InstCount LengthCostEnumerator::getBestSchedLength_() {
 
 void LengthCostEnumerator::CreateRootNode_() {
   rootNode_ = nodeAlctr_->Alloc(NULL, NULL, this);
-  CreateNewRdyLst_();
+  InitRdyLst_();
   rootNode_->SetRdyLst(rdyLst_);
-  rootNode_->SetLwrBounds(DIR_FRWRD);
 
   assert(rsrvSlotCnt_ == 0);
   rootNode_->SetRsrvSlots(rsrvSlotCnt_, rsrvSlots_);
@@ -2319,6 +2771,7 @@ HistEnumTreeNode *LengthCostEnumerator::AllocTempHistNode_(EnumTreeNode *node) {
 /*****************************************************************************/
 
 void LengthCostEnumerator::FreeHistNode_(HistEnumTreeNode *histNode) {
+  histNode->FreeArrays(this);
   histNode->Clean();
   histNodeAlctr_->FreeObject((CostHistEnumTreeNode *)histNode);
 }
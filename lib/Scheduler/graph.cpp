@@ -3,6 +3,8 @@
 #include "opt-sched/Scheduler/defines.h"
 #include "opt-sched/Scheduler/lnkd_lst.h"
 #include "opt-sched/Scheduler/logger.h"
+#include "llvm/ADT/SmallVector.h"
+#include <algorithm>
 #include <cstdio>
 
 using namespace llvm::opt_sched;
@@ -81,10 +83,6 @@ void GraphNode::DepthFirstVisit(GraphNode *tplgclOrdr[],
   tplgclIndx--;
 }
 
-void GraphNode::FindRcrsvNghbrs(DIRECTION dir, DirAcycGraph *graph) {
-  FindRcrsvNghbrs_(this, dir, graph);
-}
-
 void GraphNode::AddRcrsvNghbr(GraphNode *nghbr, DIRECTION dir) {
   LinkedList<GraphNode> *rcrsvNghbrLst = GetRcrsvNghbrLst(dir);
   BitVector *isRcrsvNghbr = GetRcrsvNghbrBitVector(dir);
@@ -121,6 +119,42 @@ void GraphNode::AllocRcrsvInfo(DIRECTION dir, UDT_GNODES nodeCnt) {
   }
 }
 
+void GraphNode::AttachRcrsvInfo(DIRECTION dir, BitVector::Unit *row,
+                                UDT_GNODES nodeCnt) {
+  LinkedList<GraphNode> *&rcrsvNghbrLst =
+      dir == DIR_FRWRD ? rcrsvScsrLst_ : rcrsvPrdcsrLst_;
+  BitVector *&isRcrsvNghbr = dir == DIR_FRWRD ? isRcrsvScsr_ : isRcrsvPrdcsr_;
+
+  delete rcrsvNghbrLst;
+  rcrsvNghbrLst = NULL;
+  if (isRcrsvNghbr == NULL)
+    isRcrsvNghbr = new BitVector;
+  isRcrsvNghbr->Attach(row, nodeCnt);
+}
+
+void GraphNode::BldRcrsvNghbrLst(DIRECTION dir, GraphNode **nodes) {
+  LinkedList<GraphNode> *&rcrsvNghbrLst =
+      dir == DIR_FRWRD ? rcrsvScsrLst_ : rcrsvPrdcsrLst_;
+  BitVector *isRcrsvNghbr = GetRcrsvNghbrBitVector(dir);
+  SmallVector<GraphNode *, 32> nghbrs;
+  for (int num : isRcrsvNghbr->GetSetBits())
+    nghbrs.push_back(nodes[num]);
+
+  // The recursive successors go from the leaf back towards the node, and the
+  // recursive predecessors from the root down towards it.
+  std::sort(nghbrs.begin(), nghbrs.end(),
+            [dir](const GraphNode *a, const GraphNode *b) {
+              return dir == DIR_FRWRD
+                         ? a->GetTplgclOrdr() > b->GetTplgclOrdr()
+                         : a->GetTplgclOrdr() < b->GetTplgclOrdr();
+            });
+
+  delete rcrsvNghbrLst;
+  rcrsvNghbrLst = new LinkedList<GraphNode>;
+  for (GraphNode *nghbr : nghbrs)
+    rcrsvNghbrLst->InsrtElmnt(nghbr);
+}
+
 bool GraphNode::IsScsrDmntd(GraphNode *cnddtDmnnt) {
   if (cnddtDmnnt == this)
     return true;
@@ -178,46 +212,6 @@ bool GraphNode::FindScsr_(GraphNode *&crntScsr, UDT_GNODES trgtNum,
   return false;
 }
 
-void GraphNode::FindRcrsvNghbrs_(GraphNode *root, DIRECTION dir,
-                                 DirAcycGraph *graph) {
-  LinkedList<GraphEdge> *nghbrLst = (dir == DIR_FRWRD) ? scsrLst_ : prdcsrLst_;
-
-  color_ = COL_GRAY;
-
-  // Iterate through the neighbor list of this node and recursively visit them
-  // This recursion will bottom up when the root or leaf node is reached, which
-  // then gets added to the very top of the recursive neighbor list.
-  for (GraphEdge *crntEdge = nghbrLst->GetFrstElmnt(); crntEdge != NULL;
-       crntEdge = nghbrLst->GetNxtElmnt()) {
-    GraphNode *nghbr = crntEdge->GetOtherNode(this);
-    if (nghbr->GetColor() == COL_WHITE) {
-      nghbr->FindRcrsvNghbrs_(root, dir, graph);
-    }
-  }
-
-  // When all the neighbors of this node have been recursively visited, the
-  // node is finished. It is marked black and inserted in the recursive list.
-  color_ = COL_BLACK;
-
-  if (this != root) {
-
-    // Check if there is a cycle in the graph
-    BitVector *thisBitVector = this->GetRcrsvNghbrBitVector(dir);
-    if (thisBitVector && thisBitVector->GetBit(root->GetNum()) == true) {
-      graph->CycleDetected();
-      Logger::Info("Detected a cycle between nodes %d and %d in graph",
-                   root->GetNum(), this->GetNum());
-    }
-
-    // Add this node to the recursive neighbor list of the root node of
-    // this search.
-    root->GetRcrsvNghbrLst(dir)->InsrtElmnt(this);
-    // Set the corresponding boolean vector entry to indicate that this
-    // node is a recursive neighbor of the root node of this search.
-    root->GetRcrsvNghbrBitVector(dir)->SetBit(num_);
-  }
-}
-
 bool GraphNode::IsScsrEquvlnt(GraphNode *othrNode) {
   UDT_GLABEL thisLbl = 0;
   UDT_GLABEL othrLbl = 0;
@@ -319,6 +313,7 @@ DirAcycGraph::DirAcycGraph() {
   tplgclOrdr_ = NULL;
   dpthFrstSrchDone_ = false;
   cycleDetected_ = false;
+  rcrsvRowUnitCnt_ = 0;
 }
 
 DirAcycGraph::~DirAcycGraph() {
@@ -365,36 +360,65 @@ FUNC_RESULT DirAcycGraph::DepthFirstSearch() {
 }
 
 FUNC_RESULT DirAcycGraph::FindRcrsvNghbrs(DIRECTION dir) {
+  if (!dpthFrstSrchDone_)
+    DepthFirstSearch();
+
+  std::vector<BitVector::Unit> &rows =
+      dir == DIR_FRWRD ? rcrsvScsrRows_ : rcrsvPrdcsrRows_;
+  rcrsvRowUnitCnt_ = BitWords::getWordCnt(nodeCnt_);
+  rows.assign((size_t)nodeCnt_ * rcrsvRowUnitCnt_, 0);
   for (UDT_GNODES i = 0; i < nodeCnt_; i++) {
-    GraphNode *node = nodes_[i];
+    BitVector::Unit *row = rows.data() + (size_t)i * rcrsvRowUnitCnt_;
+    nodes_[i]->AttachRcrsvInfo(dir, row, nodeCnt_);
+  }
 
-    // Set the colors of all nodes to white (not visited yet) before starting
-    // each recursive search.
-    for (UDT_GNODES j = 0; j < nodeCnt_; j++) {
-      nodes_[j]->SetColor(COL_WHITE);
+  // Visit the nodes so that each node's neighbors in the given direction come
+  // before it. A node's recursive neighbors are then its neighbors together
+  // with their recursive neighbors, which are ORed in a word at a time.
+  for (UDT_GNODES i = 0; i < nodeCnt_; i++) {
+    UDT_GNODES ordr = dir == DIR_FRWRD ? nodeCnt_ - 1 - i : i;
+    GraphNode *node = tplgclOrdr_[ordr];
+    BitVector *isRcrsvNghbr = node->GetRcrsvNghbrBitVector(dir);
+    LinkedList<GraphEdge> *nghbrLst = dir == DIR_FRWRD
+                                          ? &node->GetSuccessors()
+                                          : &node->GetPredecessors();
+
+    for (GraphEdge *crntEdge = nghbrLst->GetFrstElmnt(); crntEdge != NULL;
+         crntEdge = nghbrLst->GetNxtElmnt()) {
+      GraphNode *nghbr = crntEdge->GetOtherNode(node);
+
+      // In a graph without cycles, every edge goes forward in the
+      // topological order.
+      UDT_GNODES nghbrOrdr = nghbr->GetTplgclOrdr();
+      if (dir == DIR_FRWRD ? nghbrOrdr <= ordr : nghbrOrdr >= ordr) {
+        CycleDetected();
+        Logger::Info("Detected a cycle between nodes %d and %d in graph",
+                     node->GetNum(), nghbr->GetNum());
+        continue;
+      }
+
+      isRcrsvNghbr->SetBit(nghbr->GetNum());
+      isRcrsvNghbr->OrWith(*nghbr->GetRcrsvNghbrBitVector(dir));
     }
-
-    node->AllocRcrsvInfo(dir, nodeCnt_);
-
-    node->FindRcrsvNghbrs(dir, this);
-
-    assert((dir == DIR_FRWRD &&
-            node->GetRcrsvNghbrLst(dir)->GetFrstElmnt() == leaf_) ||
-           (dir == DIR_BKWRD &&
-            node->GetRcrsvNghbrLst(dir)->GetFrstElmnt() == root_) ||
-           node == root_ || node == leaf_);
-    assert(node != root_ ||
-           node->GetRcrsvNghbrLst(DIR_FRWRD)->GetElmntCnt() == nodeCnt_ - 1);
-    assert(node != leaf_ ||
-           node->GetRcrsvNghbrLst(DIR_FRWRD)->GetElmntCnt() == 0);
   }
 
+  assert(dir != DIR_FRWRD || cycleDetected_ ||
+         root_->GetRcrsvScsrCnt() == nodeCnt_ - 1);
+  assert(dir != DIR_FRWRD || cycleDetected_ || leaf_->GetRcrsvScsrCnt() == 0);
+
   if (cycleDetected_)
     return RES_ERROR;
   else
     return RES_SUCCESS;
 }
 
+void DirAcycGraph::BldRcrsvNghbrLsts(DIRECTION dir) {
+  for (UDT_GNODES i = 0; i < nodeCnt_; i++) {
+    if (nodes_[i]->GetRcrsvNghbrLst(dir) == NULL)
+      nodes_[i]->BldRcrsvNghbrLst(dir, nodes_);
+  }
+}
+
 void DirAcycGraph::Print(FILE *outFile) {
   fprintf(outFile, "Number of Nodes= %d    Number of Edges= %d\n", nodeCnt_,
           edgeCnt_);
@@ -24,30 +24,39 @@ bool llvm::opt_sched::areNodesIndependent(const SchedInstruction *A,
   return A != B && !A->IsRcrsvPrdcsr(B) && !A->IsRcrsvScsr(B);
 }
 
-static void UpdateRecursiveNeighbors(SchedInstruction *A, SchedInstruction *B) {
-  // Update lists for the nodes themselves.
+static void UpdateRecursiveNeighbors(DataDepGraph &DDG, SchedInstruction *A,
+                                     SchedInstruction *B) {
+  // Update the neighbors of the nodes themselves.
   A->AddRcrsvScsr(B);
   B->AddRcrsvPrdcsr(A);
 
-  for (GraphNode &X : *A->GetRecursivePredecessors()) {
-    if (!B->IsRcrsvPrdcsr(&X)) {
-      B->AddRcrsvPrdcsr(&X);
-      X.AddRcrsvScsr(B);
+  // The loops below walk the closure rows of A and B, which they don't change.
+  BitVector *APreds = A->GetRecursivePredecessorsBitVector();
+  BitVector *BSuccs = B->GetRecursiveSuccessorsBitVector();
+
+  for (int XNum : APreds->GetSetBits()) {
+    SchedInstruction *X = DDG.GetInstByIndx(XNum);
+    if (!B->IsRcrsvPrdcsr(X)) {
+      B->AddRcrsvPrdcsr(X);
+      X->AddRcrsvScsr(B);
     }
   }
 
-  for (GraphNode &Y : *B->GetRecursiveSuccessors()) {
-    if (!A->IsRcrsvScsr(&Y)) {
-      A->AddRcrsvScsr(&Y);
-      Y.AddRcrsvPrdcsr(A);
+  for (int YNum : BSuccs->GetSetBits()) {
+    SchedInstruction *Y = DDG.GetInstByIndx(YNum);
+    if (!A->IsRcrsvScsr(Y)) {
+      A->AddRcrsvScsr(Y);
+      Y->AddRcrsvPrdcsr(A);
     }
   }
 
-  for (GraphNode &X : *A->GetRecursivePredecessors()) {
-    for (GraphNode &Y : *B->GetRecursiveSuccessors()) {
-      if (!X.IsRcrsvScsr(&Y)) {
-        Y.AddRcrsvPrdcsr(&X);
-        X.AddRcrsvScsr(&Y);
+  for (int XNum : APreds->GetSetBits()) {
+    SchedInstruction *X = DDG.GetInstByIndx(XNum);
+    for (int YNum : BSuccs->GetSetBits()) {
+      SchedInstruction *Y = DDG.GetInstByIndx(YNum);
+      if (!X->IsRcrsvScsr(Y)) {
+        Y->AddRcrsvPrdcsr(X);
+        X->AddRcrsvScsr(Y);
       }
     }
   }
@@ -58,7 +67,7 @@ GraphEdge *llvm::opt_sched::addSuperiorEdge(DataDepGraph &DDG,
                                             SchedInstruction *B, int latency) {
   GraphEdge *e = DDG.CreateEdge(A, B, latency, DEP_OTHER);
   e->IsArtificial = true;
-  UpdateRecursiveNeighbors(A, B);
+  UpdateRecursiveNeighbors(DDG, A, B);
 
   return e;
 }
@@ -1,6 +1,7 @@
 #include "opt-sched/Scheduler/graph_trans_ilp.h"
 
 #include "opt-sched/Scheduler/array_ref2d.h"
+#include "opt-sched/Scheduler/bit_vector.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
 #include <cassert>
@@ -273,11 +274,11 @@ void StaticNodeSupILPTrans::updateDistanceTable(Data &Data, int i_, int j_) {
   SchedInstruction *NodeI = DDG.GetInstByIndx(i);
   SchedInstruction *NodeJ = DDG.GetInstByIndx(j);
 
-  LinkedList<GraphNode> *JSuccessors = NodeJ->GetRecursiveSuccessors();
-  LinkedList<GraphNode> *IPredecessors = NodeI->GetRecursivePredecessors();
+  BitVector *JSuccessors = NodeJ->GetRecursiveSuccessorsBitVector();
+  BitVector *IPredecessors = NodeI->GetRecursivePredecessorsBitVector();
 
-  for (GraphNode &Succ : *JSuccessors) {
-    const size_t k = getNum(&Succ);
+  for (int SuccNum : JSuccessors->GetSetBits()) {
+    const size_t k = castUnsigned(SuccNum);
     const int OldDistance = DistanceTable[{i, k}];
     // The "new" DISTANCE(i, k) = DISTANCE(j, k) because we added a latency 0
     // edge (i, j), but only if this "new distance" is larger.
@@ -288,8 +289,8 @@ void StaticNodeSupILPTrans::updateDistanceTable(Data &Data, int i_, int j_) {
                 NewDistance, OldDistance);
       setDistanceTable(Data, i, k, NewDistance);
 
-      for (GraphNode &Pred : *IPredecessors) {
-        const size_t p = getNum(&Pred);
+      for (int PredNum : IPredecessors->GetSetBits()) {
+        const size_t p = castUnsigned(PredNum);
         const int NewPossiblePK =
             std::min(MaxLatency, NewDistance + DistanceTable[{p, i}]);
         const int OldPK = DistanceTable[{p, k}];
@@ -339,7 +340,7 @@ void StaticNodeSupILPTrans::removeRedundantEdges(DataDepGraph &DDG,
   SchedInstruction *NodeI = DDG.GetInstByIndx(i);
   SchedInstruction *NodeJ = DDG.GetInstByIndx(j);
 
-  // Check edges from I itself, since GetRecursivePredecessors() doesn't include
+  // Check edges from I itself, since the recursive predecessors don't include
   // I.
   {
     LinkedList<GraphEdge> &ISuccs = NodeI->GetSuccessors();
@@ -355,8 +356,9 @@ void StaticNodeSupILPTrans::removeRedundantEdges(DataDepGraph &DDG,
   // Check edges from a predecessor of I to a successor of J (or J itself).
   // We don't need to explicitly check J itself in a separate step because
   // the isRedundant() check appropriately considers edges ending at J.
-  for (GraphNode &Pred : *NodeI->GetRecursivePredecessors()) {
-    LinkedList<GraphEdge> &PSuccs = Pred.GetSuccessors();
+  for (int PredNum :
+       NodeI->GetRecursivePredecessorsBitVector()->GetSetBits()) {
+    LinkedList<GraphEdge> &PSuccs = DDG.GetInstByIndx(PredNum)->GetSuccessors();
 
     for (auto it = PSuccs.begin(); it != PSuccs.end();) {
       if (isRedundant(NodeI, NodeJ, DistanceTable, *it)) {
@@ -1,4 +1,5 @@
 #include "opt-sched/Scheduler/hist_table.h"
+#include "opt-sched/Scheduler/bit_vector.h"
 #include "opt-sched/Scheduler/logger.h"
 #include "opt-sched/Scheduler/stats.h"
 #include "opt-sched/Scheduler/utilities.h"
@@ -7,19 +8,20 @@
 
 using namespace llvm::opt_sched;
 
-HistEnumTreeNode::HistEnumTreeNode() { rsrvSlots_ = NULL; }
-
-HistEnumTreeNode::~HistEnumTreeNode() {
-  if (rsrvSlots_)
-    delete[] rsrvSlots_;
+HistEnumTreeNode::HistEnumTreeNode() {
+  lastInstNums_ = NULL;
+  instsSchduld_ = NULL;
+  rsrvEndCycles_ = NULL;
 }
 
-void HistEnumTreeNode::Construct(EnumTreeNode *node, bool) {
+HistEnumTreeNode::~HistEnumTreeNode() {}
+
+void HistEnumTreeNode::Construct(EnumTreeNode *node, bool isTemp) {
   prevNode_ = node->prevNode_ == NULL ? NULL : node->prevNode_->hstry_;
   assert(prevNode_ != this);
 
   time_ = node->time_;
-  inst_ = node->inst_;
+  instNum_ = node->inst_ == NULL ? SCHD_STALL : node->inst_->GetNum();
 
 #ifdef IS_DEBUG
   isCnstrctd_ = true;
@@ -27,122 +29,184 @@ void HistEnumTreeNode::Construct(EnumTreeNode *node, bool) {
 
   crntCycleBlkd_ = node->crntCycleBlkd_;
   suffix_ = nullptr;
-  SetRsrvSlots_(node);
+  rtndChldCnt_ = 0;
+  isEvctd_ = false;
+  lastMatchTime_ = 0;
+  SetArrays_(node, isTemp);
 }
 
-void HistEnumTreeNode::SetRsrvSlots_(EnumTreeNode *node) {
-  if (rsrvSlots_ != NULL)
-    delete[] rsrvSlots_;
-  rsrvSlots_ = NULL;
+void HistEnumTreeNode::SetArrays_(EnumTreeNode *node, bool isTemp) {
+  Enumerator *enumrtr = node->enumrtr_;
+  InstCount wndwSize = enumrtr->histWndwSize_;
+  InstCount wordCnt = enumrtr->histSchduldWordCnt_;
+  int issuRate = enumrtr->issuRate_;
+  HistEnumTreeNode *prntNode = prevNode_;
+
+  schduldCnt_ = prntNode == NULL ? 0 : prntNode->schduldCnt_;
+  if (instNum_ != SCHD_STALL)
+    schduldCnt_++;
 
   // If no unpipelined instrs are scheduled.
-  if (node->rsrvSlots_ == NULL)
-    return;
+  hasRsrvSlots_ = node->rsrvSlots_ != NULL;
+
+  // The temporary node is reconstructed for every candidate node, so it
+  // reuses arrays owned by the enumerator instead of taking new ones from the
+  // arenas, which are reset between target lengths. It always has a complete
+  // window and set, which the nodes it is tested against are matched with.
+  if (isTemp) {
+    lastInstNums_ = enumrtr->tmpHistInstNums_;
+    instsSchduld_ = enumrtr->tmpHistSchduld_;
+    rsrvEndCycles_ = hasRsrvSlots_ ? lastInstNums_ + wndwSize : NULL;
+  } else {
+    bool isChkpnt = prntNode == NULL || time_ % HIST_CHKPNT_INTRVL == 0;
+    lastInstNums_ = isChkpnt ? enumrtr->histInstNumsAlctr_->GetArray() : NULL;
+    instsSchduld_ = isChkpnt ? enumrtr->histSchduldAlctr_->GetArray() : NULL;
+    rsrvEndCycles_ = hasRsrvSlots_ ? enumrtr->histRsrvAlctr_->GetArray() : NULL;
+  }
+
+  if (lastInstNums_ != NULL) {
+    // Both arrays are those of the parent with this node's instruction added.
+    lastInstNums_[0] = instNum_;
+    if (prntNode != NULL) {
+      prntNode->CopyLastInstNums_(lastInstNums_ + 1, wndwSize - 1);
+      prntNode->CopyInstsSchduld_(instsSchduld_, wordCnt);
+    } else {
+      std::fill(lastInstNums_ + 1, lastInstNums_ + wndwSize, SCHD_STALL);
+      std::fill(instsSchduld_, instsSchduld_ + wordCnt, 0);
+    }
 
-  int issuRate = node->enumrtr_->machMdl_->GetIssueRate();
+    if (instNum_ != SCHD_STALL) {
+      assert(!BitWords::getBit(instsSchduld_, instNum_));
+      BitWords::setBit(instsSchduld_, instNum_);
+    }
+  }
 
-  rsrvSlots_ = new ReserveSlot[issuRate];
+  if (!hasRsrvSlots_)
+    return;
 
   for (int i = 0; i < issuRate; i++) {
-    rsrvSlots_[i].strtCycle = node->rsrvSlots_[i].strtCycle;
-    rsrvSlots_[i].endCycle = node->rsrvSlots_[i].endCycle;
+    rsrvEndCycles_[i] = node->rsrvSlots_[i].strtCycle == INVALID_VALUE
+                            ? INVALID_VALUE
+                            : node->rsrvSlots_[i].endCycle;
+  }
+}
+
+void HistEnumTreeNode::CopyLastInstNums_(InstCount *instNums, InstCount cnt) {
+  HistEnumTreeNode *node = this;
+  InstCount indx = 0;
+  for (; indx < cnt && node->lastInstNums_ == NULL; indx++) {
+    instNums[indx] = node->instNum_;
+    node = node->prevNode_;
+    assert(node != NULL);
+  }
+
+  if (indx < cnt)
+    std::copy(node->lastInstNums_, node->lastInstNums_ + cnt - indx,
+              instNums + indx);
+}
+
+void HistEnumTreeNode::CopyInstsSchduld_(uint64_t *instsSchduld,
+                                         InstCount wordCnt) {
+  HistEnumTreeNode *chkpnt = this;
+  while (chkpnt->instsSchduld_ == NULL)
+    chkpnt = chkpnt->prevNode_;
+  std::copy(chkpnt->instsSchduld_, chkpnt->instsSchduld_ + wordCnt,
+            instsSchduld);
+
+  for (HistEnumTreeNode *node = this; node != chkpnt; node = node->prevNode_) {
+    if (node->instNum_ != SCHD_STALL)
+      BitWords::setBit(instsSchduld, node->instNum_);
   }
 }
 
+const InstCount *HistEnumTreeNode::GetLastInstNums_(Enumerator *enumrtr) {
+  if (lastInstNums_ != NULL)
+    return lastInstNums_;
+
+  CopyLastInstNums_(enumrtr->histWndwBuf_, enumrtr->histWndwSize_);
+  return enumrtr->histWndwBuf_;
+}
+
 void HistEnumTreeNode::Init_() {
   time_ = 0;
-  inst_ = NULL;
+  instNum_ = SCHD_STALL;
   prevNode_ = NULL;
 #ifdef IS_DEBUG
   isCnstrctd_ = false;
 #endif
   crntCycleBlkd_ = false;
-  rsrvSlots_ = NULL;
+  hasRsrvSlots_ = false;
+  schduldCnt_ = 0;
+  lastInstNums_ = NULL;
+  instsSchduld_ = NULL;
+  rsrvEndCycles_ = NULL;
+  rtndChldCnt_ = 0;
+  isEvctd_ = false;
+  lastMatchTime_ = 0;
 }
 
 void HistEnumTreeNode::Clean() {
-  if (rsrvSlots_) {
-    delete[] rsrvSlots_;
-    rsrvSlots_ = NULL;
-  }
+  // The arrays belong to the enumerator's arenas or, for the temporary node,
+  // to the enumerator itself, so they are only forgotten here.
+  lastInstNums_ = NULL;
+  instsSchduld_ = NULL;
+  rsrvEndCycles_ = NULL;
+  suffix_ = nullptr;
+}
+
+void HistEnumTreeNode::FreeArrays(Enumerator *enumrtr) {
+  if (lastInstNums_ != NULL)
+    enumrtr->histInstNumsAlctr_->FreeArray(lastInstNums_);
+  if (instsSchduld_ != NULL)
+    enumrtr->histSchduldAlctr_->FreeArray(instsSchduld_);
+  if (rsrvEndCycles_ != NULL)
+    enumrtr->histRsrvAlctr_->FreeArray(rsrvEndCycles_);
+  lastInstNums_ = NULL;
+  instsSchduld_ = NULL;
+  rsrvEndCycles_ = NULL;
+}
+
+size_t HistEnumTreeNode::GetMemSize(Enumerator *enumrtr) {
+  return sizeof(HistEnumTreeNode) + GetAlctdMemSize_(enumrtr);
+}
+
+size_t HistEnumTreeNode::GetAlctdMemSize_(Enumerator *enumrtr) {
+  size_t size = 0;
+  if (lastInstNums_ != NULL)
+    size += enumrtr->histWndwSize_ * sizeof(InstCount) +
+            enumrtr->histSchduldWordCnt_ * sizeof(uint64_t);
+  if (rsrvEndCycles_ != NULL)
+    size += enumrtr->issuRate_ * sizeof(InstCount);
+  // The suffix may be shared with other nodes, in which case it is counted
+  // more than once.
+  if (suffix_ != nullptr)
+    size += sizeof(*suffix_) + suffix_->capacity() * sizeof(SchedInstruction *);
+  return size;
 }
 
 InstCount HistEnumTreeNode::SetLastInsts_(SchedInstruction *lastInsts[],
+                                          const InstCount *instNums,
                                           InstCount thisTime,
-                                          InstCount minTimeToExmn) {
+                                          InstCount minTimeToExmn,
+                                          Enumerator *enumrtr) {
   assert(minTimeToExmn >= 1);
   assert(lastInsts != NULL);
+  assert(thisTime - minTimeToExmn < enumrtr->histWndwSize_);
 
-  HistEnumTreeNode *crntNode;
   InstCount indx;
   InstCount time;
-  for (crntNode = this, time = thisTime, indx = 0; time >= minTimeToExmn;
-       crntNode = crntNode->prevNode_, indx++, time--) {
-    // Trace back the predecessors of the node to examine all the
-    // instructions in its partial schedule
-    assert(crntNode->prevNode_ != NULL);
-    assert(crntNode->GetTime() == thisTime - indx);
-    SchedInstruction *inst = crntNode->inst_;
-    assert(indx < (thisTime - minTimeToExmn + 1));
-    lastInsts[indx] = inst;
+  for (time = thisTime, indx = 0; time >= minTimeToExmn; indx++, time--) {
+    // The node may have been archived by another thread enumerating a copy of
+    // this region, so look up the instruction in the enumerator's own graph.
+    InstCount instNum = instNums[indx];
+    lastInsts[indx] = instNum == SCHD_STALL
+                          ? NULL
+                          : enumrtr->dataDepGraph_->GetInstByIndx(instNum);
   }
 
   return indx;
 }
 
-void HistEnumTreeNode::SetInstsSchduld_(BitVector *instsSchduld) {
-  instsSchduld->Reset();
-  HistEnumTreeNode *crntNode;
-
-  for (crntNode = this; crntNode != NULL; crntNode = crntNode->prevNode_) {
-    SchedInstruction *inst = crntNode->inst_;
-
-    if (inst != NULL) {
-      assert(!instsSchduld->GetBit(inst->GetNum()));
-      instsSchduld->SetBit(inst->GetNum());
-    }
-  }
-}
-
-void HistEnumTreeNode::SetLwrBounds_(InstCount lwrBounds[],
-                                     SchedInstruction *lastInsts[],
-                                     InstCount thisTime,
-                                     InstCount minTimeToExmn,
-                                     Enumerator *enumrtr) {
-  InstCount instCnt = enumrtr->totInstCnt_;
-
-  for (InstCount i = 0; i < instCnt; i++) {
-    lwrBounds[i] = 0;
-  }
-
-  InstCount entryCnt = SetLastInsts_(lastInsts, thisTime, minTimeToExmn);
-
-  for (InstCount indx = 0; indx < entryCnt; indx++) {
-    InstCount time = thisTime - indx;
-    InstCount cycleNum = enumrtr->GetCycleNumFrmTime_(time);
-    SchedInstruction *inst = lastInsts[indx];
-
-    // If an instruction is scheduled after its static lower bound then its
-    // successors will potentially be pushed down and should be checked.
-    if (inst != NULL && cycleNum > inst->GetLwrBound(DIR_FRWRD)) {
-      UDT_GLABEL ltncy;
-      DependenceType depType;
-
-      // Examine all the unscheduled successors of this instruction
-      // to see if any of them is pushed down.
-      for (SchedInstruction *scsr = inst->GetFrstScsr(NULL, &ltncy, &depType);
-           scsr != NULL; scsr = inst->GetNxtScsr(NULL, &ltncy, &depType)) {
-        if (scsr->IsSchduld() == false) {
-          InstCount num = scsr->GetNum();
-          InstCount thisBound = cycleNum + ltncy;
-          if (thisBound > lwrBounds[num])
-            lwrBounds[num] = thisBound;
-        }
-      }
-    }
-  }
-}
-
 InstCount HistEnumTreeNode::GetMinTimeToExmn_(InstCount nodeTime,
                                               Enumerator *enumrtr) {
   int issuRate = enumrtr->issuRate_;
@@ -155,34 +219,18 @@ InstCount HistEnumTreeNode::GetMinTimeToExmn_(InstCount nodeTime,
   return minTimeToExmn;
 }
 
-bool HistEnumTreeNode::DoesDominate_(EnumTreeNode *node,
-                                     HistEnumTreeNode *othrHstry,
-                                     ENUMTREE_NODEMODE mode,
-                                     Enumerator *enumrtr, InstCount shft) {
+bool HistEnumTreeNode::DoesDominate_(EnumTreeNode *node, Enumerator *enumrtr,
+                                     InstCount shft) {
   InstCount indx, time;
-  InstCount *othrLwrBounds = NULL;
   InstCount thisTime, othrTime;
   SchedInstruction **lastInsts = enumrtr->lastInsts_;
-  SchedInstruction **othrLastInsts = enumrtr->othrLastInsts_;
   InstCount *instsPerType = enumrtr->histInstsPerType_;
   InstCount *nxtAvlblCycles = enumrtr->histNxtAvlblCycles_;
-  bool othrCrntCycleBlkd;
 
-  assert(othrHstry != this);
+  assert(node != NULL);
   thisTime = GetTime();
-
-  if (mode == ETN_ACTIVE) {
-    assert(node != NULL && othrHstry == NULL);
-    othrLwrBounds = node->frwrdLwrBounds_;
-    othrTime = node->GetTime();
-    othrCrntCycleBlkd = node->crntCycleBlkd_;
-  } else {
-    assert(mode == ETN_HISTORY);
-    assert(othrHstry != NULL && node == NULL && enumrtr != NULL);
-    othrLwrBounds = enumrtr->tmpLwrBounds_;
-    othrTime = othrHstry->GetTime();
-    othrCrntCycleBlkd = othrHstry->crntCycleBlkd_;
-  }
+  othrTime = node->GetTime();
+  bool othrCrntCycleBlkd = node->crntCycleBlkd_;
 
   // We cannot make a decision about domination if the candidate dominant
   // node lies deeper in the enumeration tree than the node in question.
@@ -198,15 +246,15 @@ bool HistEnumTreeNode::DoesDominate_(EnumTreeNode *node,
   if (othrCrntCycleBlkd != crntCycleBlkd_)
     return false;
 
-  if (rsrvSlots_ != NULL) {
+  if (hasRsrvSlots_) {
     if (node->rsrvSlots_ == NULL)
       return false;
 
-    int issuRate = node->enumrtr_->machMdl_->GetIssueRate();
+    int issuRate = enumrtr->issuRate_;
     for (int i = 0; i < issuRate; i++) {
-      if (rsrvSlots_[i].strtCycle != INVALID_VALUE) {
+      if (rsrvEndCycles_[i] != INVALID_VALUE) {
         if (node->rsrvSlots_[i].strtCycle == INVALID_VALUE ||
-            rsrvSlots_[i].endCycle > node->rsrvSlots_[i].endCycle)
+            rsrvEndCycles_[i] > node->rsrvSlots_[i].endCycle)
           return false;
       }
     }
@@ -215,18 +263,15 @@ bool HistEnumTreeNode::DoesDominate_(EnumTreeNode *node,
   InstCount entryCnt;
   InstCount minTimeToExmn = GetMinTimeToExmn_(thisTime, enumrtr);
 
-  entryCnt = SetLastInsts_(lastInsts, thisTime, minTimeToExmn);
+  const InstCount *instNums = GetLastInstNums_(enumrtr);
+  entryCnt =
+      SetLastInsts_(lastInsts, instNums, thisTime, minTimeToExmn, enumrtr);
   assert(entryCnt == thisTime - minTimeToExmn + 1);
 
   assert(lastInsts != NULL);
   bool isAbslutDmnnt = true;
 
-  if (othrHstry != NULL) {
-    othrHstry->SetLwrBounds_(othrLwrBounds, othrLastInsts, othrTime,
-                             minTimeToExmn, enumrtr);
-  }
-
-  CmputNxtAvlblCycles_(enumrtr, instsPerType, nxtAvlblCycles);
+  CmputNxtAvlblCycles_(enumrtr, instNums, instsPerType, nxtAvlblCycles);
 
   for (indx = 0; indx < entryCnt; indx++) {
     time = thisTime - indx;
@@ -245,7 +290,6 @@ bool HistEnumTreeNode::DoesDominate_(EnumTreeNode *node,
            scsr != NULL; scsr = inst->GetNxtScsr(NULL, &ltncy, &depType)) {
         if (scsr->IsSchduld() == false) {
           InstCount nxtAvlblCycle = nxtAvlblCycles[scsr->GetIssueType()];
-          InstCount num = scsr->GetNum();
           InstCount thisBound = cycleNum + ltncy;
           thisBound = std::max(thisBound, nxtAvlblCycle);
           InstCount sttcBound = scsr->GetLwrBound(DIR_FRWRD);
@@ -253,7 +297,9 @@ bool HistEnumTreeNode::DoesDominate_(EnumTreeNode *node,
 
           if (thisBound > normBound || shft > 0) {
             isAbslutDmnnt = false;
-            InstCount othrBound = othrLwrBounds[num];
+            // The node is the one being probed, so the instructions hold its
+            // lower bounds.
+            InstCount othrBound = scsr->GetCrntLwrBound(DIR_FRWRD);
 
             if ((thisBound + shft) > othrBound)
               return false;
@@ -269,7 +315,7 @@ bool HistEnumTreeNode::DoesDominate_(EnumTreeNode *node,
   }
 
   // If this node is an absolute dominant that dominates any matching node.
-  if (isAbslutDmnnt)
+  if (isAbslutDmnnt && enumrtr->rcrdStats_)
     stats::absoluteDominationHits++;
 
   // PrntPartialSched(enumrtr);
@@ -277,12 +323,12 @@ bool HistEnumTreeNode::DoesDominate_(EnumTreeNode *node,
 }
 
 void HistEnumTreeNode::CmputNxtAvlblCycles_(Enumerator *enumrtr,
+                                            const InstCount *instNums,
                                             InstCount instsPerType[],
                                             InstCount nxtAvlblCycles[]) {
   InstCount thisTime = GetTime();
   InstCount crntCycle = enumrtr->GetCycleNumFrmTime_(thisTime);
-  HistEnumTreeNode *crntNode;
-  InstCount time;
+  InstCount indx, time;
   InstCount cycleNum = crntCycle;
 
   MachineModel *machMdl = enumrtr->machMdl_;
@@ -293,16 +339,17 @@ void HistEnumTreeNode::CmputNxtAvlblCycles_(Enumerator *enumrtr,
     nxtAvlblCycles[i] = crntCycle;
   }
 
-  for (crntNode = this, time = thisTime;
-       crntNode != NULL && cycleNum == crntCycle;
-       crntNode = crntNode->prevNode_, time--) {
-    assert(crntNode->prevNode_ != NULL);
-    SchedInstruction *inst = crntNode->inst_;
+  for (indx = 0, time = thisTime; time >= 1 && cycleNum == crntCycle;
+       indx++, time--) {
+    assert(indx < enumrtr->histWndwSize_);
+    InstCount instNum = instNums[indx];
     cycleNum = enumrtr->GetCycleNumFrmTime_(time);
 
-    if (inst == NULL)
+    if (instNum == SCHD_STALL)
       continue;
 
+    SchedInstruction *inst = enumrtr->dataDepGraph_->GetInstByIndx(instNum);
+
     IssueType issuType = inst->GetIssueType();
     assert(issuType < issuTypeCnt);
     instsPerType[issuType]++;
@@ -318,18 +365,15 @@ bool HistEnumTreeNode::DoesDominate(EnumTreeNode *node, Enumerator *enumrtr) {
   assert(isCnstrctd_);
 #endif
   InstCount shft = 0;
-  return DoesDominate_(node, NULL, ETN_ACTIVE, enumrtr, shft);
+  return DoesDominate_(node, enumrtr, shft);
 }
 
 void HistEnumTreeNode::PrntPartialSched(std::ostream &out) {
   out << "\nPartial sched. at time " << GetTime() << " (add=" << (void *)this
       << "): ";
 
-  for (HistEnumTreeNode *node = this; node != NULL; node = node->GetParent()) {
-    InstCount instNum =
-        (node->inst_ == NULL) ? SCHD_STALL : node->inst_->GetNum();
-    out << instNum << ' ';
-  }
+  for (HistEnumTreeNode *node = this; node != NULL; node = node->GetParent())
+    out << node->instNum_ << ' ';
 }
 
 bool HistEnumTreeNode::CompPartialScheds(HistEnumTreeNode *othrHist) {
@@ -341,12 +385,7 @@ bool HistEnumTreeNode::CompPartialScheds(HistEnumTreeNode *othrHist) {
 
   for (HistEnumTreeNode *node = this, *othrNode = othrHist; node != NULL;
        node = node->GetParent(), othrNode = othrNode->GetParent()) {
-    InstCount thisInstNum =
-        node->inst_ == NULL ? SCHD_STALL : node->inst_->GetNum();
-    InstCount othrInstNum =
-        othrNode->inst_ == NULL ? SCHD_STALL : othrNode->inst_->GetNum();
-
-    if (thisInstNum != othrInstNum)
+    if (node->instNum_ != othrNode->instNum_)
       return false;
   }
 
@@ -414,7 +453,7 @@ bool CostHistEnumTreeNode::DoesDominate(EnumTreeNode *node,
 
   // If the history node does not dominate the current node, we cannot
   // draw any conclusion and no pruning can be done.
-  if (DoesDominate_(node, NULL, ETN_ACTIVE, enumrtr, shft) == false)
+  if (DoesDominate_(node, enumrtr, shft) == false)
     return false;
 
   // if the history node dominates the current node, and there is
@@ -637,27 +676,34 @@ void CostHistEnumTreeNode::SetCostInfo(EnumTreeNode *node, bool, Enumerator *) {
 #endif
 }
 
+size_t CostHistEnumTreeNode::GetMemSize(Enumerator *enumrtr) {
+  return sizeof(CostHistEnumTreeNode) + GetAlctdMemSize_(enumrtr);
+}
+
 InstCount HistEnumTreeNode::GetTime() { return time_; }
 
-InstCount HistEnumTreeNode::GetInstNum() {
-  return inst_ == NULL ? SCHD_STALL : inst_->GetNum();
-}
+InstCount HistEnumTreeNode::GetInstNum() { return instNum_; }
 
 bool HistEnumTreeNode::DoesMatch(EnumTreeNode *node, Enumerator *enumrtr) {
-  BitVector *instsSchduld = enumrtr->bitVctr1_;
-  BitVector *othrInstsSchduld = enumrtr->bitVctr2_;
-
-  assert(instsSchduld != NULL && othrInstsSchduld != NULL);
-  SetInstsSchduld_(instsSchduld);
-  node->hstry_->SetInstsSchduld_(othrInstsSchduld);
+  // The node being probed holds the temporary history node, which always
+  // has the complete set.
+  HistEnumTreeNode *othrNode = node->hstry_;
+  uint64_t *othrInstsSchduld = othrNode->instsSchduld_;
+  assert(othrInstsSchduld != NULL);
+  if (schduldCnt_ != othrNode->schduldCnt_)
+    return false;
 
-  return *othrInstsSchduld == *instsSchduld;
-}
+  // Since both sets are equally large, they are equal if every instruction
+  // scheduled up to this node is scheduled in the other node too.
+  HistEnumTreeNode *histNode = this;
+  for (; histNode->instsSchduld_ == NULL; histNode = histNode->prevNode_) {
+    InstCount instNum = histNode->instNum_;
+    if (instNum != SCHD_STALL && !BitWords::getBit(othrInstsSchduld, instNum))
+      return false;
+  }
 
-bool HistEnumTreeNode::IsDominated(EnumTreeNode *node, Enumerator *enumrtr) {
-  assert(node != NULL);
-  InstCount shft = 0;
-  return node->hstry_->DoesDominate_(NULL, this, ETN_HISTORY, enumrtr, shft);
+  return BitWords::isSubset(histNode->instsSchduld_, othrInstsSchduld,
+                            enumrtr->histSchduldWordCnt_);
 }
 
 HistEnumTreeNode *HistEnumTreeNode::GetParent() { return prevNode_; }
@@ -8,6 +8,7 @@
 #include <cstdlib>
 // For GetProcessorTime().
 #include "opt-sched/Scheduler/utilities.h"
+#include <mutex>
 
 using namespace llvm::opt_sched;
 
@@ -24,6 +25,11 @@ static const int MAX_MSGSIZE = 8000;
 // The current output stream.
 static std::ostream *logStream = &std::cerr;
 
+// Keeps the messages of threads that log at the same time, such as ACO run
+// alongside the enumerator, from interleaving. Recursive, since a malformed
+// event reports a fatal error while writing.
+static std::recursive_mutex outputLock;
+
 // The periodic logging callback.
 static void (*periodLogCallback)() = NULL;
 // The minimum length of (CPU) time between two calls to the periodic logging
@@ -36,6 +42,7 @@ static Milliseconds periodLogLastTime = 0;
 // the specified message with a title and timestamp. Exits the program with exit
 // code = 1 on fatal errors.
 static void Output(Logger::LOG_LEVEL level, bool timed, const char *message) {
+  std::lock_guard<std::recursive_mutex> guard(outputLock);
   const char *title = 0;
 
   switch (level) {
@@ -124,6 +131,7 @@ using Logger::detail::EventAttrValue;
 
 void Logger::detail::Event(
     const std::pair<EventAttrType, EventAttrValue> *attrs, size_t numAttrs) {
+  std::lock_guard<std::recursive_mutex> guard(outputLock);
   std::ostream &out = *logStream;
 
   // We alternate using ": " and ", " as the separators.
@@ -0,0 +1,20 @@
+#include "opt-sched/Scheduler/parallel_enum.h"
+
+using namespace llvm::opt_sched;
+
+bool SharedIncumbent::offer(InstCount Cost) {
+  InstCount Crnt = BestCost.load(std::memory_order_relaxed);
+  while (Cost < Crnt) {
+    if (BestCost.compare_exchange_weak(Crnt, Cost, std::memory_order_relaxed))
+      return true;
+  }
+  return false;
+}
+
+bool SubProblemPool::take(Prefix &P) {
+  size_t Indx = NxtSubProb.fetch_add(1, std::memory_order_relaxed);
+  if (Indx >= SubProbs.size())
+    return false;
+  P = SubProbs[Indx];
+  return true;
+}
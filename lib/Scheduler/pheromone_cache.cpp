@@ -0,0 +1,172 @@
+#include "opt-sched/Scheduler/pheromone_cache.h"
+#include "opt-sched/Scheduler/config.h"
+#include "opt-sched/Scheduler/data_dep.h"
+#include "opt-sched/Scheduler/logger.h"
+#include "opt-sched/Scheduler/random.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+using namespace llvm::opt_sched;
+
+// The files start with this, followed by the size of a cell, the DAG hash, the
+// length and characters of the DAG ID, the number of cells and the cells.
+static const char FileMagic[8] = {'O', 'S', 'P', 'H', 'E', 'R', '0', '1'};
+
+PheromoneCache::PheromoneCache(std::string Dir) : Dir(std::move(Dir)) {}
+
+PheromoneCache &PheromoneCache::getInstance() {
+  static PheromoneCache Cache([]() -> std::string {
+    std::string Dir = SchedulerOptions::getInstance().GetString(
+        "ACO_PHEROMONE_CACHE_DIR", "NONE");
+    return Dir == "NONE" ? "" : Dir;
+  }());
+  return Cache;
+}
+
+uint64_t PheromoneCache::hashDag(DataDepGraph *DDG) {
+  uint64_t Hash = RandomStream::MixSeed(0, DDG->GetInstCnt());
+  for (InstCount i = 0; i < DDG->GetInstCnt(); i++) {
+    SchedInstruction *Inst = DDG->GetInstByIndx(i);
+    const char *OpCode = Inst->GetOpCode();
+    Hash = RandomStream::MixSeedWithStr(Hash, OpCode ? OpCode : "");
+    for (GraphEdge &Edge : Inst->GetSuccessors())
+      if (!Edge.IsArtificial)
+        Hash = RandomStream::MixSeed(Hash, Edge.to->GetNum());
+  }
+  return Hash;
+}
+
+bool PheromoneCache::load(const std::string &DagID, uint64_t DagHash,
+                          MutableArrayRef<pheromone_cell_t> Tbl) {
+  std::lock_guard<std::mutex> Guard(Lock);
+  Key K(DagID, DagHash);
+  auto It = Tbls.find(K);
+  if (It == Tbls.end() && !Dir.empty()) {
+    std::vector<pheromone_cell_t> FileTbl;
+    if (readFile_(K, FileTbl)) {
+      insert_(K, std::move(FileTbl));
+      It = Tbls.find(K);
+    }
+  }
+
+  if (It == Tbls.end() || It->second.size() != Tbl.size())
+    return false;
+  std::copy(It->second.begin(), It->second.end(), Tbl.begin());
+  return true;
+}
+
+void PheromoneCache::store(const std::string &DagID, uint64_t DagHash,
+                           ArrayRef<pheromone_cell_t> Tbl) {
+  std::lock_guard<std::mutex> Guard(Lock);
+  Key K(DagID, DagHash);
+  insert_(K, std::vector<pheromone_cell_t>(Tbl.begin(), Tbl.end()));
+  if (!Dir.empty())
+    writeFile_(K, Tbl);
+}
+
+void PheromoneCache::insert_(const Key &K, std::vector<pheromone_cell_t> Tbl) {
+  auto It = Tbls.find(K);
+  if (It != Tbls.end()) {
+    CellCnt -= It->second.size();
+    Order.erase(std::find(Order.begin(), Order.end(), K));
+  }
+
+  CellCnt += Tbl.size();
+  Tbls[K] = std::move(Tbl);
+  Order.push_back(K);
+
+  // Always keep the newest table, even if it is larger than the limit.
+  while (CellCnt > MaxCellCnt && Order.size() > 1) {
+    auto Oldest = Tbls.find(Order.front());
+    CellCnt -= Oldest->second.size();
+    Tbls.erase(Oldest);
+    Order.pop_front();
+  }
+}
+
+std::string PheromoneCache::getPath_(const Key &K) const {
+  char Name[32];
+  std::snprintf(Name, sizeof(Name), "%016llx.pher",
+                static_cast<unsigned long long>(
+                    RandomStream::MixSeedWithStr(K.second, K.first.c_str())));
+  return Dir + "/" + Name;
+}
+
+bool PheromoneCache::readFile_(const Key &K,
+                               std::vector<pheromone_cell_t> &Tbl) const {
+  auto Buf = MemoryBuffer::getFile(getPath_(K));
+  if (!Buf)
+    return false;
+
+  const char *Crnt = (*Buf)->getBufferStart();
+  const char *End = (*Buf)->getBufferEnd();
+  auto read = [&](void *Dst, size_t Size) {
+    if (static_cast<size_t>(End - Crnt) < Size)
+      return false;
+    std::memcpy(Dst, Crnt, Size);
+    Crnt += Size;
+    return true;
+  };
+
+  // Files written by another build, or for another DAG whose name and hash
+  // share a file name, are ignored.
+  char Magic[sizeof(FileMagic)];
+  uint32_t CellSize, IDLen;
+  uint64_t Hash, Cnt;
+  if (!read(Magic, sizeof(Magic)) ||
+      std::memcmp(Magic, FileMagic, sizeof(Magic)) != 0 ||
+      !read(&CellSize, sizeof(CellSize)) ||
+      CellSize != sizeof(pheromone_cell_t) || !read(&Hash, sizeof(Hash)) ||
+      Hash != K.second || !read(&IDLen, sizeof(IDLen)) ||
+      IDLen != K.first.size() ||
+      static_cast<size_t>(End - Crnt) < IDLen ||
+      K.first.compare(0, IDLen, Crnt, IDLen) != 0)
+    return false;
+  Crnt += IDLen;
+
+  if (!read(&Cnt, sizeof(Cnt)) ||
+      static_cast<uint64_t>(End - Crnt) != Cnt * sizeof(pheromone_cell_t))
+    return false;
+  Tbl.resize(Cnt);
+  return read(Tbl.data(), Cnt * sizeof(pheromone_cell_t));
+}
+
+void PheromoneCache::writeFile_(const Key &K,
+                                ArrayRef<pheromone_cell_t> Tbl) const {
+  // Write to a temporary file and rename it, so that other processes reading
+  // the cache never see a partly written table.
+  std::string Path = getPath_(K);
+  int FD;
+  SmallString<128> TmpPath;
+  if (sys::fs::createUniqueFile(Path + "-%%%%%%.tmp", FD, TmpPath)) {
+    Logger::Info("Could not write the pheromone cache file %s.", Path.c_str());
+    return;
+  }
+
+  raw_fd_ostream Out(FD, /*shouldClose=*/true);
+  uint32_t CellSize = sizeof(pheromone_cell_t);
+  uint32_t IDLen = K.first.size();
+  uint64_t Cnt = Tbl.size();
+  Out.write(FileMagic, sizeof(FileMagic));
+  Out.write(reinterpret_cast<const char *>(&CellSize), sizeof(CellSize));
+  Out.write(reinterpret_cast<const char *>(&K.second), sizeof(K.second));
+  Out.write(reinterpret_cast<const char *>(&IDLen), sizeof(IDLen));
+  Out.write(K.first.data(), IDLen);
+  Out.write(reinterpret_cast<const char *>(&Cnt), sizeof(Cnt));
+  Out.write(reinterpret_cast<const char *>(Tbl.data()),
+            Tbl.size() * sizeof(pheromone_cell_t));
+  Out.close();
+
+  if (Out.has_error()) {
+    Out.clear_error();
+    sys::fs::remove(TmpPath);
+    return;
+  }
+  if (sys::fs::rename(TmpPath, Path))
+    sys::fs::remove(TmpPath);
+}
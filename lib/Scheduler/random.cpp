@@ -42,6 +42,9 @@ static uint32_t y[] = {
 // The last random number.
 static uint32_t randNum;
 
+// The seed last passed to SetSeed().
+static int32_t crntSeed;
+
 void GenerateNextNumber() {
   randNum = y[j] + y[k];
   y[k] = randNum;
@@ -53,6 +56,7 @@ void GenerateNextNumber() {
 }
 
 void RandomGen::SetSeed(int32_t iseed) {
+  crntSeed = iseed;
   j = 23;
   k = 54;
 
@@ -68,6 +72,8 @@ void RandomGen::SetSeed(int32_t iseed) {
   }
 }
 
+int32_t RandomGen::GetSeed() { return crntSeed; }
+
 uint32_t RandomGen::GetRand32WithinRange(uint32_t min, uint32_t max) {
   GenerateNextNumber();
   return randNum % (max - min + 1) + min;
@@ -103,3 +109,47 @@ void RandomGen::GetRandBits(uint16_t bitCnt, unsigned char *dest) {
     bytesNeeded -= bytesConsumed;
   }
 }
+
+// SplitMix64, which is used to fill the state of the streams from a seed.
+static uint64_t SplitMix64(uint64_t &x) {
+  uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+static uint64_t RotL(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+void RandomStream::Seed(uint64_t seed) {
+  for (uint64_t &word : state_)
+    word = SplitMix64(seed);
+}
+
+uint64_t RandomStream::GetRand64() {
+  uint64_t result = RotL(state_[1] * 5, 7) * 9;
+  uint64_t t = state_[1] << 17;
+
+  state_[2] ^= state_[0];
+  state_[3] ^= state_[1];
+  state_[1] ^= state_[2];
+  state_[0] ^= state_[3];
+  state_[2] ^= t;
+  state_[3] = RotL(state_[3], 45);
+
+  return result;
+}
+
+uint64_t RandomStream::MixSeed(uint64_t seed, uint64_t value) {
+  uint64_t x = seed ^ RotL(value, 32);
+  return SplitMix64(x);
+}
+
+uint64_t RandomStream::MixSeedWithStr(uint64_t seed, const char *str) {
+  // FNV-1a, which does not vary between runs or platforms.
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (; *str; str++) {
+    hash ^= (unsigned char)*str;
+    hash *= 0x100000001b3ULL;
+  }
+  return MixSeed(seed, hash);
+}
@@ -1,12 +1,30 @@
 #include "opt-sched/Scheduler/ready_list.h"
+#include "opt-sched/Scheduler/config.h"
 #include "opt-sched/Scheduler/data_dep.h"
 #include "opt-sched/Scheduler/logger.h"
 #include "opt-sched/Scheduler/utilities.h"
+#include <algorithm>
 
 using namespace llvm::opt_sched;
 
+static READY_LIST_ENGINE ParseRdyLstEngn(const std::string &engn) {
+  if (engn == "LINKED")
+    return RLE_LINKED;
+  else if (engn == "FLAT")
+    return RLE_FLAT;
+
+  llvm::report_fatal_error("Unrecognized ready list engine: " + engn, false);
+}
+
 ReadyList::ReadyList(DataDepGraph *dataDepGraph, SchedPriorities prirts) {
   prirts_ = prirts;
+  instStore_ = dataDepGraph->GetInstStore();
+  engn_ = ParseRdyLstEngn(SchedulerOptions::getInstance().GetString(
+      "READY_LIST_ENGINE", "LINKED"));
+  flatIndx_ = -1;
+  flatItrtrReset_ = true;
+  flatSeq_ = 0;
+  flatLowSeq_ = -1;
   int i;
   uint16_t totKeyBits = 0;
 
@@ -117,14 +135,39 @@ ReadyList::ReadyList(DataDepGraph *dataDepGraph, SchedPriorities prirts) {
 ReadyList::~ReadyList() { Reset(); }
 
 void ReadyList::Reset() {
+  // The entries of removed instructions are no longer in the list.
+  if (engn_ == RLE_LINKED)
+    for (const Change &chng : chngs_)
+      if (chng.kind == CK_RMV)
+        prirtyLst_.FreeEntry(chng.entry);
+  chngs_.clear();
+  svdStates_.clear();
+
   prirtyLst_.Reset();
+  flatLst_.clear();
+  flatIndx_ = -1;
+  flatItrtrReset_ = true;
+  flatSeq_ = 0;
+  flatLowSeq_ = -1;
   latestSubLst_.Reset();
 }
 
 void ReadyList::CopyList(ReadyList *otherList) {
   assert(prirtyLst_.GetElmntCnt() == 0);
   assert(latestSubLst_.GetElmntCnt() == 0);
+  assert(flatLst_.empty());
+  assert(svdStates_.empty());
   assert(otherList != NULL);
+  assert(otherList->engn_ == engn_);
+
+  if (engn_ == RLE_FLAT) {
+    flatLst_ = otherList->flatLst_;
+    flatIndx_ = otherList->flatIndx_;
+    flatItrtrReset_ = otherList->flatItrtrReset_;
+    flatSeq_ = otherList->flatSeq_;
+    flatLowSeq_ = otherList->flatLowSeq_;
+    return;
+  }
 
   // Copy the ready list and create the array of keyed entries. If a dynamic
   // heuristic is not used then the second parameter should be an empty array.
@@ -136,6 +179,7 @@ unsigned long ReadyList::CmputKey_(SchedInstruction *inst, bool isUpdate,
   unsigned long key = 0;
   int16_t keySize = 0;
   int i;
+  InstCount instNum = inst->GetNum();
   int16_t oldLastUseCnt, newLastUseCnt;
   changed = true;
   if (isUpdate)
@@ -146,11 +190,11 @@ unsigned long ReadyList::CmputKey_(SchedInstruction *inst, bool isUpdate,
     case LSH_CP:
     case LSH_CPR:
       AddPrirtyToKey_(key, keySize, crtclPathBits_,
-                      inst->GetCrtclPath(DIR_BKWRD), maxCrtclPath_);
+                      instStore_->crtclPathsFrmLeaf[instNum], maxCrtclPath_);
       break;
 
     case LSH_LUC:
-      oldLastUseCnt = inst->GetLastUseCnt();
+      oldLastUseCnt = instStore_->lastUseCnts[instNum];
       newLastUseCnt = inst->CmputLastUseCnt();
       if (newLastUseCnt != oldLastUseCnt)
         changed = true;
@@ -195,18 +239,23 @@ void ReadyList::AddLatestSubLists(LinkedList<SchedInstruction> *lst1,
     AddLatestSubList_(lst1);
   if (lst2 != NULL)
     AddLatestSubList_(lst2);
-  prirtyLst_.ResetIterator();
+  ResetIterator();
 }
 
 void ReadyList::Print(std::ostream &out) {
   out << "Ready List: ";
-  for (const auto *crntInst = prirtyLst_.GetFrstElmnt(); crntInst != NULL;
-       crntInst = prirtyLst_.GetNxtElmnt()) {
-    out << " " << crntInst->GetNum();
+  if (engn_ == RLE_FLAT) {
+    for (const FlatEntry &entry : flatLst_)
+      out << " " << entry.inst->GetNum();
+  } else {
+    for (const auto *crntInst = prirtyLst_.GetFrstElmnt(); crntInst != NULL;
+         crntInst = prirtyLst_.GetNxtElmnt()) {
+      out << " " << crntInst->GetNum();
+    }
   }
   out << '\n';
 
-  prirtyLst_.ResetIterator();
+  ResetIterator();
 }
 
 void ReadyList::AddLatestSubList_(LinkedList<SchedInstruction> *lst) {
@@ -225,12 +274,13 @@ void ReadyList::AddLatestSubList_(LinkedList<SchedInstruction> *lst) {
     // ready list already.
     if (crntInst->IsInReadyList())
       break;
-    AddInst(crntInst);
+    AddInst_(crntInst, CK_INSRT_LATEST);
 #ifdef IS_DEBUG_READY_LIST2
     Logger::GetLogStream() << crntInst->GetNum() << ", ";
 #endif
     crntInst->PutInReadyList();
-    latestSubLst_.InsrtElmnt(crntInst);
+    if (svdStates_.empty())
+      latestSubLst_.InsrtElmnt(crntInst);
   }
 
 #ifdef IS_DEBUG_READY_LIST2
@@ -257,19 +307,123 @@ void ReadyList::RemoveLatestSubList() {
 #endif
 }
 
-void ReadyList::ResetIterator() { prirtyLst_.ResetIterator(); }
+void ReadyList::ResetIterator() {
+  prirtyLst_.ResetIterator();
+  flatIndx_ = -1;
+  flatItrtrReset_ = true;
+}
+
+void ReadyList::SaveState() {
+  svdStates_.push_back({chngs_.size(), prirtyLst_.GetItrtrState(), flatIndx_,
+                        flatItrtrReset_});
+  latestSubLst_.Reset();
+}
+
+void ReadyList::RestoreState() {
+  assert(!svdStates_.empty());
+  const SavedState &state = svdStates_.back();
+
+  while (chngs_.size() > state.chngCnt) {
+    const Change &chng = chngs_.back();
+    if (chng.kind == CK_INSRT_LATEST) {
+      assert(chng.inst->IsInReadyList());
+      chng.inst->RemoveFromReadyList();
+    }
+    if (engn_ == RLE_FLAT)
+      UndoFlatChange_(chng);
+    else
+      UndoLinkedChange_(chng);
+    chngs_.pop_back();
+  }
+
+  prirtyLst_.SetItrtrState(state.itrtr);
+  flatIndx_ = state.flatIndx;
+  flatItrtrReset_ = state.flatItrtrReset;
+  svdStates_.pop_back();
+}
+
+void ReadyList::UndoLinkedChange_(const Change &chng) {
+  switch (chng.kind) {
+  case CK_INSRT:
+  case CK_INSRT_LATEST:
+    prirtyLst_.RmvEntry(chng.entry);
+    break;
+  case CK_RMV:
+    prirtyLst_.RestoreEntry(chng.entry, chng.key, chng.next);
+    // The instruction may have been added again since, with another entry.
+    if (prirts_.isDynmc)
+      keyedEntries_[chng.inst->GetNum()] = chng.entry;
+    break;
+  case CK_KEY:
+    prirtyLst_.RmvEntry(chng.entry, false);
+    prirtyLst_.RestoreEntry(chng.entry, chng.key, chng.next);
+    break;
+  }
+}
+
+void ReadyList::UndoFlatChange_(const Change &chng) {
+  switch (chng.kind) {
+  case CK_INSRT:
+  case CK_INSRT_LATEST:
+    RmvFlatEntry_(chng.key, chng.seq);
+    break;
+  case CK_RMV:
+    InsrtFlatEntry_({chng.inst, chng.key, chng.seq});
+    break;
+  case CK_KEY:
+    RmvFlatEntry_(chng.newKey, chng.newSeq);
+    InsrtFlatEntry_({chng.inst, chng.key, chng.seq});
+    break;
+  }
+}
+
+void ReadyList::RecordChange_(const Change &chng) {
+  if (!svdStates_.empty())
+    chngs_.push_back(chng);
+}
 
-void ReadyList::AddInst(SchedInstruction *inst) {
+int ReadyList::GetFlatPos_(unsigned long key, long seq) const {
+  auto pos = std::lower_bound(flatLst_.begin(), flatLst_.end(),
+                              FlatEntry{NULL, key, seq},
+                              [](const FlatEntry &a, const FlatEntry &b) {
+                                return a.key > b.key ||
+                                       (a.key == b.key && a.seq < b.seq);
+                              });
+  return pos - flatLst_.begin();
+}
+
+void ReadyList::InsrtFlatEntry_(const FlatEntry &entry) {
+  flatLst_.insert(flatLst_.begin() + GetFlatPos_(entry.key, entry.seq), entry);
+}
+
+void ReadyList::RmvFlatEntry_(unsigned long key, long seq) {
+  int pos = GetFlatPos_(key, seq);
+  assert(pos < (int)flatLst_.size() && flatLst_[pos].seq == seq);
+  flatLst_.erase(flatLst_.begin() + pos);
+}
+
+void ReadyList::AddInst_(SchedInstruction *inst, CHANGE_KIND kind) {
   bool changed;
   unsigned long key = CmputKey_(inst, false, changed);
   assert(changed == true);
-  KeyedEntry<SchedInstruction, unsigned long> *entry =
-      prirtyLst_.InsrtElmnt(inst, key, true);
-  InstCount instNum = inst->GetNum();
-  if (prirts_.isDynmc)
-    keyedEntries_[instNum] = entry;
+  Change chng = {kind, inst, key, key, 0, 0, NULL, NULL};
+
+  if (engn_ == RLE_FLAT) {
+    chng.seq = flatSeq_++;
+    InsrtFlatEntry_({inst, key, chng.seq});
+    flatItrtrReset_ = true;
+  } else {
+    chng.entry = prirtyLst_.InsrtElmnt(inst, key, true);
+    InstCount instNum = inst->GetNum();
+    if (prirts_.isDynmc)
+      keyedEntries_[instNum] = chng.entry;
+  }
+
+  RecordChange_(chng);
 }
 
+void ReadyList::AddInst(SchedInstruction *inst) { AddInst_(inst, CK_INSRT); }
+
 void ReadyList::AddList(LinkedList<SchedInstruction> *lst) {
   SchedInstruction *crntInst;
 
@@ -279,17 +433,32 @@ void ReadyList::AddList(LinkedList<SchedInstruction> *lst) {
       AddInst(crntInst);
     }
 
-  prirtyLst_.ResetIterator();
+  ResetIterator();
 }
 
-InstCount ReadyList::GetInstCnt() const { return prirtyLst_.GetElmntCnt(); }
+InstCount ReadyList::GetInstCnt() const {
+  if (engn_ == RLE_FLAT)
+    return flatLst_.size();
+  return prirtyLst_.GetElmntCnt();
+}
 
 SchedInstruction *ReadyList::GetNextPriorityInst() {
-  return prirtyLst_.GetNxtPriorityElmnt();
+  unsigned long key;
+  return GetNextPriorityInst(key);
 }
 
 SchedInstruction *ReadyList::GetNextPriorityInst(unsigned long &key) {
-  return prirtyLst_.GetNxtPriorityElmnt(key);
+  if (engn_ == RLE_LINKED)
+    return prirtyLst_.GetNxtPriorityElmnt(key);
+
+  flatIndx_ = flatItrtrReset_ ? 0 : flatIndx_ + 1;
+  flatItrtrReset_ = false;
+  if (flatIndx_ >= (int)flatLst_.size()) {
+    flatIndx_ = flatLst_.size();
+    return NULL;
+  }
+  key = flatLst_[flatIndx_].key;
+  return flatLst_[flatIndx_].inst;
 }
 
 void ReadyList::UpdatePriorities() {
@@ -297,18 +466,77 @@ void ReadyList::UpdatePriorities() {
 
   SchedInstruction *inst;
   bool instChanged = false;
+
+  if (engn_ == RLE_FLAT) {
+    bool anyChanged = false;
+    for (FlatEntry &entry : flatLst_) {
+      unsigned long key = CmputKey_(entry.inst, true, instChanged);
+      if (instChanged && key != entry.key) {
+        long seq = key > entry.key ? flatSeq_++ : flatLowSeq_--;
+        RecordChange_({CK_KEY, entry.inst, entry.key, key, entry.seq, seq,
+                       NULL, NULL});
+        entry.key = key;
+        entry.seq = seq;
+        anyChanged = true;
+      }
+    }
+    if (anyChanged) {
+      std::sort(flatLst_.begin(), flatLst_.end(),
+                [](const FlatEntry &a, const FlatEntry &b) {
+                  return a.key > b.key || (a.key == b.key && a.seq < b.seq);
+                });
+      flatItrtrReset_ = true;
+    }
+    return;
+  }
+
+  // Moving an entry may take it past others, so the entry that follows it is
+  // taken before it is moved.
+  KeyedEntry<SchedInstruction, unsigned long> *next;
   for (inst = prirtyLst_.GetFrstElmnt(); inst != NULL;
-       inst = prirtyLst_.GetNxtElmnt()) {
+       inst = next == NULL ? NULL : next->element) {
+    KeyedEntry<SchedInstruction, unsigned long> *entry =
+        keyedEntries_[inst->GetNum()];
+    next = entry->GetNext();
     unsigned long key = CmputKey_(inst, true, instChanged);
     if (instChanged) {
-      prirtyLst_.BoostEntry(keyedEntries_[inst->GetNum()], key);
+      RecordChange_({CK_KEY, inst, entry->key, key, 0, 0, entry, next});
+      prirtyLst_.BoostEntry(entry, key);
     }
   }
 }
 
-void ReadyList::RemoveNextPriorityInst() { prirtyLst_.RmvCrntElmnt(); }
+void ReadyList::RemoveNextPriorityInst() {
+  if (engn_ == RLE_FLAT) {
+    assert(0 <= flatIndx_ && flatIndx_ < (int)flatLst_.size());
+    const FlatEntry &entry = flatLst_[flatIndx_];
+    RecordChange_({CK_RMV, entry.inst, entry.key, entry.key, entry.seq, 0,
+                   NULL, NULL});
+    flatLst_.erase(flatLst_.begin() + flatIndx_);
+    flatIndx_--;
+    return;
+  }
+
+  if (svdStates_.empty()) {
+    prirtyLst_.RmvCrntElmnt();
+    return;
+  }
+
+  // Keep the entry so that it can be put back in place.
+  KeyedEntry<SchedInstruction, unsigned long> *next;
+  KeyedEntry<SchedInstruction, unsigned long> *entry =
+      prirtyLst_.DetachCrntEntry(next);
+  RecordChange_({CK_RMV, entry->element, entry->key, entry->key, 0, 0, entry,
+                 next});
+}
 
 bool ReadyList::FindInst(SchedInstruction *inst, int &hitCnt) {
+  if (engn_ == RLE_FLAT) {
+    hitCnt = std::count_if(
+        flatLst_.begin(), flatLst_.end(),
+        [inst](const FlatEntry &entry) { return entry.inst == inst; });
+    return hitCnt > 0;
+  }
   return prirtyLst_.FindElmnt(inst, hitCnt);
 }
 
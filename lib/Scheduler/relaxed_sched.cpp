@@ -1,10 +1,47 @@
 #include "opt-sched/Scheduler/relaxed_sched.h"
+#include "opt-sched/Scheduler/config.h"
 #include "opt-sched/Scheduler/logger.h"
 #include "opt-sched/Scheduler/utilities.h"
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 using namespace llvm::opt_sched;
 
+namespace {
+
+// Blocks the threads that call Wait() until all of them have. The waits are
+// expected to be short, so the threads spin instead of sleeping.
+class SpinBarrier {
+public:
+  explicit SpinBarrier(size_t thrdCnt) : thrdCnt_(thrdCnt) {}
+
+  void Wait() {
+    size_t gnrtn = gnrtn_.load(std::memory_order_acquire);
+
+    if (arrvdCnt_.fetch_add(1, std::memory_order_acq_rel) + 1 == thrdCnt_) {
+      arrvdCnt_.store(0, std::memory_order_relaxed);
+      gnrtn_.fetch_add(1, std::memory_order_release);
+      return;
+    }
+
+    while (gnrtn_.load(std::memory_order_acquire) == gnrtn) {
+      std::this_thread::yield();
+    }
+  }
+
+private:
+  const size_t thrdCnt_;
+  std::atomic<size_t> arrvdCnt_{0};
+  std::atomic<size_t> gnrtn_{0};
+};
+
+} // end anonymous namespace
+
+// Give each thread at least this many instructions per depth on average, so
+// that the threads are not mostly waiting for each other.
+static const size_t MIN_INSTS_PER_THRD_PER_DEPTH = 16;
+
 RelaxedScheduler::RelaxedScheduler(DataDepStruct *dataDepGraph,
                                    MachineModel *machMdl,
                                    InstCount schedUprBound, DIRECTION mainDir,
@@ -253,6 +290,9 @@ RJ_RelaxedScheduler::RJ_RelaxedScheduler(
     : RelaxedScheduler(dataDepGraph, machMdl, schedUprBound, mainDir, type,
                        maxInstCnt) {
   assert(instLst_->GetElmntCnt() == 0);
+  useIncrmntl_ = false;
+  hasRlxdSched_ = false;
+  rlxdLastCycle_ = INVALID_VALUE;
 }
 /*****************************************************************************/
 
@@ -282,6 +322,7 @@ void RJ_RelaxedScheduler::Initialize_(bool setPrirtyLst) {
 
   Reset_(0);
   chkdInstCnt_ = 0;
+  hasRlxdSched_ = false;
 
   if (useFxng_)
     for (InstCount i = 0; i < totInstCnt_; i++) {
@@ -362,6 +403,10 @@ bool RJ_RelaxedScheduler::SchdulAndChkFsblty(InstCount crntCycle,
 
   assert(schedType_ == RST_DYNMC && useFxng_);
   InitChkng_(crntCycle);
+
+  if (useIncrmntl_) {
+    ResetRlxdSched_();
+  }
 #ifdef IS_DEBUG
   InstCount iterNum = 0;
 #endif
@@ -383,6 +428,11 @@ bool RJ_RelaxedScheduler::SchdulAndChkFsblty(InstCount crntCycle,
     assert(inst->IsSchduld() == false);
     schedCycle = SchdulInst_(inst, crntCycle, lastCycle);
     inst->SetRlxdCycle(schedCycle);
+
+    if (useIncrmntl_) {
+      PlaceInst_(inst, schedCycle);
+    }
+
     schduldInstCnt_++;
     chkdInstCnt_++;
     delay = CmputDelay_(schedCycle, lastCycle, GetCrntLwrBound_(inst, opstDir));
@@ -407,10 +457,216 @@ bool RJ_RelaxedScheduler::SchdulAndChkFsblty(InstCount crntCycle,
   }
 
   EndChkng_(crntCycle);
+
+  if (useIncrmntl_) {
+    hasRlxdSched_ = fsbl;
+    rlxdCrntCycle_ = crntCycle;
+    rlxdLastCycle_ = lastCycle;
+  }
+
   return fsbl;
 }
 /*****************************************************************************/
 
+void RJ_RelaxedScheduler::SetIncrmntl(bool useIncrmntl) {
+  assert(useFxng_ || !useIncrmntl);
+  useIncrmntl_ = useIncrmntl;
+  hasRlxdSched_ = false;
+
+  if (useIncrmntl_) {
+    rlxdCycles_.resize(maxInstCnt_);
+    nxtInCell_.resize(maxInstCnt_);
+    prevInCell_.resize(maxInstCnt_);
+    cellUsage_.resize(issuTypeCnt_ * schedUprBound_);
+    cellHeads_.resize(issuTypeCnt_ * schedUprBound_);
+  }
+}
+/*****************************************************************************/
+
+bool RJ_RelaxedScheduler::ChkFsbltyIncrmntly(InstCount crntCycle,
+                                             InstCount lastCycle) {
+  if (hasRlxdSched_ && lastCycle == rlxdLastCycle_) {
+    assert(useIncrmntl_);
+
+    if (RepairRlxdSched_(crntCycle, lastCycle)) {
+      return true;
+    }
+  }
+
+  return SchdulAndChkFsblty(crntCycle, lastCycle);
+}
+/*****************************************************************************/
+
+void RJ_RelaxedScheduler::ResetRlxdSched_() {
+  std::fill(rlxdCycles_.begin(), rlxdCycles_.end(), INVALID_VALUE);
+  std::fill(cellUsage_.begin(), cellUsage_.end(), 0);
+  std::fill(cellHeads_.begin(), cellHeads_.end(), INVALID_VALUE);
+  unplcdInsts_.clear();
+  fxdCells_.clear();
+  hasRlxdSched_ = false;
+}
+/*****************************************************************************/
+
+void RJ_RelaxedScheduler::PlaceInst_(SchedInstruction *inst, InstCount cycle) {
+  InstCount indx = dataDepGraph_->GetInstIndx(inst);
+  InstCount cell = GetCell_(inst->GetIssueType(), cycle);
+  assert(rlxdCycles_[indx] == INVALID_VALUE);
+
+  rlxdCycles_[indx] = cycle;
+  cellUsage_[cell]++;
+  prevInCell_[indx] = INVALID_VALUE;
+  nxtInCell_[indx] = cellHeads_[cell];
+
+  if (cellHeads_[cell] != INVALID_VALUE) {
+    prevInCell_[cellHeads_[cell]] = indx;
+  }
+
+  cellHeads_[cell] = indx;
+}
+/*****************************************************************************/
+
+void RJ_RelaxedScheduler::UnplaceInst_(SchedInstruction *inst) {
+  InstCount indx = dataDepGraph_->GetInstIndx(inst);
+  InstCount cycle = rlxdCycles_[indx];
+
+  if (cycle == INVALID_VALUE) {
+    return;
+  }
+
+  InstCount cell = GetCell_(inst->GetIssueType(), cycle);
+  InstCount prev = prevInCell_[indx];
+  InstCount nxt = nxtInCell_[indx];
+
+  if (prev == INVALID_VALUE) {
+    cellHeads_[cell] = nxt;
+  } else {
+    nxtInCell_[prev] = nxt;
+  }
+
+  if (nxt != INVALID_VALUE) {
+    prevInCell_[nxt] = prev;
+  }
+
+  assert(cellUsage_[cell] > 0);
+  cellUsage_[cell]--;
+  rlxdCycles_[indx] = INVALID_VALUE;
+}
+/*****************************************************************************/
+
+void RJ_RelaxedScheduler::TightnReleaseTime(SchedInstruction *inst) {
+  if (!hasRlxdSched_) {
+    return;
+  }
+
+  InstCount indx = dataDepGraph_->GetInstIndx(inst);
+
+  if (rlxdCycles_[indx] != INVALID_VALUE &&
+      rlxdCycles_[indx] < GetCrntLwrBound_(inst, schedDir_)) {
+    UnplaceInst_(inst);
+    unplcdInsts_.push_back(inst);
+  }
+}
+/*****************************************************************************/
+
+bool RJ_RelaxedScheduler::RepairRlxdSched_(InstCount crntCycle,
+                                           InstCount lastCycle) {
+  DIRECTION opstDir = DirAcycGraph::ReverseDirection(schedDir_);
+
+  // Move the instructions out of the cycles that the search has passed since
+  // the last check. The cycles before the last check's current cycle are
+  // empty.
+  for (InstCount cycle = rlxdCrntCycle_; cycle < crntCycle; cycle++) {
+    for (IssueType issuType = 0; issuType < issuTypeCnt_; issuType++) {
+      InstCount cell = GetCell_(issuType, cycle);
+
+      while (cellHeads_[cell] != INVALID_VALUE) {
+        SchedInstruction *inst = dataDepGraph_->GetInstByIndx(cellHeads_[cell]);
+        UnplaceInst_(inst);
+        unplcdInsts_.push_back(inst);
+      }
+    }
+  }
+
+  rlxdCrntCycle_ = crntCycle;
+
+  // Move instructions out of the cells that fixed instructions took slots
+  // from until the rest fit.
+  for (InstCount cell : fxdCells_) {
+    IssueType issuType = cell / schedUprBound_;
+    InstCount cycle = cell % schedUprBound_;
+
+    while (cellUsage_[cell] > avlblSlots_[issuType][cycle]) {
+      SchedInstruction *inst = dataDepGraph_->GetInstByIndx(cellHeads_[cell]);
+      UnplaceInst_(inst);
+      unplcdInsts_.push_back(inst);
+    }
+  }
+
+  fxdCells_.clear();
+
+  // Place the displaced instructions earliest deadline first, each in the
+  // earliest cycle with a free slot. An instruction may be listed more than
+  // once, or have been fixed since it was listed.
+  std::sort(unplcdInsts_.begin(), unplcdInsts_.end(),
+            [&](SchedInstruction *a, SchedInstruction *b) {
+              InstCount aBound = GetCrntLwrBound_(a, opstDir);
+              InstCount bBound = GetCrntLwrBound_(b, opstDir);
+              return aBound != bBound ? aBound > bBound
+                                      : a->GetNum() < b->GetNum();
+            });
+
+  for (SchedInstruction *inst : unplcdInsts_) {
+    if (GetFix_(inst) ||
+        rlxdCycles_[dataDepGraph_->GetInstIndx(inst)] != INVALID_VALUE) {
+      continue;
+    }
+
+    IssueType issuType = inst->GetIssueType();
+    InstCount releaseTime =
+        std::max(GetCrntLwrBound_(inst, schedDir_), crntCycle);
+    InstCount deadline = lastCycle - GetCrntLwrBound_(inst, opstDir);
+    InstCount cycle = releaseTime;
+
+    while (cycle <= deadline &&
+           cellUsage_[GetCell_(issuType, cycle)] >=
+               avlblSlots_[issuType][cycle]) {
+      cycle++;
+    }
+
+    if (cycle > deadline) {
+      unplcdInsts_.clear();
+      hasRlxdSched_ = false;
+      return false;
+    }
+
+    PlaceInst_(inst, cycle);
+  }
+
+  unplcdInsts_.clear();
+
+#ifdef IS_DEBUG
+  // Every unfixed instruction sits between its release time and deadline, in
+  // a cell with a free slot for it.
+  for (InstCount i = 0; i < totInstCnt_; i++) {
+    SchedInstruction *inst = dataDepGraph_->GetInstByIndx(i);
+
+    if (GetFix_(inst) || !dataDepGraph_->IsInGraph(inst)) {
+      continue;
+    }
+
+    InstCount cycle = rlxdCycles_[i];
+    assert(cycle != INVALID_VALUE);
+    assert(cycle >= crntCycle && cycle >= GetCrntLwrBound_(inst, schedDir_));
+    assert(cycle <= lastCycle - GetCrntLwrBound_(inst, opstDir));
+    assert(cellUsage_[GetCell_(inst->GetIssueType(), cycle)] <=
+           avlblSlots_[inst->GetIssueType()][cycle]);
+  }
+#endif
+
+  return true;
+}
+/*****************************************************************************/
+
 bool RJ_RelaxedScheduler::CmputDynmcLwrBound(InstCount trgtLastCycle,
                                              InstCount trgtLwrBound,
                                              InstCount &schedLwrBound) {
@@ -562,6 +818,16 @@ bool RJ_RelaxedScheduler::FixInst(SchedInstruction *inst, InstCount cycle) {
   fxdInstCnt_++;
   schduldInstCnt_++;
   SetFix_(inst, true);
+
+  if (hasRlxdSched_) {
+    UnplaceInst_(inst);
+    InstCount cell = GetCell_(issuType, cycle);
+
+    if (cellUsage_[cell] > avlblSlots_[issuType][cycle]) {
+      fxdCells_.push_back(cell);
+    }
+  }
+
   return true;
 }
 /*****************************************************************************/
@@ -582,6 +848,10 @@ void RJ_RelaxedScheduler::UnFixInst(SchedInstruction *inst, InstCount cycle) {
   SetFix_(inst, false);
   fxdInstCnt_--;
   schduldInstCnt_--;
+
+  if (hasRlxdSched_) {
+    unplcdInsts_.push_back(inst);
+  }
 }
 /*****************************************************************************/
 
@@ -597,6 +867,9 @@ LC_RelaxedScheduler::LC_RelaxedScheduler(DataDepStruct *dataDepGraph,
   subGraphInstLst_ = new PriorityList<SchedInstruction>;
 
   schedDir_ = mainDir_;
+
+  thrdCnt_ = SchedulerOptions::getInstance().GetInt("LC_PARALLEL_THREADS", 1);
+  thrdCnt_ = std::max(thrdCnt_, 1);
 }
 /*****************************************************************************/
 
@@ -626,6 +899,15 @@ void LC_RelaxedScheduler::InitSubGraph_() {
 /*****************************************************************************/
 
 InstCount LC_RelaxedScheduler::FindSchedule() {
+  if (dataDepGraph_->GetType() == DGT_FULL) {
+    return FindFullGraphSchedule_();
+  }
+
+  return FindListSchedule_();
+}
+/*****************************************************************************/
+
+InstCount LC_RelaxedScheduler::FindListSchedule_() {
   SchedInstruction *inst = NULL;
   InstCount rcrsvLwrBound = 0;
 
@@ -692,6 +974,7 @@ InstCount LC_RelaxedScheduler::SchdulSubGraph_(SchedInstruction *leaf,
   */
 
   // Visit the nodes in topological order
+  assert(rcrsvPrdcsrLst != NULL);
   assert(graphType == DGT_SUB || rcrsvPrdcsrLst->GetFrstElmnt() == rootInst_);
 
   for (node = rcrsvPrdcsrLst->GetFrstElmnt(); node != NULL;
@@ -747,6 +1030,181 @@ InstCount LC_RelaxedScheduler::SchdulSubGraph_(SchedInstruction *leaf,
 }
 /*****************************************************************************/
 
+struct LC_RelaxedScheduler::SubGraphWrkr {
+  // The available slots of each issue type in each cycle and the next
+  // available cycle for each release time, indexed by issue type times the
+  // upper bound plus the cycle. Only the cycles up to lastCycle may differ
+  // from their initial values.
+  std::vector<int16_t> avlblSlots;
+  std::vector<InstCount> nxtAvlblCycles;
+  InstCount lastCycle;
+  // The instructions of the subgraph sorted by decreasing relative critical
+  // path, and the number of instructions with each critical path.
+  std::vector<SchedInstruction *> sortdInsts;
+  std::vector<InstCount> keyCnts;
+};
+/*****************************************************************************/
+
+InstCount LC_RelaxedScheduler::FindFullGraphSchedule_() {
+  DIRECTION trvrslDir = DirAcycGraph::ReverseDirection(schedDir_);
+  std::vector<InstCount> depths(totInstCnt_);
+  std::vector<std::vector<SchedInstruction *>> depthInsts;
+
+  Initialize_();
+
+  // The depth of an instruction is one more than the deepest of the direct
+  // neighbors it depends on.
+  for (InstCount i = 0; i < totInstCnt_; i++) {
+    SchedInstruction *inst = schedDir_ == DIR_FRWRD
+                                 ? dataDepGraph_->GetInstByTplgclOrdr(i)
+                                 : dataDepGraph_->GetInstByRvrsTplgclOrdr(i);
+    InstCount depth = 0;
+
+    for (GraphEdge &edge : trvrslDir == DIR_BKWRD ? inst->GetPredecessors()
+                                                  : inst->GetSuccessors()) {
+      GraphNode *nghbr = trvrslDir == DIR_BKWRD ? edge.from : edge.to;
+      depth = std::max(depth, depths[nghbr->GetNum()] + 1);
+    }
+
+    depths[inst->GetNum()] = depth;
+
+    if ((size_t)depth == depthInsts.size()) {
+      depthInsts.emplace_back();
+    }
+
+    depthInsts[depth].push_back(inst);
+  }
+
+  size_t thrdCnt =
+      totInstCnt_ / depthInsts.size() / MIN_INSTS_PER_THRD_PER_DEPTH;
+  thrdCnt = std::max<size_t>(std::min<size_t>(thrdCnt, thrdCnt_), 1);
+
+  std::vector<SubGraphWrkr> wrkrs(thrdCnt);
+  for (SubGraphWrkr &wrkr : wrkrs) {
+    wrkr.avlblSlots.resize(issuTypeCnt_ * schedUprBound_);
+    wrkr.nxtAvlblCycles.resize(issuTypeCnt_ * schedUprBound_);
+    wrkr.lastCycle = schedUprBound_ - 1;
+    wrkr.sortdInsts.reserve(totInstCnt_);
+    wrkr.keyCnts.resize(schedUprBound_ + 1);
+  }
+
+  SpinBarrier barrier(thrdCnt);
+  auto schdulSubGraphs = [&](size_t thrdNum) {
+    for (const std::vector<SchedInstruction *> &insts : depthInsts) {
+      for (size_t i = thrdNum; i < insts.size(); i += thrdCnt) {
+        InstCount lwrBound = SchdulFullSubGraph_(insts[i], wrkrs[thrdNum]);
+        SetCrntLwrBound_(insts[i], schedDir_, lwrBound);
+      }
+
+      // The next depth needs the bounds found by the other threads.
+      if (thrdCnt > 1) {
+        barrier.Wait();
+      }
+    }
+  };
+
+  std::vector<std::thread> thrds;
+  for (size_t i = 1; i < thrdCnt; i++) {
+    thrds.emplace_back(schdulSubGraphs, i);
+  }
+  schdulSubGraphs(0);
+  for (std::thread &thrd : thrds) {
+    thrd.join();
+  }
+
+  if (writeBack_) {
+    WriteBoundsBack_();
+  }
+
+  return GetCrntLwrBound_(leafInst_, schedDir_) + 1;
+}
+/*****************************************************************************/
+
+InstCount LC_RelaxedScheduler::SchdulFullSubGraph_(SchedInstruction *leaf,
+                                                   SubGraphWrkr &wrkr) {
+  DIRECTION trvrslDir = DirAcycGraph::ReverseDirection(schedDir_);
+  BitVector *isInSubGraph = leaf->GetRcrsvNghbrBitVector(trvrslDir);
+  InstCount maxDelay = 0;
+
+  if (leaf == rootInst_) {
+    return 0;
+  }
+
+  InstCount trgtLastCycle = PropagateLwrBound_(leaf, schedDir_);
+  assert(trgtLastCycle < schedUprBound_);
+
+  // Sort the subgraph by counting the instructions with each relative
+  // critical path, which is at most the leaf's release time. The order of
+  // the instructions with the same critical path does not matter, since the
+  // cycles taken by them do not depend on it.
+  std::fill(wrkr.keyCnts.begin(), wrkr.keyCnts.begin() + trgtLastCycle + 1, 0);
+  wrkr.keyCnts[0]++;
+
+  for (int num : isInSubGraph->GetSetBits()) {
+    SchedInstruction *inst = dataDepGraph_->GetInstByIndx(num);
+    InstCount rltvCP = inst->GetRltvCrtclPath(trvrslDir, leaf);
+    assert(rltvCP <= trgtLastCycle);
+    wrkr.keyCnts[rltvCP]++;
+  }
+
+  InstCount instCnt = 0;
+  for (InstCount key = trgtLastCycle; key >= 0; key--) {
+    InstCount keyCnt = wrkr.keyCnts[key];
+    wrkr.keyCnts[key] = instCnt;
+    instCnt += keyCnt;
+  }
+
+  wrkr.sortdInsts.resize(instCnt);
+
+  for (int num : isInSubGraph->GetSetBits()) {
+    SchedInstruction *inst = dataDepGraph_->GetInstByIndx(num);
+    InstCount rltvCP = inst->GetRltvCrtclPath(trvrslDir, leaf);
+    wrkr.sortdInsts[wrkr.keyCnts[rltvCP]++] = inst;
+  }
+
+  wrkr.sortdInsts[wrkr.keyCnts[0]++] = leaf;
+
+  // Reset the cycles used by the previous subgraph.
+  for (int16_t i = 0; i < issuTypeCnt_; i++) {
+    for (InstCount j = 0; j <= wrkr.lastCycle; j++) {
+      wrkr.avlblSlots[i * schedUprBound_ + j] =
+          (int16_t)slotsPerTypePerCycle_[i];
+      wrkr.nxtAvlblCycles[i * schedUprBound_ + j] = j;
+    }
+  }
+
+  wrkr.lastCycle = 0;
+
+  // Schedule the instructions as SchdulInst_() does.
+  for (SchedInstruction *inst : wrkr.sortdInsts) {
+    InstCount releaseTime = inst == leaf ? trgtLastCycle
+                                         : GetCrntLwrBound_(inst, schedDir_);
+    InstCount rltvCP =
+        inst == leaf ? 0 : inst->GetRltvCrtclPath(trvrslDir, leaf);
+    InstCount frstCell = inst->GetIssueType() * schedUprBound_;
+    int16_t *avlblSlots = &wrkr.avlblSlots[frstCell];
+    InstCount *nxtAvlblCycles = &wrkr.nxtAvlblCycles[frstCell];
+    InstCount schedCycle = nxtAvlblCycles[releaseTime];
+
+    while (avlblSlots[schedCycle] == 0) {
+      schedCycle++;
+      assert(schedCycle < schedUprBound_);
+    }
+
+    nxtAvlblCycles[releaseTime] = schedCycle;
+    avlblSlots[schedCycle]--;
+    wrkr.lastCycle = std::max(wrkr.lastCycle, schedCycle);
+
+    InstCount delay = CmputDelay_(schedCycle, trgtLastCycle, rltvCP);
+    if (delay > maxDelay) {
+      maxDelay = delay;
+    }
+  }
+
+  return trgtLastCycle + maxDelay;
+}
+/*****************************************************************************/
+
 InstCount LC_RelaxedScheduler::CmputReleaseTime_(SchedInstruction *inst) {
   InstCount newBound = PropagateLwrBound_(inst, schedDir_);
   SetCrntLwrBound_(inst, schedDir_, newBound);
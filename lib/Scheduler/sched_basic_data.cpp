@@ -29,24 +29,51 @@ SPILL_COST_FUNCTION llvm::opt_sched::ParseSCFName(const std::string &name) {
       "Unrecognized option for SPILL_COST_FUNCTION setting: " + name, false);
 }
 
+SchedInstStore::SchedInstStore(InstCount instCnt) { Resize(instCnt); }
+
+void SchedInstStore::Resize(InstCount instCnt) {
+  assert(instCnt >= 0);
+  frwrdLwrBounds.assign(instCnt, INVALID_VALUE);
+  bkwrdLwrBounds.assign(instCnt, INVALID_VALUE);
+  crntFrwrdLwrBounds.assign(instCnt, INVALID_VALUE);
+  crntBkwrdLwrBounds.assign(instCnt, INVALID_VALUE);
+  crntDeadlines.assign(instCnt, INVALID_VALUE);
+  schedCycles.assign(instCnt, SCHD_UNSCHDULD);
+  issuTypes.assign(instCnt, 0);
+  crtclPathsFrmRoot.assign(instCnt, INVALID_VALUE);
+  crtclPathsFrmLeaf.assign(instCnt, INVALID_VALUE);
+  lastUseCnts.assign(instCnt, 0);
+}
+
 SchedInstruction::SchedInstruction(InstCount num, const string &name,
                                    InstType instType, const string &opCode,
                                    InstCount maxInstCnt, int nodeID,
                                    InstCount fileSchedOrder,
                                    InstCount fileSchedCycle, InstCount fileLB,
-                                   InstCount fileUB, MachineModel *model)
+                                   InstCount fileUB, MachineModel *model,
+                                   SchedInstStore *store)
     : GraphNode(num, maxInstCnt) {
+  if (store == NULL) {
+    ownStore_ = llvm::make_unique<SchedInstStore>(1);
+    store_ = ownStore_.get();
+    storeIndx_ = 0;
+  } else {
+    assert(0 <= num && num < store->GetInstCnt());
+    store_ = store;
+    storeIndx_ = num;
+  }
+
   // Static data that is computed only once.
   name_ = name;
   opCode_ = opCode;
   instType_ = instType;
 
-  frwrdLwrBound_ = INVALID_VALUE;
-  bkwrdLwrBound_ = INVALID_VALUE;
+  store_->frwrdLwrBounds[storeIndx_] = INVALID_VALUE;
+  store_->bkwrdLwrBounds[storeIndx_] = INVALID_VALUE;
   abslutFrwrdLwrBound_ = INVALID_VALUE;
   abslutBkwrdLwrBound_ = INVALID_VALUE;
-  crtclPathFrmRoot_ = INVALID_VALUE;
-  crtclPathFrmLeaf_ = INVALID_VALUE;
+  store_->crtclPathsFrmRoot[storeIndx_] = INVALID_VALUE;
+  store_->crtclPathsFrmLeaf[storeIndx_] = INVALID_VALUE;
 
   ltncyPerPrdcsr_ = NULL;
   memAllocd_ = false;
@@ -66,7 +93,8 @@ SchedInstruction::SchedInstruction(InstCount num, const string &name,
 
   crntRange_ = new SchedRange(this);
 
-  crntSchedCycle_ = SCHD_UNSCHDULD;
+  store_->schedCycles[storeIndx_] = SCHD_UNSCHDULD;
+  store_->lastUseCnts[storeIndx_] = 0;
   crntRlxdCycle_ = SCHD_UNSCHDULD;
   sig_ = 0;
   preFxdCycle_ = INVALID_VALUE;
@@ -107,46 +135,48 @@ void SchedInstruction::SetupForSchdulng(InstCount instCnt, bool isCP_FromScsr,
 bool SchedInstruction::UseFileBounds() {
   bool match = true;
 #ifdef IS_DEBUG_BOUNDS
+  InstCount frwrdLwrBound = GetLwrBound(DIR_FRWRD);
+  InstCount bkwrdLwrBound = GetLwrBound(DIR_BKWRD);
   stats::totalInstructions++;
 
-  if (frwrdLwrBound_ == fileLwrBound_) {
+  if (frwrdLwrBound == fileLwrBound_) {
     stats::instructionsWithEqualLB++;
   }
 
-  if (fileLwrBound_ > frwrdLwrBound_) {
+  if (fileLwrBound_ > frwrdLwrBound) {
     stats::instructionsWithTighterFileLB++;
-    stats::cyclesTightenedForTighterFileLB += fileLwrBound_ - frwrdLwrBound_;
+    stats::cyclesTightenedForTighterFileLB += fileLwrBound_ - frwrdLwrBound;
   }
 
-  if (frwrdLwrBound_ > fileLwrBound_) {
+  if (frwrdLwrBound > fileLwrBound_) {
     stats::instructionsWithTighterRelaxedLB++;
-    stats::cyclesTightenedForTighterRelaxedLB += frwrdLwrBound_ - fileLwrBound_;
+    stats::cyclesTightenedForTighterRelaxedLB += frwrdLwrBound - fileLwrBound_;
   }
 
-  if (frwrdLwrBound_ != fileLwrBound_) {
+  if (frwrdLwrBound != fileLwrBound_) {
     match = false;
     Logger::Info("File LB =%d, Rec LB=%d, instNum=%d, pred Cnt=%d",
-                 fileLwrBound_, frwrdLwrBound_, num_, prdcsrCnt_);
+                 fileLwrBound_, frwrdLwrBound, num_, prdcsrCnt_);
   }
 
-  if (bkwrdLwrBound_ == fileUprBound_) {
+  if (bkwrdLwrBound == fileUprBound_) {
     stats::instructionsWithEqualUB++;
   }
 
-  if (fileUprBound_ > bkwrdLwrBound_) {
+  if (fileUprBound_ > bkwrdLwrBound) {
     stats::instructionsWithTighterFileUB++;
-    stats::cyclesTightenedForTighterFileUB += fileUprBound_ - bkwrdLwrBound_;
+    stats::cyclesTightenedForTighterFileUB += fileUprBound_ - bkwrdLwrBound;
   }
 
-  if (bkwrdLwrBound_ > fileUprBound_) {
+  if (bkwrdLwrBound > fileUprBound_) {
     stats::instructionsWithTighterRelaxedUB++;
-    stats::cyclesTightenedForTighterRelaxedUB += bkwrdLwrBound_ - fileUprBound_;
+    stats::cyclesTightenedForTighterRelaxedUB += bkwrdLwrBound - fileUprBound_;
   }
 
-  if (bkwrdLwrBound_ != fileUprBound_) {
+  if (bkwrdLwrBound != fileUprBound_) {
     match = false;
     Logger::Info("File UB =%d, Rec UB=%d, instNum=%d, pred Cnt=%d",
-                 fileUprBound_, bkwrdLwrBound_, num_, prdcsrCnt_);
+                 fileUprBound_, bkwrdLwrBound, num_, prdcsrCnt_);
   }
 #endif
   SetBounds(fileLwrBound_, fileUprBound_);
@@ -155,7 +185,7 @@ bool SchedInstruction::UseFileBounds() {
 
 bool SchedInstruction::InitForSchdulng(InstCount schedLngth,
                                        LinkedList<SchedInstruction> *fxdLst) {
-  crntSchedCycle_ = SCHD_UNSCHDULD;
+  store_->schedCycles[storeIndx_] = SCHD_UNSCHDULD;
   crntRlxdCycle_ = SCHD_UNSCHDULD;
 
   for (InstCount i = 0; i < prdcsrCnt_; i++) {
@@ -167,11 +197,12 @@ bool SchedInstruction::InitForSchdulng(InstCount schedLngth,
   minRdyCycle_ = INVALID_VALUE;
   unschduldPrdcsrCnt_ = prdcsrCnt_;
   unschduldScsrCnt_ = scsrCnt_;
-  lastUseCnt_ = 0;
+  store_->lastUseCnts[storeIndx_] = 0;
 
   if (schedLngth != INVALID_VALUE) {
-    bool fsbl = crntRange_->SetBounds(frwrdLwrBound_, bkwrdLwrBound_,
-                                      schedLngth, fxdLst);
+    bool fsbl = crntRange_->SetBounds(GetLwrBound(DIR_FRWRD),
+                                      GetLwrBound(DIR_BKWRD), schedLngth,
+                                      fxdLst);
     if (!fsbl)
       return false;
   }
@@ -449,13 +480,11 @@ SchedInstruction *SchedInstruction::GetNxtNghbr(DIRECTION dir,
 }
 
 InstCount SchedInstruction::CmputCrtclPathFrmRoot() {
-  crtclPathFrmRoot_ = CmputCrtclPath_(DIR_FRWRD);
-  return crtclPathFrmRoot_;
+  return store_->crtclPathsFrmRoot[storeIndx_] = CmputCrtclPath_(DIR_FRWRD);
 }
 
 InstCount SchedInstruction::CmputCrtclPathFrmLeaf() {
-  crtclPathFrmLeaf_ = CmputCrtclPath_(DIR_BKWRD);
-  return crtclPathFrmLeaf_;
+  return store_->crtclPathsFrmLeaf[storeIndx_] = CmputCrtclPath_(DIR_BKWRD);
 }
 
 InstCount
@@ -471,10 +500,6 @@ InstCount SchedInstruction::CmputCrtclPathFrmRcrsvScsr(SchedInstruction *ref) {
   return crtclPathFrmRcrsvScsr_[refInstNum];
 }
 
-InstCount SchedInstruction::GetCrtclPath(DIRECTION dir) const {
-  return dir == DIR_FRWRD ? crtclPathFrmRoot_ : crtclPathFrmLeaf_;
-}
-
 InstCount SchedInstruction::GetRltvCrtclPath(DIRECTION dir,
                                              SchedInstruction *ref) {
   InstCount refInstNum = ref->GetNum();
@@ -489,43 +514,41 @@ InstCount SchedInstruction::GetRltvCrtclPath(DIRECTION dir,
   }
 }
 
-InstCount SchedInstruction::GetLwrBound(DIRECTION dir) const {
-  return dir == DIR_FRWRD ? frwrdLwrBound_ : bkwrdLwrBound_;
-}
-
 void SchedInstruction::SetLwrBound(DIRECTION dir, InstCount bound,
                                    bool isAbslut) {
   if (dir == DIR_FRWRD) {
-    assert(!isAbslut || bound >= frwrdLwrBound_);
-    frwrdLwrBound_ = bound;
+    InstCount &frwrdLwrBound = store_->frwrdLwrBounds[storeIndx_];
+    assert(!isAbslut || bound >= frwrdLwrBound);
+    frwrdLwrBound = bound;
 
     if (isAbslut) {
       abslutFrwrdLwrBound_ = bound;
-      crntRange_->SetFrwrdBound(frwrdLwrBound_);
+      crntRange_->SetFrwrdBound(bound);
     }
   } else {
-    assert(!isAbslut || bound >= bkwrdLwrBound_);
-    bkwrdLwrBound_ = bound;
+    InstCount &bkwrdLwrBound = store_->bkwrdLwrBounds[storeIndx_];
+    assert(!isAbslut || bound >= bkwrdLwrBound);
+    bkwrdLwrBound = bound;
 
     if (isAbslut) {
       abslutBkwrdLwrBound_ = bound;
-      crntRange_->SetBkwrdBound(bkwrdLwrBound_);
+      crntRange_->SetBkwrdBound(bound);
     }
   }
 }
 
 void SchedInstruction::RestoreAbsoluteBounds() {
-  frwrdLwrBound_ = abslutFrwrdLwrBound_;
-  bkwrdLwrBound_ = abslutBkwrdLwrBound_;
-  crntRange_->SetBounds(frwrdLwrBound_, bkwrdLwrBound_);
+  store_->frwrdLwrBounds[storeIndx_] = abslutFrwrdLwrBound_;
+  store_->bkwrdLwrBounds[storeIndx_] = abslutBkwrdLwrBound_;
+  crntRange_->SetBounds(abslutFrwrdLwrBound_, abslutBkwrdLwrBound_);
 }
 
 void SchedInstruction::SetBounds(InstCount flb, InstCount blb) {
-  frwrdLwrBound_ = flb;
-  bkwrdLwrBound_ = blb;
+  store_->frwrdLwrBounds[storeIndx_] = flb;
+  store_->bkwrdLwrBounds[storeIndx_] = blb;
   abslutFrwrdLwrBound_ = flb;
   abslutBkwrdLwrBound_ = blb;
-  crntRange_->SetBounds(frwrdLwrBound_, bkwrdLwrBound_);
+  crntRange_->SetBounds(flb, blb);
 }
 
 bool SchedInstruction::PrdcsrSchduld(InstCount prdcsrNum, InstCount cycle,
@@ -562,39 +585,23 @@ bool SchedInstruction::ScsrSchduld() {
 
 void SchedInstruction::SetInstType(InstType type) { instType_ = type; }
 
-void SchedInstruction::SetIssueType(IssueType type) { issuType_ = type; }
-
-InstType SchedInstruction::GetInstType() const { return instType_; }
-
-IssueType SchedInstruction::GetIssueType() const { return issuType_; }
-
-bool SchedInstruction::IsSchduld(InstCount *cycle) const {
-  if (cycle)
-    *cycle = crntSchedCycle_;
-  return crntSchedCycle_ != SCHD_UNSCHDULD;
+void SchedInstruction::SetIssueType(IssueType type) {
+  store_->issuTypes[storeIndx_] = type;
 }
 
-InstCount SchedInstruction::GetSchedCycle() const { return crntSchedCycle_; }
+InstType SchedInstruction::GetInstType() const { return instType_; }
 
 InstCount SchedInstruction::GetSchedSlot() const { return crntSchedSlot_; }
 
-InstCount SchedInstruction::GetCrntDeadline() const {
-  return IsSchduld() ? crntSchedCycle_ : crntRange_->GetDeadline();
-}
-
-InstCount SchedInstruction::GetCrntReleaseTime() const {
-  return IsSchduld() ? crntSchedCycle_ : GetCrntLwrBound(DIR_FRWRD);
-}
-
 InstCount SchedInstruction::GetRlxdCycle() const {
-  return IsSchduld() ? crntSchedCycle_ : crntRlxdCycle_;
+  return IsSchduld() ? GetSchedCycle() : crntRlxdCycle_;
 }
 
 void SchedInstruction::SetRlxdCycle(InstCount cycle) { crntRlxdCycle_ = cycle; }
 
 void SchedInstruction::Schedule(InstCount cycleNum, InstCount slotNum) {
-  assert(crntSchedCycle_ == SCHD_UNSCHDULD);
-  crntSchedCycle_ = cycleNum;
+  assert(!IsSchduld());
+  store_->schedCycles[storeIndx_] = cycleNum;
   crntSchedSlot_ = slotNum;
 }
 
@@ -604,17 +611,13 @@ void SchedInstruction::PutInReadyList() { ready_ = true; }
 
 void SchedInstruction::RemoveFromReadyList() { ready_ = false; }
 
-InstCount SchedInstruction::GetCrntLwrBound(DIRECTION dir) const {
-  return crntRange_->GetLwrBound(dir);
-}
-
 void SchedInstruction::SetCrntLwrBound(DIRECTION dir, InstCount bound) {
   crntRange_->SetLwrBound(dir, bound);
 }
 
 void SchedInstruction::UnSchedule() {
-  assert(crntSchedCycle_ != SCHD_UNSCHDULD);
-  crntSchedCycle_ = SCHD_UNSCHDULD;
+  assert(IsSchduld());
+  store_->schedCycles[storeIndx_] = SCHD_UNSCHDULD;
   crntSchedSlot_ = SCHD_UNSCHDULD;
 }
 
@@ -624,6 +627,10 @@ void SchedInstruction::CmtLwrBoundTightnng() {
   crntRange_->CmtLwrBoundTightnng();
 }
 
+InstCount SchedInstruction::GetPrevLwrBound(DIRECTION dir) const {
+  return crntRange_->GetPrevLwrBound(dir);
+}
+
 void SchedInstruction::SetSig(InstSignature sig) { sig_ = sig; }
 
 InstSignature SchedInstruction::GetSig() const { return sig_; }
@@ -710,16 +717,16 @@ void SchedInstruction::SetPrdcsrNums_() {
 }
 
 int16_t SchedInstruction::CmputLastUseCnt() {
-  lastUseCnt_ = 0;
+  int16_t lastUseCnt = 0;
 
   for (int i = 0; i < useCnt_; i++) {
     Register *reg = uses_[i];
     assert(reg->GetCrntUseCnt() < reg->GetUseCnt());
     if (reg->GetCrntUseCnt() + 1 == reg->GetUseCnt())
-      lastUseCnt_++;
+      lastUseCnt++;
   }
 
-  return lastUseCnt_;
+  return store_->lastUseCnts[storeIndx_] = lastUseCnt;
 }
 
 /******************************************************************************
@@ -729,18 +736,19 @@ int16_t SchedInstruction::CmputLastUseCnt() {
 SchedRange::SchedRange(SchedInstruction *inst) {
   InitVars_();
   inst_ = inst;
-  frwrdLwrBound_ = INVALID_VALUE;
-  bkwrdLwrBound_ = INVALID_VALUE;
+  store_ = inst->store_;
+  indx_ = inst->storeIndx_;
   lastCycle_ = INVALID_VALUE;
+  SetLwrBound_(DIR_FRWRD, INVALID_VALUE);
+  SetLwrBound_(DIR_BKWRD, INVALID_VALUE);
 }
 
 bool SchedRange::TightnLwrBound(DIRECTION dir, InstCount newBound,
                                 LinkedList<SchedInstruction> *tightndLst,
                                 LinkedList<SchedInstruction> *fxdLst,
                                 bool enforce) {
-  InstCount *boundPtr = (dir == DIR_FRWRD) ? &frwrdLwrBound_ : &bkwrdLwrBound_;
-  InstCount crntBound = *boundPtr;
-  InstCount othrBound = (dir == DIR_FRWRD) ? bkwrdLwrBound_ : frwrdLwrBound_;
+  InstCount crntBound = GetLwrBound(dir);
+  InstCount othrBound = GetLwrBound(dir == DIR_FRWRD ? DIR_BKWRD : DIR_FRWRD);
 
   assert(enforce || IsFsbl_());
   assert(newBound > crntBound);
@@ -780,7 +788,7 @@ bool SchedRange::TightnLwrBound(DIRECTION dir, InstCount newBound,
   }
 
   // Now change the bound to the new bound.
-  *boundPtr = newBound;
+  SetLwrBound_(dir, newBound);
 
   return fsbl;
 }
@@ -794,7 +802,7 @@ bool SchedRange::TightnLwrBoundRcrsvly(DIRECTION dir, InstCount newBound,
           ? +[](SchedRange &range) { return range.inst_->GetNxtScsrEdge(); }
           : +[](SchedRange &range) { return range.inst_->GetNxtPrdcsrEdge(); };
 
-  InstCount crntBound = (dir == DIR_FRWRD) ? frwrdLwrBound_ : bkwrdLwrBound_;
+  InstCount crntBound = GetLwrBound(dir);
   bool fsbl = IsFsbl_();
 
   assert(enforce || fsbl);
@@ -831,7 +839,7 @@ bool SchedRange::TightnLwrBoundRcrsvly(DIRECTION dir, InstCount newBound,
 
 bool SchedRange::Fix(InstCount cycle, LinkedList<SchedInstruction> *tightndLst,
                      LinkedList<SchedInstruction> *fxdLst) {
-  if (cycle < frwrdLwrBound_ || cycle > GetDeadline())
+  if (cycle < GetLwrBound(DIR_FRWRD) || cycle > GetDeadline())
     return false;
   InstCount backBnd = lastCycle_ - cycle;
   return (TightnLwrBoundRcrsvly(DIR_FRWRD, cycle, tightndLst, fxdLst, false) &&
@@ -840,18 +848,18 @@ bool SchedRange::Fix(InstCount cycle, LinkedList<SchedInstruction> *tightndLst,
 
 void SchedRange::SetBounds(InstCount frwrdLwrBound, InstCount bkwrdLwrBound) {
   InitVars_();
-  frwrdLwrBound_ = frwrdLwrBound;
-  bkwrdLwrBound_ = bkwrdLwrBound;
+  SetLwrBound_(DIR_FRWRD, frwrdLwrBound);
+  SetLwrBound_(DIR_BKWRD, bkwrdLwrBound);
 }
 
 bool SchedRange::SetBounds(InstCount frwrdLwrBound, InstCount bkwrdLwrBound,
                            InstCount schedLngth,
                            LinkedList<SchedInstruction> *fxdLst) {
   InitVars_();
-  frwrdLwrBound_ = frwrdLwrBound;
-  bkwrdLwrBound_ = bkwrdLwrBound;
   assert(schedLngth != INVALID_VALUE);
   lastCycle_ = schedLngth - 1;
+  SetLwrBound_(DIR_FRWRD, frwrdLwrBound);
+  SetLwrBound_(DIR_BKWRD, bkwrdLwrBound);
 
   if (!IsFsbl_())
     return false;
@@ -874,21 +882,30 @@ void SchedRange::InitVars_() {
 }
 
 void SchedRange::SetFrwrdBound(InstCount bound) {
-  assert(bound >= frwrdLwrBound_);
-  frwrdLwrBound_ = bound;
+  assert(bound >= GetLwrBound(DIR_FRWRD));
+  SetLwrBound_(DIR_FRWRD, bound);
 }
 
 void SchedRange::SetBkwrdBound(InstCount bound) {
-  assert(bound >= bkwrdLwrBound_);
-  bkwrdLwrBound_ = bound;
+  assert(bound >= GetLwrBound(DIR_BKWRD));
+  SetLwrBound_(DIR_BKWRD, bound);
+}
+
+void SchedRange::SetLwrBound_(DIRECTION dir, InstCount bound) {
+  if (dir == DIR_FRWRD) {
+    store_->crntFrwrdLwrBounds[indx_] = bound;
+  } else {
+    store_->crntBkwrdLwrBounds[indx_] = bound;
+    store_->crntDeadlines[indx_] = lastCycle_ - bound;
+  }
 }
 
 InstCount SchedRange::GetLwrBoundSum_() const {
-  return frwrdLwrBound_ + bkwrdLwrBound_;
+  return store_->crntFrwrdLwrBounds[indx_] + store_->crntBkwrdLwrBounds[indx_];
 }
 
 InstCount SchedRange::GetDeadline() const {
-  return lastCycle_ - bkwrdLwrBound_;
+  return store_->crntDeadlines[indx_];
 }
 
 bool SchedRange::IsFsbl_() const { return GetLwrBoundSum_() <= lastCycle_; }
@@ -898,14 +915,14 @@ void SchedRange::UnTightnLwrBounds() {
   assert(isFrwrdTightnd_ || isBkwrdTightnd_);
 
   if (isFrwrdTightnd_) {
-    assert(frwrdLwrBound_ != prevFrwrdLwrBound_);
-    frwrdLwrBound_ = prevFrwrdLwrBound_;
+    assert(GetLwrBound(DIR_FRWRD) != prevFrwrdLwrBound_);
+    SetLwrBound_(DIR_FRWRD, prevFrwrdLwrBound_);
     isFrwrdTightnd_ = false;
   }
 
   if (isBkwrdTightnd_) {
-    assert(bkwrdLwrBound_ != prevBkwrdLwrBound_);
-    bkwrdLwrBound_ = prevBkwrdLwrBound_;
+    assert(GetLwrBound(DIR_BKWRD) != prevBkwrdLwrBound_);
+    SetLwrBound_(DIR_BKWRD, prevBkwrdLwrBound_);
     isBkwrdTightnd_ = false;
   }
 
@@ -920,13 +937,14 @@ void SchedRange::CmtLwrBoundTightnng() {
 }
 
 InstCount SchedRange::GetLwrBound(DIRECTION dir) const {
-  return (dir == DIR_FRWRD) ? frwrdLwrBound_ : bkwrdLwrBound_;
+  return (dir == DIR_FRWRD) ? store_->crntFrwrdLwrBounds[indx_]
+                            : store_->crntBkwrdLwrBounds[indx_];
 }
 
 bool SchedRange::IsFxd() const { return lastCycle_ == GetLwrBoundSum_(); }
 
 void SchedRange::SetLwrBound(DIRECTION dir, InstCount bound) {
-  InstCount &crntBound = (dir == DIR_FRWRD) ? frwrdLwrBound_ : bkwrdLwrBound_;
+  InstCount crntBound = GetLwrBound(dir);
   bool &isTightnd = (dir == DIR_FRWRD) ? isFrwrdTightnd_ : isBkwrdTightnd_;
 
   if (isFxd_ && bound != crntBound) {
@@ -934,14 +952,16 @@ void SchedRange::SetLwrBound(DIRECTION dir, InstCount bound) {
     isFxd_ = false;
   }
 
-  crntBound = bound;
-#ifdef IS_DEBUG
-  InstCount crntBoundPtr = (dir == DIR_FRWRD) ? frwrdLwrBound_ : bkwrdLwrBound_;
-  assert(crntBoundPtr == bound);
-#endif
+  SetLwrBound_(dir, bound);
+  assert(GetLwrBound(dir) == bound);
   isTightnd = false;
 }
 
 bool SchedRange::IsTightnd(DIRECTION dir) const {
   return (dir == DIR_FRWRD) ? isFrwrdTightnd_ : isBkwrdTightnd_;
 }
+
+InstCount SchedRange::GetPrevLwrBound(DIRECTION dir) const {
+  assert(IsTightnd(dir));
+  return (dir == DIR_FRWRD) ? prevFrwrdLwrBound_ : prevBkwrdLwrBound_;
+}
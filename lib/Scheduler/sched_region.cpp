@@ -1,6 +1,9 @@
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdio>
 #include <memory>
+#include <thread>
 #include <utility>
 
 #include "Wrapper/OptSchedDDGWrapperBasic.h"
@@ -144,6 +147,17 @@ static bool isBbEnabled(Config &schedIni, Milliseconds rgnTimeout) {
   return true;
 }
 
+// Returns the deadline of an ACO run that starts now. ACO_TIME_BUDGET is the
+// percentage of the region timeout that each ACO run may take, or 0 for no
+// limit.
+static Milliseconds getAcoDeadline(Config &schedIni, Milliseconds rgnTimeout) {
+  int64_t budget = schedIni.GetInt("ACO_TIME_BUDGET", 0);
+  if (budget <= 0 || rgnTimeout <= 0)
+    return INVALID_VALUE;
+  return Utilities::GetProcessorTime() +
+         std::max<Milliseconds>(rgnTimeout * budget / 100, 1);
+}
+
 static void dumpDDG(DataDepGraph *DDG, llvm::StringRef DDGDumpPath,
                     llvm::StringRef Suffix = "") {
   std::string Path = DDGDumpPath;
@@ -200,6 +214,8 @@ FUNC_RESULT SchedRegion::FindOptimalSchedule(
 
   bool AcoBeforeEnum = false;
   bool AcoAfterEnum = false;
+  bool AcoPipelined = false;
+  SchedRegion *PipelinedAcoRgn = NULL;
 
   // Do we need to compute the graph's transitive closure?
   bool needTransitiveClosure = false;
@@ -211,7 +227,9 @@ FUNC_RESULT SchedRegion::FindOptimalSchedule(
   // 4) ACO
   // Each of these 4 algorithms can be individually disabled, but either the
   // heuristic scheduler or ACO before the branch & bound enumerator must be
-  // enabled.
+  // enabled. If ACO_PIPELINED is set, the ACO before the enumerator runs
+  // alongside it instead, and the enumerator starts from the heuristic
+  // schedule.
   Config &schedIni = SchedulerOptions::getInstance();
   bool HeuristicSchedulerEnabled = schedIni.GetBool("HEUR_ENABLED");
   bool AcoSchedulerEnabled = schedIni.GetBool("ACO_ENABLED");
@@ -220,6 +238,9 @@ FUNC_RESULT SchedRegion::FindOptimalSchedule(
   if (AcoSchedulerEnabled) {
     AcoBeforeEnum = schedIni.GetBool("ACO_BEFORE_ENUM");
     AcoAfterEnum = schedIni.GetBool("ACO_AFTER_ENUM");
+    AcoPipelined = AcoBeforeEnum && BbSchedulerEnabled &&
+                   HeuristicSchedulerEnabled &&
+                   schedIni.GetBool("ACO_PIPELINED", false);
   }
 
   if (!HeuristicSchedulerEnabled && !AcoBeforeEnum) {
@@ -417,12 +438,23 @@ FUNC_RESULT SchedRegion::FindOptimalSchedule(
                SpillCostLwrBound_);
 
   // Step #2: Use ACO to find a schedule if enabled and no optimal schedule is
-  // yet to be found.
-  if (AcoBeforeEnum && !isLstOptml) {
+  // yet to be found. Pipelined ACO only starts with the enumerator, but if it
+  // cannot be set up, ACO runs here instead.
+  if (AcoPipelined && !isLstOptml) {
+    PipelinedAcoRgn = SetupPipelinedAcoWrkr_();
+    if (!PipelinedAcoRgn) {
+      Logger::Info("Failed to set up pipelined ACO. Running ACO before the "
+                   "enumerator.");
+      AcoPipelined = false;
+    }
+  }
+
+  if (AcoBeforeEnum && !AcoPipelined && !isLstOptml) {
     AcoStart = Utilities::GetProcessorTime();
     AcoSchedule = new InstSchedule(machMdl_, dataDepGraph_, vrfySched_);
 
-    rslt = runACO(AcoSchedule, lstSched, false);
+    rslt = runACO(AcoSchedule, lstSched, false,
+                  getAcoDeadline(schedIni, rgnTimeout));
     if (rslt != RES_SUCCESS) {
       llvm::report_fatal_error("ACO scheduling failed", false);
       if (lstSchdulr)
@@ -462,9 +494,9 @@ FUNC_RESULT SchedRegion::FindOptimalSchedule(
   // was found.
   if (!isLstOptml) {
     // There are 3 possible situations:
-    // A) ACO was never run. In that case, just use Heuristic and run with its
-    // results, into B&B.
-    if (!AcoBeforeEnum) {
+    // A) ACO was never run, or runs alongside B&B. In that case, just use
+    // Heuristic and run with its results, into B&B.
+    if (!AcoBeforeEnum || AcoPipelined) {
       bestSched = bestSched_ = lstSched;
       bestSchedLngth_ = heuristicScheduleLength;
       bestCost_ = hurstcCost_;
@@ -509,6 +541,8 @@ FUNC_RESULT SchedRegion::FindOptimalSchedule(
 #endif
 
   if (EnableEnum_() == false) {
+    if (PipelinedAcoRgn)
+      FreePipelinedAcoWrkr_();
     delete lstSchdulr;
     return RES_FAIL;
   }
@@ -527,12 +561,24 @@ FUNC_RESULT SchedRegion::FindOptimalSchedule(
     Milliseconds enumStart = Utilities::GetProcessorTime();
     if (!isLstOptml) {
       dataDepGraph_->SetHard(true);
+      AcoPipeline *Pipeline = NULL;
+      if (PipelinedAcoRgn)
+        Pipeline = StartPipelinedAco_(PipelinedAcoRgn, lstSched,
+                                      getAcoDeadline(schedIni, rgnTimeout));
+
       if (IsSecondPass() && dataDepGraph_->GetMaxLtncy() <= 1)
         Logger::Info("Problem size not increased after introducing latencies, "
                      "skipping second pass enumeration");
       else
         rslt = Optimize_(enumStart, rgnTimeout, lngthTimeout);
 
+      if (Pipeline) {
+        AcoSchedule = FinishPipelinedAco_(Pipeline);
+        if (AcoSchedule == NULL)
+          llvm::report_fatal_error("ACO scheduling failed", false);
+        AcoScheduleCost_ = AcoSchedule->GetCost();
+      }
+
       Milliseconds enumTime = Utilities::GetProcessorTime() - enumStart;
 
       // TODO: Implement this stat for ACO also.
@@ -548,6 +594,18 @@ FUNC_RESULT SchedRegion::FindOptimalSchedule(
         enumBestSched_->Print(Logger::GetLogStream(), "Optimal");
 #endif
       }
+
+      // The enumerator only looked for schedules better than the ones that
+      // the pipelined ACO found, so the best of those is kept if it was not
+      // beaten.
+      if (AcoSchedule && AcoScheduleCost_ < bestCost_) {
+        Logger::Info("Pipelined ACO found the best schedule, with cost %d.",
+                     AcoScheduleCost_);
+        bestSched = bestSched_ = AcoSchedule;
+        bestCost_ = AcoScheduleCost_;
+        bestSchedLngth_ = AcoSchedule->GetCrntLngth();
+        BestSpillCost_ = AcoSchedule->GetSpillCost();
+      }
     } else if (rgnTimeout == 0) {
       Logger::Event("BypassZeroTimeLimit", "cost", bestCost_);
       // TODO(justin): Remove once relevant scripts have been updated:
@@ -601,7 +659,8 @@ FUNC_RESULT SchedRegion::FindOptimalSchedule(
     InstSchedule *AcoAfterEnumSchedule =
         new InstSchedule(machMdl_, dataDepGraph_, vrfySched_);
 
-    FUNC_RESULT acoRslt = runACO(AcoAfterEnumSchedule, bestSched, true);
+    FUNC_RESULT acoRslt = runACO(AcoAfterEnumSchedule, bestSched, true,
+                                 getAcoDeadline(schedIni, rgnTimeout));
     if (acoRslt != RES_SUCCESS) {
       Logger::Info("Running final ACO failed");
       delete AcoAfterEnumSchedule;
@@ -789,8 +848,16 @@ FUNC_RESULT SchedRegion::Optimize_(Milliseconds startTime,
   Milliseconds solutionTime = Utilities::GetProcessorTime() - startTime;
 
   Logger::Event("NodeExamineCount", "num_nodes", enumrtr->GetNodeCnt());
+  enumrtr->LogHistTableStats();
 
   stats::nodeCount.Record(enumrtr->GetNodeCnt());
+  EnumNodeCnt = enumrtr->GetNodeCnt();
+  EnumTime = solutionTime;
+  RlxdChkCnt = enumrtr->GetRlxdChkCnt();
+  RlxdChkTime = enumrtr->GetRlxdChkTime() / 1000;
+  if (RlxdChkCnt != 0)
+    Logger::Event("RelaxedPruningStats", "checks", RlxdChkCnt, //
+                  "check_us", RlxdChkTime);
   stats::solutionTime.Record(solutionTime);
 
   const InstCount improvement = initCost - bestCost_;
@@ -819,6 +886,54 @@ FUNC_RESULT SchedRegion::Optimize_(Milliseconds startTime,
   return rslt;
 }
 
+bool SchedRegion::SetupWorkerRgn_(SchedRegion *mainRgn, bool cmputRlxdBounds) {
+  // Repeat the setup that FindOptimalSchedule() did on the main region. The
+  // results of the heuristic schedulers are copied rather than recomputed.
+  if (dataDepGraph_->SetupForSchdulng(true) != RES_SUCCESS)
+    return false;
+
+  for (auto &GT : *dataDepGraph_->GetGraphTrans()) {
+    if (GT->ApplyTrans() != RES_SUCCESS ||
+        dataDepGraph_->UpdateSetupForSchdulng(true) != RES_SUCCESS)
+      return false;
+  }
+
+  SetupForSchdulng_();
+  CmputAbslutUprBound_();
+  if (cmputRlxdBounds) {
+    schedLwrBound_ = dataDepGraph_->GetSchedLwrBound();
+    CmputLwrBounds_(false);
+  } else {
+    schedLwrBound_ = mainRgn->schedLwrBound_;
+    CmputAndSetCostLwrBound();
+  }
+
+  // Costs are normalized by the lower bounds, so the regions can only share
+  // costs if they agree on them.
+  if (schedLwrBound_ != mainRgn->schedLwrBound_ ||
+      costLwrBound_ != mainRgn->costLwrBound_)
+    return false;
+
+  schedUprBound_ = mainRgn->schedUprBound_;
+  hurstcCost_ = mainRgn->hurstcCost_;
+  bestCost_ = mainRgn->bestCost_;
+  bestSchedLngth_ = mainRgn->bestSchedLngth_;
+  BestSpillCost_ = mainRgn->BestSpillCost_;
+  return true;
+}
+
+bool SchedRegion::SetupParallelWorker_(SchedRegion *mainRgn,
+                                       Milliseconds lngthTimeout) {
+  if (!SetupWorkerRgn_(mainRgn, true))
+    return false;
+
+  dataDepGraph_->SetHard(true);
+  enumCrntSched_ = AllocNewSched_();
+  enumBestSched_ = AllocNewSched_();
+  AllocEnumrtr_(lngthTimeout);
+  return true;
+}
+
 void SchedRegion::CmputLwrBounds_(bool useFileBounds) {
   RelaxedScheduler *rlxdSchdulr = NULL;
   RelaxedScheduler *rvrsRlxdSchdulr = NULL;
@@ -847,8 +962,13 @@ void SchedRegion::CmputLwrBounds_(bool useFileBounds) {
 
     InstCount frwrdLwrBound = 0;
     InstCount bkwrdLwrBound = 0;
+    auto boundStart = std::chrono::steady_clock::now();
     frwrdLwrBound = rlxdSchdulr->FindSchedule();
     bkwrdLwrBound = rvrsRlxdSchdulr->FindSchedule();
+    stats::relaxedBoundTime.Record(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - boundStart)
+            .count());
     InstCount rlxdLwrBound = std::max(frwrdLwrBound, bkwrdLwrBound);
 
     assert(rlxdLwrBound >= schedLwrBound_);
@@ -1009,13 +1129,104 @@ void SchedRegion::InitSecondPass(bool EnableMutations) {
 void SchedRegion::initTwoPassAlg() { TwoPassEnabled_ = true; }
 
 FUNC_RESULT SchedRegion::runACO(InstSchedule *ReturnSched,
-                                InstSchedule *InitSched, bool IsPostBB) {
+                                InstSchedule *InitSched, bool IsPostBB,
+                                Milliseconds Deadline) {
   InitForSchdulng();
   ACOScheduler *AcoSchdulr =
       new ACOScheduler(dataDepGraph_, machMdl_, abslutSchedUprBound_,
                        hurstcPrirts_, vrfySched_, IsPostBB);
   AcoSchdulr->setInitialSched(InitSched);
+  AcoSchdulr->setDeadline(Deadline);
+
+  // The ants that run on other threads schedule on copies of this region.
+  std::vector<std::unique_ptr<ACOScheduler>> AntSchdulrs;
+  for (SchedRegion *Wrkr : SetupAcoWrkrs_()) {
+    AntSchdulrs.push_back(llvm::make_unique<ACOScheduler>(
+        Wrkr->dataDepGraph_, machMdl_, Wrkr->abslutSchedUprBound_,
+        hurstcPrirts_, vrfySched_, IsPostBB));
+    AcoSchdulr->addAntWorker(AntSchdulrs.back().get(), Wrkr);
+  }
+
+  Milliseconds AcoStart = Utilities::GetProcessorTime();
   FUNC_RESULT Rslt = AcoSchdulr->FindSchedule(ReturnSched, this);
+  AcoRunTime += Utilities::GetProcessorTime() - AcoStart;
+  AcoIterCnt += AcoSchdulr->getIterationCnt();
   delete AcoSchdulr;
+  AntSchdulrs.clear();
+  FreeAcoWrkrs_();
   return Rslt;
 }
+
+struct SchedRegion::AcoPipeline {
+  explicit AcoPipeline(InstCount InitCost) : Incumbent(InitCost) {}
+
+  // The copy of the region that ACO schedules, and the best schedule found.
+  SchedRegion *Rgn = NULL;
+  std::unique_ptr<InstSchedule> Sched;
+  std::unique_ptr<ACOScheduler> Schdulr;
+  std::vector<std::unique_ptr<ACOScheduler>> AntSchdulrs;
+  // The best cost found by ACO or the enumerator.
+  SharedIncumbent Incumbent;
+  std::atomic<bool> Stop{false};
+  FUNC_RESULT Rslt = RES_ERROR;
+  Milliseconds Start = 0;
+  std::thread Thrd;
+};
+
+SchedRegion::AcoPipeline *
+SchedRegion::StartPipelinedAco_(SchedRegion *AcoRgn, InstSchedule *InitSched,
+                                Milliseconds Deadline) {
+  AcoPipeline *Pipeline = new AcoPipeline(GetBestCost());
+  Pipeline->Rgn = AcoRgn;
+  Pipeline->Sched = llvm::make_unique<InstSchedule>(
+      machMdl_, AcoRgn->dataDepGraph_, vrfySched_);
+
+  // Everything that reads the configuration or builds region copies is done
+  // on this thread.
+  AcoRgn->InitForSchdulng();
+  Pipeline->Schdulr = llvm::make_unique<ACOScheduler>(
+      AcoRgn->dataDepGraph_, machMdl_, AcoRgn->abslutSchedUprBound_,
+      hurstcPrirts_, vrfySched_, false);
+  Pipeline->Schdulr->setInitialSched(InitSched);
+  Pipeline->Schdulr->setDeadline(Deadline);
+  Pipeline->Schdulr->setPipeline(&Pipeline->Incumbent, &Pipeline->Stop);
+  for (SchedRegion *Wrkr : SetupAcoWrkrs_()) {
+    Pipeline->AntSchdulrs.push_back(llvm::make_unique<ACOScheduler>(
+        Wrkr->dataDepGraph_, machMdl_, Wrkr->abslutSchedUprBound_,
+        hurstcPrirts_, vrfySched_, false));
+    Pipeline->Schdulr->addAntWorker(Pipeline->AntSchdulrs.back().get(), Wrkr);
+  }
+
+  setSharedBestCost(&Pipeline->Incumbent);
+  Logger::Info("Running ACO alongside the enumerator.");
+  Pipeline->Start = Utilities::GetProcessorTime();
+  Pipeline->Thrd = std::thread([Pipeline]() {
+    Pipeline->Rslt =
+        Pipeline->Schdulr->FindSchedule(Pipeline->Sched.get(), Pipeline->Rgn);
+  });
+  return Pipeline;
+}
+
+InstSchedule *SchedRegion::FinishPipelinedAco_(AcoPipeline *Pipeline) {
+  Pipeline->Stop.store(true, std::memory_order_relaxed);
+  Pipeline->Thrd.join();
+  setSharedBestCost(NULL);
+
+  Milliseconds AcoTime = Utilities::GetProcessorTime() - Pipeline->Start;
+  AcoRunTime += AcoTime;
+  AcoIterCnt += Pipeline->Schdulr->getIterationCnt();
+  stats::AcoTime.Record(AcoTime);
+
+  InstSchedule *Sched = NULL;
+  if (Pipeline->Rslt == RES_SUCCESS) {
+    Sched = new InstSchedule(machMdl_, dataDepGraph_, vrfySched_);
+    Sched->Copy(Pipeline->Sched.get());
+  }
+
+  Pipeline->Schdulr.reset();
+  Pipeline->AntSchdulrs.clear();
+  FreeAcoWrkrs_();
+  FreePipelinedAcoWrkr_();
+  delete Pipeline;
+  return Sched;
+}
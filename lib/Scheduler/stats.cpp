@@ -166,6 +166,8 @@ IntDistributionStat regionBuildTime("Region build time");
 IntDistributionStat heuristicTime("Heuristic time");
 IntDistributionStat AcoTime("ACO time");
 IntDistributionStat boundComputationTime("Bound computation time");
+IntDistributionStat
+    relaxedBoundTime("Relaxed lower bound computation time (us)");
 IntDistributionStat enumerationTime("Enumeration time");
 IntDistributionStat
     enumerationToHeuristicTimeRatio("Enumeration to heuristic time ratio");
@@ -180,6 +182,18 @@ IntDistributionStat historyDominationPositionToListSize(
     "History domination position to list size");
 IntDistributionStat
     historyTableInitializationTime("History table initialization time");
+IntDistributionStat historyShardEntries("History table entries per shard");
+IntDistributionStat
+    historyShardCollisions("History table collisions per shard");
+IntDistributionStat
+    historyShardMaxListSize("History table maximum list size per shard");
+IntDistributionStat historyEvictions("History table evictions");
+IntDistributionStat historyRejections("History table rejected insertions");
+IntDistributionStat historyDominationsLostToEviction(
+    "History dominations possibly lost to eviction");
+IntDistributionStat historyPeakMemory("History table peak memory (KB)");
+IntDistributionStat
+    historyDominationCheckTime("History domination check time (us)");
 
 IntDistributionStat scheduledLatency("Scheduled latency");
 
@@ -198,6 +212,8 @@ IntStat negativeLowerBoundMismatchCount("Negative lower bound mismatch count");
 IntStat signatureDominationTests("Signature domination tests");
 IntStat signatureMatches("Signature matches");
 IntStat signatureAliases("Signature aliases");
+IntStat historySignatureTests("History signature tests");
+IntStat historySignatureAliases("History signature aliases");
 IntStat subsetMatches("Subset matches");
 IntStat absoluteDominationHits("Absolute domination hits");
 IntStat positiveDominationHits("Positive domination hits");
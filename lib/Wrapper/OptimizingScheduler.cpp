@@ -429,6 +429,29 @@ void ScheduleDAGOptSched::schedule() {
       LowerBoundAlgorithm, HeuristicPriorities, EnumPriorities, VerifySchedule,
       PruningStrategy, SchedForRPOnly, EnumStalls, SCW, SCF, HeurSchedType);
 
+  // Each extra enumeration or ACO thread needs its own copy of the region.
+  // These are only built if the region reaches the enumerator or ACO.
+  if ((EnumThreads > 1 || AcoThreads > 1 || AcoPipelined) &&
+      !isTwoPassEnabled()) {
+    region->setParallelWorkerFactory([&]() {
+      ParallelEnumWorker Worker;
+      Worker.DDG = OST->createDDGWrapper(C, this, MM.get(), LatencyPrecision,
+                                         RegionName);
+      Worker.DDG->convertSUnits(false, false);
+      Worker.DDG->convertRegFiles();
+      addGraphTransformations(
+          static_cast<OptSchedDDGWrapperBasic *>(Worker.DDG.get()));
+      Worker.Rgn = llvm::make_unique<BBWithSpill>(
+          OST.get(), static_cast<DataDepGraph *>(Worker.DDG.get()), 0,
+          HistTableHashBits, LowerBoundAlgorithm, HeuristicPriorities,
+          EnumPriorities, VerifySchedule, PruningStrategy, SchedForRPOnly,
+          EnumStalls, SCW, SCF, HeurSchedType);
+      return Worker;
+    });
+    region->setParallelEnum(EnumThreads - 1, EnumSplitDepth);
+    region->setParallelAco(AcoThreads - 1);
+  }
+
   bool IsEasy = false;
   InstCount NormBestCost = 0;
   InstCount BestSchedLngth = 0;
@@ -615,6 +638,10 @@ void ScheduleDAGOptSched::loadOptSchedConfig() {
   SchedForRPOnly = schedIni.GetBool("SCHEDULE_FOR_RP_ONLY");
   HistTableHashBits =
       static_cast<int16_t>(schedIni.GetInt("HIST_TABLE_HASH_BITS"));
+  EnumThreads = schedIni.GetInt("ENUM_PARALLEL_THREADS", 1);
+  EnumSplitDepth = schedIni.GetInt("ENUM_PARALLEL_SPLIT_DEPTH", 3);
+  AcoThreads = schedIni.GetInt("ACO_PARALLEL_THREADS", 1);
+  AcoPipelined = schedIni.GetBool("ACO_PIPELINED", false);
   VerifySchedule = schedIni.GetBool("VERIFY_SCHEDULE");
   EnableMutations = schedIni.GetBool("LLVM_MUTATIONS");
   EnumStalls = schedIni.GetBool("ENUMERATE_STALLS");
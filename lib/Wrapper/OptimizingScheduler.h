@@ -155,6 +155,21 @@ protected:
   // The number of bits in the hash table used in history-based domination.
   int16_t HistTableHashBits;
 
+  // The number of threads to enumerate each region with. Defaults to 1.
+  int EnumThreads;
+
+  // The depth, in issue slots, at which the search tree is divided among the
+  // enumeration threads.
+  int EnumSplitDepth;
+
+  // The number of threads to construct the ants of each ACO iteration on.
+  // Defaults to 1.
+  int AcoThreads;
+
+  // Whether to run ACO alongside the enumerator rather than before it.
+  // Defaults to NO.
+  bool AcoPipelined;
+
   // Whether to verify that calculated schedules are optimal. Defaults to NO.
   bool VerifySchedule;
 
@@ -0,0 +1,551 @@
+//===- optsched-replay.cpp - Schedule dumped DDGs with OptSched -----------===//
+//
+// Runs the scheduler on the data dependence graphs written by DUMP_DDGS (.ddg
+// files) without compiling anything, and reports the results and the time
+// taken for each region. The regions are scheduled in one pass with the
+// first-pass settings of the scheduler options file.
+//
+//===----------------------------------------------------------------------===//
+#include "opt-sched/Scheduler/OptSchedTarget.h"
+#include "opt-sched/Scheduler/bb_spill.h"
+#include "opt-sched/Scheduler/buffers.h"
+#include "opt-sched/Scheduler/config.h"
+#include "opt-sched/Scheduler/data_dep.h"
+#include "opt-sched/Scheduler/enumerator.h"
+#include "opt-sched/Scheduler/logger.h"
+#include "opt-sched/Scheduler/machine_model.h"
+#include "opt-sched/Scheduler/random.h"
+#include "opt-sched/Scheduler/register.h"
+#include "opt-sched/Scheduler/sched_region.h"
+#include "opt-sched/Scheduler/utilities.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <sys/resource.h>
+#include <vector>
+
+using namespace llvm;
+using namespace llvm::opt_sched;
+
+static cl::list<std::string>
+    InputPaths(cl::Positional, cl::OneOrMore,
+               cl::desc("<.ddg file or directory of .ddg files>..."));
+
+// These are named differently from the machine scheduler's options, which are
+// linked in with the rest of OptSched.
+static cl::opt<std::string> OptSchedCfg(
+    "cfg", cl::Required,
+    cl::desc(
+        "Path to the directory containing configuration files for opt-sched."));
+
+static cl::opt<std::string> OptSchedCfgS(
+    "cfg-sched",
+    cl::desc(
+        "Path to the scheduler options configuration file for opt-sched."));
+
+static cl::opt<std::string> OptSchedCfgMM(
+    "cfg-machine-model",
+    cl::desc("Path to the machine model specification file for opt-sched."));
+
+static cl::opt<bool> PrintCSV("csv",
+                              cl::desc("Print the results as CSV."));
+
+static cl::opt<bool> Quiet("quiet",
+                           cl::desc("Do not print the scheduler's log."));
+
+static cl::opt<bool> ModelDataRegs(
+    "model-data-regs",
+    cl::desc("Give each instruction with data successors a register of the "
+             "first register type, used by those successors."));
+
+namespace {
+
+// An OptSched DDG that is read from a file rather than built from an LLVM
+// DAG.
+class ReplayDDG : public DataDepGraph {
+public:
+  ReplayDDG(MachineModel *MM, LATENCY_PRECISION LatencyPrecision)
+      : DataDepGraph(MM, LatencyPrecision) {}
+
+  void convertSUnits(bool IgnoreRealEdges,
+                     bool IgnoreArtificialEdges) override {}
+
+  // The .ddg files do not record registers, so the graph has none unless
+  // they are modeled on the data dependences.
+  void convertRegFiles() override {
+    for (int16_t T = 0; T < machMdl_->GetRegTypeCnt(); T++)
+      RegFiles[T].SetRegType(T);
+
+    if (!ModelDataRegs || machMdl_->GetRegTypeCnt() == 0)
+      return;
+
+    std::vector<SchedInstruction *> Defs;
+    for (InstCount I = 0; I < instCnt_; I++)
+      if (hasDataScsr(insts_[I]))
+        Defs.push_back(insts_[I]);
+
+    RegisterFile &RegFile = RegFiles[0];
+    RegFile.SetRegCnt(Defs.size());
+    for (size_t I = 0; I < Defs.size(); I++) {
+      SchedInstruction *Def = Defs[I];
+      opt_sched::Register *Reg = RegFile.GetReg(I);
+      Def->AddDef(Reg);
+      Reg->AddDef(Def);
+      Reg->SetIsLiveIn(Def == GetRootInst());
+
+      DependenceType DepType;
+      for (SchedInstruction *Scsr = Def->GetFrstScsr(NULL, NULL, &DepType);
+           Scsr != NULL; Scsr = Def->GetNxtScsr(NULL, NULL, &DepType)) {
+        if (DepType != DEP_DATA)
+          continue;
+        Scsr->AddUse(Reg);
+        Reg->AddUse(Scsr);
+        if (Scsr == GetLeafInst())
+          Reg->SetIsLiveOut(true);
+      }
+    }
+  }
+
+private:
+  static bool hasDataScsr(SchedInstruction *Inst) {
+    DependenceType DepType;
+    for (SchedInstruction *Scsr = Inst->GetFrstScsr(NULL, NULL, &DepType);
+         Scsr != NULL; Scsr = Inst->GetNxtScsr(NULL, NULL, &DepType))
+      if (DepType == DEP_DATA)
+        return true;
+    return false;
+  }
+};
+
+// The generic target, without the parts that need LLVM.
+class ReplayTarget : public OptSchedTarget {
+public:
+  explicit ReplayTarget(MachineModel *MM_) { MM = MM_; }
+
+  std::unique_ptr<OptSchedMachineModel>
+  createMachineModel(const char *ConfigPath) override {
+    llvm_unreachable("The machine model is read from a file.");
+  }
+
+  std::unique_ptr<OptSchedDDGWrapperBase>
+  createDDGWrapper(MachineSchedContext *Context, ScheduleDAGOptSched *DAG,
+                   OptSchedMachineModel *MM, LATENCY_PRECISION LatencyPrecision,
+                   const std::string &RegionID) override {
+    llvm_unreachable("The DDGs are read from files.");
+  }
+
+  void initRegion(ScheduleDAGInstrs *DAG, MachineModel *MM_) override {}
+  void finalizeRegion(const InstSchedule *Schedule) override {}
+
+  // Like the generic target, find the total PRP.
+  InstCount getCost(const llvm::SmallVectorImpl<unsigned> &PRP) const override {
+    InstCount TotalPRP = 0;
+    for (int16_t T = 0; T < MM->GetRegTypeCnt(); ++T)
+      TotalPRP += PRP[T];
+    return TotalPRP;
+  }
+};
+
+// The scheduler settings, as the plugin reads them from the options file.
+struct ReplaySettings {
+  LATENCY_PRECISION LatencyPrecision;
+  LB_ALG LowerBoundAlgorithm;
+  SchedPriorities HeuristicPriorities;
+  SchedPriorities EnumPriorities;
+  Pruning PruningStrategy;
+  SPILL_COST_FUNCTION SCF;
+  SchedulerType HeurSchedType;
+  BLOCKS_TO_KEEP BlocksToKeep;
+  int16_t HistTableHashBits;
+  int SCW;
+  int EnumThreads;
+  int EnumSplitDepth;
+  int AcoThreads;
+  bool AcoPipelined;
+  int RegionTimeout;
+  int LengthTimeout;
+  bool IsTimeoutPerInst;
+  bool VerifySchedule;
+  bool SchedForRPOnly;
+  bool EnumStalls;
+  bool FilterByPerp;
+};
+
+// The result of scheduling one region.
+struct RegionResult {
+  std::string Name;
+  InstCount InstCnt;
+  FUNC_RESULT Rslt;
+  bool IsHurstcOptml;
+  InstCount HurstcLength;
+  InstCount HurstcCost;
+  InstCount BestLength;
+  InstCount BestCost;
+  uint64_t NodeCnt;
+  Milliseconds EnumTime;
+  // The number of relaxed pruning checks and their total time in
+  // microseconds.
+  uint64_t RlxdChkCnt;
+  uint64_t RlxdChkTime;
+  uint64_t AcoIterCnt;
+  Milliseconds AcoTime;
+  Milliseconds Time;
+  // The peak resident set size of the process so far, in kilobytes.
+  long PeakRSS;
+};
+
+} // end anonymous namespace
+
+static const struct {
+  const char *Name;
+  LISTSCHED_HEURISTIC HID;
+} HeuristicNames[] = {
+    {"CP", LSH_CP},   {"LUC", LSH_LUC}, {"UC", LSH_UC},
+    {"NID", LSH_NID}, {"CPR", LSH_CPR}, {"ISO", LSH_ISO},
+    {"SC", LSH_SC},   {"LS", LSH_LS},   {"LLVM", LSH_LLVM},
+};
+
+static SchedPriorities parseHeuristic(const std::string &Str) {
+  SchedPriorities Priorities;
+  Priorities.cnt = 0;
+  Priorities.isDynmc = false;
+
+  size_t StartIndex = 0;
+  while (StartIndex <= Str.length()) {
+    size_t Walk = std::min(Str.find('_', StartIndex), Str.length());
+    auto LSH = llvm::find_if(HeuristicNames, [&](const decltype(
+                                                  HeuristicNames[0]) &Name) {
+      return !Str.compare(StartIndex, Walk - StartIndex, Name.Name);
+    });
+    if (LSH == std::end(HeuristicNames))
+      llvm::report_fatal_error("Unrecognized heuristic used: " + Str, false);
+
+    Priorities.vctr[Priorities.cnt++] = LSH->HID;
+    if (LSH->HID == LSH_LUC)
+      Priorities.isDynmc = true;
+    StartIndex = Walk + 1;
+  }
+
+  return Priorities;
+}
+
+static LATENCY_PRECISION parseLatencyPrecision(const std::string &Str) {
+  if (Str == "FILE" || Str == "PRECISE")
+    return LTP_PRECISE;
+  if (Str == "LLVM" || Str == "ROUGH")
+    return LTP_ROUGH;
+  if (Str == "UNIT" || Str == "UNITY")
+    return LTP_UNITY;
+
+  llvm::report_fatal_error(
+      "Unrecognized option for LATENCY_PRECISION setting: " + Str, false);
+}
+
+static LB_ALG parseLowerBoundAlgorithm(const std::string &Str) {
+  if (Str == "RJ")
+    return LBA_RJ;
+  if (Str == "LC")
+    return LBA_LC;
+
+  llvm::report_fatal_error("Unrecognized option for LB_ALG setting: " + Str,
+                           false);
+}
+
+static SchedulerType parseListSchedType(const std::string &Str) {
+  if (Str == "LIST")
+    return SCHED_LIST;
+  if (Str == "SEQ")
+    return SCHED_SEQ;
+  if (Str == "STALLING_LIST")
+    return SCHED_STALLING_LIST;
+
+  llvm::report_fatal_error("Unrecognized option for HEUR_SCHED_TYPE: " + Str,
+                           false);
+}
+
+static BLOCKS_TO_KEEP parseBlocksToKeep(const std::string &Str) {
+  if (Str == "ZERO_COST")
+    return BLOCKS_TO_KEEP::ZERO_COST;
+  if (Str == "OPTIMAL")
+    return BLOCKS_TO_KEEP::OPTIMAL;
+  if (Str == "IMPROVED")
+    return BLOCKS_TO_KEEP::IMPROVED;
+  if (Str == "IMPROVED_OR_OPTIMAL")
+    return BLOCKS_TO_KEEP::IMPROVED_OR_OPTIMAL;
+
+  return BLOCKS_TO_KEEP::ALL;
+}
+
+static ReplaySettings loadSettings(const Config &SchedIni) {
+  ReplaySettings S;
+  S.LatencyPrecision =
+      parseLatencyPrecision(SchedIni.GetString("LATENCY_PRECISION"));
+  S.LowerBoundAlgorithm = parseLowerBoundAlgorithm(SchedIni.GetString("LB_ALG"));
+  S.HeuristicPriorities = parseHeuristic(SchedIni.GetString("HEURISTIC"));
+  S.EnumPriorities = parseHeuristic(SchedIni.GetString("ENUM_HEURISTIC"));
+  S.PruningStrategy.rlxd = SchedIni.GetBool("APPLY_RELAXED_PRUNING");
+  S.PruningStrategy.nodeSup = SchedIni.GetBool("DYNAMIC_NODE_SUPERIORITY");
+  S.PruningStrategy.histDom = SchedIni.GetBool("APPLY_HISTORY_DOMINATION");
+  S.PruningStrategy.spillCost = SchedIni.GetBool("APPLY_SPILL_COST_PRUNING");
+  S.PruningStrategy.useSuffixConcatenation =
+      SchedIni.GetBool("ENABLE_SUFFIX_CONCATENATION");
+  S.SCF = ParseSCFName(SchedIni.GetString("SPILL_COST_FUNCTION"));
+  S.HeurSchedType = parseListSchedType(SchedIni.GetString("HEUR_SCHED_TYPE"));
+  S.BlocksToKeep = parseBlocksToKeep(SchedIni.GetString("BLOCKS_TO_KEEP"));
+  S.HistTableHashBits =
+      static_cast<int16_t>(SchedIni.GetInt("HIST_TABLE_HASH_BITS"));
+  S.SCW = SchedIni.GetInt("SPILL_COST_WEIGHT");
+  S.EnumThreads = SchedIni.GetInt("ENUM_PARALLEL_THREADS", 1);
+  S.EnumSplitDepth = SchedIni.GetInt("ENUM_PARALLEL_SPLIT_DEPTH", 3);
+  S.AcoThreads = SchedIni.GetInt("ACO_PARALLEL_THREADS", 1);
+  S.AcoPipelined = SchedIni.GetBool("ACO_PIPELINED", false);
+  S.RegionTimeout = SchedIni.GetInt("REGION_TIMEOUT");
+  S.LengthTimeout = SchedIni.GetInt("LENGTH_TIMEOUT");
+  S.IsTimeoutPerInst = SchedIni.GetString("TIMEOUT_PER") == "INSTR";
+  S.VerifySchedule = SchedIni.GetBool("VERIFY_SCHEDULE");
+  S.SchedForRPOnly = SchedIni.GetBool("SCHEDULE_FOR_RP_ONLY");
+  S.EnumStalls = SchedIni.GetBool("ENUMERATE_STALLS");
+  S.FilterByPerp = SchedIni.GetBool("FILTER_BY_PERP");
+  return S;
+}
+
+// Returns the path of a configuration file, given on the command line or
+// found in the configuration directory.
+static std::string getCfgPath(const std::string &Path,
+                              const char *DefaultName) {
+  SmallString<128> RealPath;
+  if (Path.empty()) {
+    RealPath = OptSchedCfg;
+    sys::path::append(RealPath, DefaultName);
+  } else {
+    RealPath = Path;
+  }
+  sys::path::native(RealPath);
+  return RealPath.str().str();
+}
+
+// Finds the .ddg files to replay, in a stable order.
+static std::vector<std::string> findDDGFiles() {
+  std::vector<std::string> Files;
+
+  for (const std::string &Path : InputPaths) {
+    if (!sys::fs::is_directory(Path)) {
+      Files.push_back(Path);
+      continue;
+    }
+
+    std::vector<std::string> DirFiles;
+    std::error_code EC;
+    for (sys::fs::directory_iterator It(Path, EC), End; It != End && !EC;
+         It.increment(EC)) {
+      if (sys::path::extension(It->path()) == ".ddg")
+        DirFiles.push_back(It->path());
+    }
+    if (EC)
+      llvm::report_fatal_error("Unable to read the directory " + Path + ": " +
+                                   EC.message(),
+                               false);
+    std::sort(DirFiles.begin(), DirFiles.end());
+    Files.insert(Files.end(), DirFiles.begin(), DirFiles.end());
+  }
+
+  return Files;
+}
+
+// Reads the graph with the given index in a .ddg file. Returns nullptr if the
+// file has no such graph.
+static std::unique_ptr<ReplayDDG> readDDG(const std::string &Path, int Index,
+                                          MachineModel *MM,
+                                          const ReplaySettings &S) {
+  SpecsBuffer Buf;
+  if (Buf.Load(Path.c_str()) != RES_SUCCESS)
+    llvm::report_fatal_error("Unable to read the file " + Path, false);
+
+  bool EndOfFile = false;
+  for (int I = 0; I < Index; I++)
+    if (ReplayDDG(MM, S.LatencyPrecision).SkipGraph(&Buf, EndOfFile) !=
+        RES_SUCCESS)
+      return nullptr;
+
+  auto DDG = llvm::make_unique<ReplayDDG>(MM, S.LatencyPrecision);
+  FUNC_RESULT Rslt = DDG->ReadFrmFile(&Buf, EndOfFile);
+  if (Rslt == RES_END)
+    return nullptr;
+  if (Rslt == RES_ERROR)
+    llvm::report_fatal_error("Invalid DDG in the file " + Path, false);
+  DDG->convertRegFiles();
+  return DDG;
+}
+
+static std::unique_ptr<BBWithSpill> createRegion(ReplayTarget *Target,
+                                                 DataDepGraph *DDG,
+                                                 long RegionNum,
+                                                 const ReplaySettings &S) {
+  return llvm::make_unique<BBWithSpill>(
+      Target, DDG, RegionNum, S.HistTableHashBits, S.LowerBoundAlgorithm,
+      S.HeuristicPriorities, S.EnumPriorities, S.VerifySchedule,
+      S.PruningStrategy, S.SchedForRPOnly, S.EnumStalls, S.SCW, S.SCF,
+      S.HeurSchedType);
+}
+
+static RegionResult scheduleRegion(const std::string &Path, int Index,
+                                   ReplayDDG *DDG, ReplayTarget *Target,
+                                   long RegionNum, const ReplaySettings &S) {
+  auto Region = createRegion(Target, DDG, RegionNum, S);
+
+  if (S.EnumThreads > 1 || S.AcoThreads > 1 || S.AcoPipelined) {
+    Region->setParallelWorkerFactory([&]() {
+      ParallelEnumWorker Worker;
+      std::unique_ptr<ReplayDDG> WorkerDDG =
+          readDDG(Path, Index, Target->MM, S);
+      Worker.Rgn = createRegion(Target, WorkerDDG.get(), RegionNum, S);
+      Worker.DDG = std::move(WorkerDDG);
+      return Worker;
+    });
+    Region->setParallelEnum(S.EnumThreads - 1, S.EnumSplitDepth);
+    Region->setParallelAco(S.AcoThreads - 1);
+  }
+
+  RegionResult R;
+  R.Name = DDG->GetDagID();
+  R.InstCnt = DDG->GetInstCnt();
+
+  int RegionTimeout = S.RegionTimeout;
+  int LengthTimeout = S.LengthTimeout;
+  if (S.IsTimeoutPerInst) {
+    RegionTimeout *= R.InstCnt;
+    LengthTimeout *= R.InstCnt;
+  }
+
+  // The region only sets this when the heuristic schedule is optimal.
+  R.IsHurstcOptml = false;
+  InstSchedule *Sched = NULL;
+  Utilities::startTime = std::chrono::high_resolution_clock::now();
+  R.Rslt = Region->FindOptimalSchedule(
+      RegionTimeout, LengthTimeout, R.IsHurstcOptml, R.BestCost, R.BestLength,
+      R.HurstcCost, R.HurstcLength, Sched, S.FilterByPerp, S.BlocksToKeep);
+  R.Time = Utilities::GetProcessorTime();
+  R.NodeCnt = Region->getEnumNodeCnt();
+  R.EnumTime = Region->getEnumTime();
+  R.RlxdChkCnt = Region->getRlxdChkCnt();
+  R.RlxdChkTime = Region->getRlxdChkTime();
+  R.AcoIterCnt = Region->getAcoIterCnt();
+  R.AcoTime = Region->getAcoTime();
+
+  struct rusage Usage;
+  R.PeakRSS = getrusage(RUSAGE_SELF, &Usage) == 0 ? Usage.ru_maxrss : 0;
+  return R;
+}
+
+static const char *getResultName(const RegionResult &R) {
+  switch (R.Rslt) {
+  case RES_SUCCESS:
+    return R.IsHurstcOptml ? "heuristic-optimal" : "optimal";
+  case RES_TIMEOUT:
+    return "timeout";
+  default:
+    return "failed";
+  }
+}
+
+static void printResult(raw_ostream &OS, const RegionResult &R) {
+  if (PrintCSV) {
+    OS << R.Name << ',' << R.InstCnt << ',' << getResultName(R) << ','
+       << R.HurstcLength << ',' << R.HurstcCost << ',' << R.BestLength << ','
+       << R.BestCost << ',' << R.NodeCnt << ',' << R.EnumTime << ','
+       << R.RlxdChkCnt << ',' << R.RlxdChkTime << ',' << R.AcoIterCnt << ','
+       << R.AcoTime << ',' << R.Time << ',' << R.PeakRSS << '\n';
+    return;
+  }
+
+  OS << format("%-40s %6d %-17s %8d %9d %8d %9d %12llu %9lld\n",
+               R.Name.c_str(), R.InstCnt, getResultName(R), R.HurstcLength,
+               R.HurstcCost, R.BestLength, R.BestCost,
+               (unsigned long long)R.NodeCnt, (long long)R.Time);
+}
+
+static void printHeader(raw_ostream &OS) {
+  if (PrintCSV) {
+    OS << "region,insts,result,heuristic_length,heuristic_cost,best_length,"
+          "best_cost,enum_nodes,enum_time_ms,rlxd_checks,rlxd_check_us,"
+          "aco_iterations,aco_time_ms,time_ms,peak_rss_kb\n";
+    return;
+  }
+
+  OS << left_justify("Region", 40) << ' ' << right_justify("Insts", 6) << ' '
+     << left_justify("Result", 17) << ' ' << right_justify("HeurLen", 8) << ' '
+     << right_justify("HeurCost", 9) << ' ' << right_justify("BestLen", 8)
+     << ' ' << right_justify("BestCost", 9) << ' '
+     << right_justify("EnumNodes", 12) << ' ' << right_justify("Time(ms)", 9)
+     << '\n';
+}
+
+int main(int argc, char **argv) {
+  cl::ParseCommandLineOptions(argc, argv,
+                              "Schedule dumped DDGs with OptSched\n");
+
+  // The scheduler's log goes to std::cerr, and an unopened file stream
+  // discards it.
+  std::ofstream NullStream;
+  if (Quiet)
+    Logger::SetLogStream(NullStream);
+
+  Config &SchedIni = SchedulerOptions::getInstance();
+  SchedIni.Load(getCfgPath(OptSchedCfgS, "sched.ini"));
+  ReplaySettings S = loadSettings(SchedIni);
+
+  int RandomSeed = SchedIni.GetInt("RANDOM_SEED", 0);
+  if (RandomSeed == 0)
+    RandomSeed = time(NULL);
+  RandomGen::SetSeed(RandomSeed);
+
+  MachineModel MM(getCfgPath(OptSchedCfgMM, "machine_model.cfg"));
+  ReplayTarget Target(&MM);
+
+  raw_ostream &OS = outs();
+  printHeader(OS);
+
+  long RegionNum = 0;
+  int OptimalCnt = 0;
+  int TimeoutCnt = 0;
+  uint64_t TotalNodeCnt = 0;
+  Milliseconds TotalTime = 0;
+
+  for (const std::string &Path : findDDGFiles()) {
+    for (int Index = 0;; Index++) {
+      std::unique_ptr<ReplayDDG> DDG = readDDG(Path, Index, &MM, S);
+      if (!DDG)
+        break;
+
+      RegionResult R =
+          scheduleRegion(Path, Index, DDG.get(), &Target, RegionNum++, S);
+      printResult(OS, R);
+      OS.flush();
+
+      if (R.Rslt == RES_SUCCESS)
+        OptimalCnt++;
+      else if (R.Rslt == RES_TIMEOUT)
+        TimeoutCnt++;
+      TotalNodeCnt += R.NodeCnt;
+      TotalTime += R.Time;
+    }
+  }
+
+  if (!PrintCSV)
+    OS << format("\n%ld regions, %d optimal, %d timed out, %llu enumeration "
+                 "nodes, %lld ms\n",
+                 RegionNum, OptimalCnt, TimeoutCnt,
+                 (unsigned long long)TotalNodeCnt, (long long)TotalTime);
+  return 0;
+}
@@ -0,0 +1,106 @@
+#include "opt-sched/Scheduler/aco_select.h"
+
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace llvm::opt_sched;
+
+namespace {
+
+// Scores in the range the scheduler produces: pheromone between 1 and 8 times
+// a heuristic factor between 1 and 2.
+std::vector<pheromone_t> makeScores(size_t Cnt) {
+  std::vector<pheromone_t> Scores;
+  for (size_t i = 0; i < Cnt; i++)
+    Scores.push_back(1 + (i * 37 % 23) / 3.0 + (i * 11 % 7) / 7.0);
+  return Scores;
+}
+
+TEST(AcoSelect, ArgMaxMatchesScalar) {
+  for (size_t Cnt = 1; Cnt < 40; Cnt++) {
+    std::vector<pheromone_t> Scores = makeScores(Cnt);
+    EXPECT_EQ(AcoSelect::argMaxScalar(Scores), AcoSelect::argMax(Scores));
+  }
+}
+
+TEST(AcoSelect, ArgMaxTakesTheFirstOfEqualScores) {
+  std::vector<pheromone_t> Scores = {1, 3, 2, 1, 3, 3, 1, 2, 3};
+  EXPECT_EQ(1u, AcoSelect::argMax(Scores));
+  EXPECT_EQ(1u, AcoSelect::argMaxScalar(Scores));
+
+  Scores = {1, 1, 1, 1, 1, 2};
+  EXPECT_EQ(5u, AcoSelect::argMax(Scores));
+  EXPECT_EQ(5u, AcoSelect::argMaxScalar(Scores));
+}
+
+TEST(AcoSelect, SumMatchesScalar) {
+  for (size_t Cnt = 0; Cnt < 40; Cnt++) {
+    std::vector<pheromone_t> Scores = makeScores(Cnt);
+    pheromone_t Scalar = AcoSelect::sumScalar(Scores);
+    EXPECT_NEAR(Scalar, AcoSelect::sum(Scores), 1e-12 * (Scalar + 1));
+  }
+}
+
+TEST(AcoSelect, SumIsExactForIntegers) {
+  std::vector<pheromone_t> Scores = {1, 2, 3, 4, 5, 6, 7};
+  EXPECT_EQ(28, AcoSelect::sum(Scores));
+  EXPECT_EQ(28, AcoSelect::sumScalar(Scores));
+}
+
+// The roulette kernels take the point by reference. These spin them with a
+// copy of it.
+size_t spin(const std::vector<pheromone_t> &Scores, pheromone_t Point) {
+  return AcoSelect::roulette(Scores, Point);
+}
+
+size_t spinScalar(const std::vector<pheromone_t> &Scores, pheromone_t Point) {
+  return AcoSelect::rouletteScalar(Scores, Point);
+}
+
+TEST(AcoSelect, RouletteMatchesScalar) {
+  for (size_t Cnt = 1; Cnt < 40; Cnt++) {
+    std::vector<pheromone_t> Scores = makeScores(Cnt);
+    pheromone_t Sum = AcoSelect::sumScalar(Scores);
+    // Points halfway into each score are far from the boundaries that
+    // rounding could move.
+    pheromone_t Before = 0;
+    for (size_t i = 0; i < Cnt; i++) {
+      pheromone_t Point = Before + Scores[i] / 2;
+      EXPECT_EQ(i, spinScalar(Scores, Point));
+      EXPECT_EQ(i, spin(Scores, Point));
+      Before += Scores[i];
+    }
+    EXPECT_EQ(0u, spin(Scores, 0));
+    EXPECT_EQ(Cnt, spin(Scores, Sum * 2));
+    EXPECT_EQ(Cnt, spinScalar(Scores, Sum * 2));
+  }
+}
+
+TEST(AcoSelect, RouletteIncludesTheUpperBoundary) {
+  std::vector<pheromone_t> Scores = {1, 2, 3, 4, 5, 6};
+  EXPECT_EQ(0u, spin(Scores, 1));
+  EXPECT_EQ(3u, spin(Scores, 10));
+  EXPECT_EQ(4u, spin(Scores, 10.5));
+  EXPECT_EQ(3u, spinScalar(Scores, 10));
+  EXPECT_EQ(4u, spinScalar(Scores, 10.5));
+}
+
+TEST(AcoSelect, RouletteLeavesWhatRemainsOfThePoint) {
+  std::vector<pheromone_t> Scores = {1, 2, 3, 4, 5, 6};
+  pheromone_t Point = 10.5, ScalarPoint = 10.5;
+  EXPECT_EQ(4u, AcoSelect::roulette(Scores, Point));
+  EXPECT_EQ(4u, AcoSelect::rouletteScalar(Scores, ScalarPoint));
+  EXPECT_EQ(-4.5, Point);
+  EXPECT_EQ(-4.5, ScalarPoint);
+
+  // Past the end, all the scores have been subtracted.
+  Point = ScalarPoint = 25;
+  EXPECT_EQ(6u, AcoSelect::roulette(Scores, Point));
+  EXPECT_EQ(6u, AcoSelect::rouletteScalar(Scores, ScalarPoint));
+  EXPECT_EQ(4, Point);
+  EXPECT_EQ(4, ScalarPoint);
+}
+
+} // namespace
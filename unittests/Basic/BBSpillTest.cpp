@@ -0,0 +1,151 @@
+#include "opt-sched/Scheduler/bb_spill.h"
+#include "TestRegion.h"
+#include "opt-sched/Scheduler/config.h"
+#include "opt-sched/Scheduler/enumerator.h"
+#include "opt-sched/Scheduler/logger.h"
+#include "opt-sched/Scheduler/register.h"
+#include "opt-sched/Scheduler/utilities.h"
+
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace llvm::opt_sched;
+using namespace llvm::opt_sched::test;
+
+namespace {
+
+// createRegion() weighs the spill cost by this much.
+const InstCount SPILL_COST_WGHT = 10000;
+
+class BBSpill : public ::testing::Test {
+protected:
+  BBSpill() : target(&machMdl) {}
+
+  void SetUp() override {
+    std::istringstream options(R"(
+        HEUR_ENABLED YES
+        ACO_ENABLED NO
+        ENUM_ENABLED NO
+        ACO_BEFORE_ENUM NO
+        ACO_AFTER_ENUM NO
+        SIMULATE_REGISTER_ALLOCATION NO
+      )");
+    SchedulerOptions::getInstance().Load(options);
+    Logger::SetLogStream(nullStream);
+
+    // Scheduling the region once computes the live intervals and the static
+    // SLIL lower bound.
+    ddg = createDDG(&machMdl, 6, 14);
+    rgn = createRegion(&target, ddg.get(), SCF_SLIL);
+    bool isLstOptml = false;
+    InstCount bestCost, bestLngth, hurstcCost, hurstcLngth;
+    InstSchedule *bestSched = NULL;
+    Utilities::startTime = std::chrono::high_resolution_clock::now();
+    ASSERT_EQ(RES_SUCCESS,
+              rgn->FindOptimalSchedule(60000, 60000, isLstOptml, bestCost,
+                                       bestLngth, hurstcCost, hurstcLngth,
+                                       bestSched, false, BLOCKS_TO_KEEP::ALL));
+    delete bestSched;
+  }
+
+  void TearDown() override { Logger::SetLogStream(std::cerr); }
+
+  // Whether the last scheduled instruction leaves reg live.
+  bool isLive(Register *reg) {
+    for (const SchedInstruction *def : reg->GetDefList())
+      if (isSchduld[def->GetNum()])
+        return reg->IsLive();
+    return false;
+  }
+
+  // The amount by which scheduling inst raised the dynamic SLIL lower bound,
+  // found by checking every register: one for each register that is live
+  // after inst or last used by it, and whose live interval and possible live
+  // interval do not contain inst.
+  InstCount scanRegs(SchedInstruction *inst) {
+    InstCount incr = 0;
+    RegisterFile &regFile = ddg->getRegFiles()[0];
+    for (int j = 0; j < regFile.GetRegCnt(); j++) {
+      Register *reg = regFile.GetReg(j);
+      bool isLastUse = !reg->IsLive() && inst->FindUse(reg);
+      if ((isLive(reg) || isLastUse) && !reg->IsInInterval(inst) &&
+          !reg->IsInPossibleInterval(inst))
+        incr++;
+    }
+    return incr;
+  }
+
+  // The amount by which the partial schedule raises the spill cost lower
+  // bound of the region.
+  InstCount getDynmcIncr() {
+    return rgn->getPartialNormSpillCostLwrBound() / SPILL_COST_WGHT;
+  }
+
+  TestMachineModel machMdl;
+  TestTarget target;
+  std::unique_ptr<TestDDG> ddg;
+  std::unique_ptr<BBWithSpill> rgn;
+  std::vector<bool> isSchduld;
+  std::ofstream nullStream;
+};
+
+// Schedules and unschedules instructions the way the enumerator does, and
+// checks after each step that the dynamic SLIL lower bound is what scanning
+// all the live registers gives.
+TEST_F(BBSpill, UpdatesTheSlilLowerBoundAsTheRegisterScanDid) {
+  std::mt19937 rndm(3);
+  InstCount instCnt = ddg->GetInstCnt();
+  isSchduld.assign(instCnt, false);
+  // The scheduled instructions, and the sum of what scanning the registers
+  // gave for them.
+  std::vector<SchedInstruction *> schduldInsts;
+  std::vector<InstCount> incrSums = {0};
+  EnumTreeNode node;
+  node.SetPeakSpillCost(0);
+  bool sawIncr = false;
+
+  rgn->InitForSchdulng();
+  ASSERT_EQ(0, getDynmcIncr());
+
+  for (int step = 0; step < 2000; step++) {
+    InstCount slot = schduldInsts.size();
+    std::vector<SchedInstruction *> rdyInsts;
+    for (InstCount i = 0; i < instCnt; i++) {
+      SchedInstruction *inst = ddg->GetInstByIndx(i);
+      if (isSchduld[i])
+        continue;
+      bool isRdy = true;
+      for (SchedInstruction *pred = inst->GetFrstPrdcsr(); pred != NULL;
+           pred = inst->GetNxtPrdcsr())
+        isRdy &= isSchduld[pred->GetNum()];
+      if (isRdy)
+        rdyInsts.push_back(inst);
+    }
+
+    if (!rdyInsts.empty() && (schduldInsts.empty() || rndm() % 3 != 0)) {
+      SchedInstruction *inst = rdyInsts[rndm() % rdyInsts.size()];
+      rgn->SchdulInst(inst, slot / 2, slot % 2, false);
+      isSchduld[inst->GetNum()] = true;
+      schduldInsts.push_back(inst);
+      incrSums.push_back(incrSums.back() + scanRegs(inst));
+      sawIncr |= incrSums.back() > incrSums[incrSums.size() - 2];
+    } else {
+      SchedInstruction *inst = schduldInsts.back();
+      slot--;
+      rgn->UnschdulInst(inst, slot / 2, slot % 2, &node);
+      isSchduld[inst->GetNum()] = false;
+      schduldInsts.pop_back();
+      incrSums.pop_back();
+    }
+
+    ASSERT_EQ(incrSums.back(), getDynmcIncr()) << "at step " << step;
+  }
+
+  EXPECT_TRUE(sawIncr);
+}
+
+} // namespace
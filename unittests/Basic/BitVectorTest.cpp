@@ -0,0 +1,131 @@
+#include "opt-sched/Scheduler/bit_vector.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace llvm::opt_sched;
+
+namespace {
+
+// Sets the bits whose indices are multiples of Step, starting at Start.
+void setEvery(BitVector &Vctr, int Start, int Step) {
+  for (int i = Start; i < Vctr.GetSize(); i += Step)
+    Vctr.SetBit(i);
+}
+
+std::vector<int> getSetBits(const BitVector &Vctr) {
+  std::vector<int> Bits;
+  for (int i : Vctr.GetSetBits())
+    Bits.push_back(i);
+  return Bits;
+}
+
+TEST(BitVector, CountsOnesAcrossWords) {
+  BitVector Vctr(200);
+  setEvery(Vctr, 0, 3);
+  EXPECT_EQ(67, Vctr.GetOneCnt());
+  // Setting a bit twice or clearing a clear bit changes nothing.
+  Vctr.SetBit(63);
+  Vctr.SetBit(64, false);
+  EXPECT_EQ(67, Vctr.GetOneCnt());
+  Vctr.SetBit(63, false);
+  EXPECT_EQ(66, Vctr.GetOneCnt());
+  EXPECT_FALSE(Vctr.GetBit(63));
+  EXPECT_TRUE(Vctr.GetBit(66));
+}
+
+TEST(BitVector, IteratesOverSetBits) {
+  BitVector Vctr(300);
+  EXPECT_TRUE(getSetBits(Vctr).empty());
+
+  std::vector<int> Expected = {0, 1, 63, 64, 127, 128, 250, 299};
+  for (int i : Expected)
+    Vctr.SetBit(i);
+  EXPECT_EQ(Expected, getSetBits(Vctr));
+  EXPECT_EQ(63, Vctr.FindNext(2));
+  EXPECT_EQ(250, Vctr.FindNext(129));
+  EXPECT_EQ(-1, Vctr.FindNext(300));
+}
+
+TEST(BitVector, CombinesInPlace) {
+  BitVector A(500), B(500);
+  setEvery(A, 0, 2);
+  setEvery(B, 0, 3);
+  EXPECT_EQ(84, A.CntCommonOnes(B));
+
+  BitVector And(500), Or(500), AndNot(500);
+  And = A;
+  And.AndWith(B);
+  Or = A;
+  Or.OrWith(B);
+  AndNot = A;
+  AndNot.AndNotWith(B);
+
+  for (int i = 0; i < 500; i++) {
+    EXPECT_EQ(i % 6 == 0, And.GetBit(i));
+    EXPECT_EQ(i % 2 == 0 || i % 3 == 0, Or.GetBit(i));
+    EXPECT_EQ(i % 2 == 0 && i % 3 != 0, AndNot.GetBit(i));
+  }
+  EXPECT_EQ(84, And.GetOneCnt());
+  EXPECT_EQ(333, Or.GetOneCnt());
+  EXPECT_EQ(166, AndNot.GetOneCnt());
+}
+
+TEST(BitVector, AndOfDifferentSizes) {
+  BitVector A(70), B(300);
+  setEvery(A, 0, 1);
+  setEvery(B, 0, 1);
+  auto Anded = A.And(&B);
+  EXPECT_EQ(300, Anded->GetSize());
+  EXPECT_EQ(70, Anded->GetOneCnt());
+  EXPECT_FALSE(Anded->GetBit(70));
+
+  auto Reversed = B.And(&A);
+  EXPECT_EQ(70, Reversed->GetOneCnt());
+}
+
+TEST(BitVector, IsSubVector) {
+  BitVector A(260), B(260);
+  setEvery(A, 0, 6);
+  setEvery(B, 0, 3);
+  EXPECT_TRUE(A.IsSubVector(&B));
+  EXPECT_FALSE(B.IsSubVector(&A));
+
+  // A bit in the last, partly used word.
+  A.SetBit(259);
+  EXPECT_FALSE(A.IsSubVector(&B));
+}
+
+TEST(WeightedBitVector, TracksWeights) {
+  WeightedBitVector Vctr(100);
+  Vctr.SetBit(5, true, 2);
+  Vctr.SetBit(70, true, 3);
+  Vctr.SetBit(70, true, 3);
+  EXPECT_EQ(5, Vctr.GetWghtedCnt());
+  EXPECT_EQ(2, Vctr.GetOneCnt());
+  Vctr.SetBit(5, false, 2);
+  Vctr.SetBit(6, false, 4);
+  EXPECT_EQ(3, Vctr.GetWghtedCnt());
+  Vctr.Reset();
+  EXPECT_EQ(0, Vctr.GetWghtedCnt());
+  EXPECT_EQ(0, Vctr.GetOneCnt());
+}
+
+TEST(BitWords, MatchesBitByBit) {
+  std::vector<BitWords::Word> A(9), B(9);
+  for (int i = 0; i < 9; i++) {
+    A[i] = 0x9e3779b97f4a7c15ULL * (i + 1);
+    B[i] = A[i] | (0xff00ULL << i);
+  }
+
+  int Common = 0;
+  for (int i = 0; i < 9 * 64; i++)
+    Common += BitWords::getBit(A.data(), i) && BitWords::getBit(B.data(), i);
+  EXPECT_EQ(Common, BitWords::cntCommonOnes(A.data(), B.data(), 9));
+  EXPECT_TRUE(BitWords::isSubset(A.data(), B.data(), 9));
+  EXPECT_FALSE(BitWords::equal(A.data(), B.data(), 9));
+  EXPECT_TRUE(BitWords::equal(A.data(), A.data(), 9));
+}
+
+} // namespace
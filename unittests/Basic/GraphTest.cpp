@@ -0,0 +1,108 @@
+#include "opt-sched/Scheduler/graph.h"
+
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace llvm::opt_sched;
+
+namespace {
+
+// A graph with the given edges between NodeCnt nodes. Node 0 must be the root
+// and the last node the leaf.
+class TestGraph : public DirAcycGraph {
+public:
+  TestGraph(int NodeCnt, const std::vector<std::pair<int, int>> &Edges) {
+    nodeCnt_ = NodeCnt;
+    nodes_ = new GraphNode *[NodeCnt];
+    for (int i = 0; i < NodeCnt; i++)
+      nodes_[i] = new GraphNode(i, NodeCnt);
+    for (const auto &Edge : Edges)
+      CreateEdge_(Edge.first, Edge.second, 1);
+    root_ = nodes_[0];
+    leaf_ = nodes_[NodeCnt - 1];
+  }
+
+  ~TestGraph() {
+    for (int i = 0; i < nodeCnt_; i++)
+      delete nodes_[i];
+    delete[] nodes_;
+  }
+
+  GraphNode *node(int i) { return nodes_[i]; }
+};
+
+// 0 -> 1 -> 3 -> 6, 0 -> 2 -> 3, 0 -> 4 -> 5 -> 6.
+const std::vector<std::pair<int, int>> DiamondEdges = {
+    {0, 1}, {0, 2}, {1, 3}, {2, 3}, {3, 6}, {0, 4}, {4, 5}, {5, 6}};
+
+TEST(Graph, FindsRecursiveNeighbors) {
+  TestGraph G(7, DiamondEdges);
+  ASSERT_EQ(RES_SUCCESS, G.FindRcrsvNghbrs(DIR_FRWRD));
+  ASSERT_EQ(RES_SUCCESS, G.FindRcrsvNghbrs(DIR_BKWRD));
+
+  EXPECT_EQ(6, G.node(0)->GetRcrsvScsrCnt());
+  EXPECT_EQ(2, G.node(1)->GetRcrsvScsrCnt());
+  EXPECT_EQ(0, G.node(6)->GetRcrsvScsrCnt());
+  EXPECT_EQ(6, G.node(6)->GetRcrsvPrdcsrCnt());
+  EXPECT_EQ(3, G.node(3)->GetRcrsvPrdcsrCnt());
+
+  EXPECT_TRUE(G.node(1)->IsRcrsvScsr(G.node(6)));
+  EXPECT_FALSE(G.node(1)->IsRcrsvScsr(G.node(2)));
+  EXPECT_FALSE(G.node(4)->IsRcrsvScsr(G.node(3)));
+  EXPECT_TRUE(G.node(5)->IsRcrsvPrdcsr(G.node(0)));
+  EXPECT_FALSE(G.node(5)->IsRcrsvPrdcsr(G.node(1)));
+
+  // The lists are only built on request.
+  EXPECT_EQ(nullptr, G.node(0)->GetRecursiveSuccessors());
+  EXPECT_EQ(nullptr, G.node(6)->GetRecursivePredecessors());
+}
+
+TEST(Graph, BuildsListsInTopologicalOrder) {
+  TestGraph G(7, DiamondEdges);
+  G.FindRcrsvNghbrs(DIR_FRWRD);
+  G.FindRcrsvNghbrs(DIR_BKWRD);
+  G.BldRcrsvNghbrLsts(DIR_FRWRD);
+  G.BldRcrsvNghbrLsts(DIR_BKWRD);
+
+  // The successor list of the root starts at the leaf, and each node comes
+  // after its successors.
+  std::vector<GraphNode *> Scsrs;
+  for (GraphNode &Node : *G.node(0)->GetRecursiveSuccessors())
+    Scsrs.push_back(&Node);
+  ASSERT_EQ(6u, Scsrs.size());
+  EXPECT_EQ(G.node(6), Scsrs.front());
+  for (size_t i = 0; i < Scsrs.size(); i++)
+    for (size_t j = i + 1; j < Scsrs.size(); j++)
+      EXPECT_FALSE(Scsrs[i]->IsRcrsvScsr(Scsrs[j]) && Scsrs[i] != Scsrs[j]);
+
+  std::vector<GraphNode *> Prdcsrs;
+  for (GraphNode &Node : *G.node(3)->GetRecursivePredecessors())
+    Prdcsrs.push_back(&Node);
+  ASSERT_EQ(3u, Prdcsrs.size());
+  EXPECT_EQ(G.node(0), Prdcsrs.front());
+}
+
+TEST(Graph, UpdatesBuiltLists) {
+  TestGraph G(7, DiamondEdges);
+  G.FindRcrsvNghbrs(DIR_FRWRD);
+  G.FindRcrsvNghbrs(DIR_BKWRD);
+  G.BldRcrsvNghbrLsts(DIR_FRWRD);
+
+  EXPECT_EQ(2, G.node(2)->GetRecursiveSuccessors()->GetElmntCnt());
+  G.node(4)->AddRcrsvScsr(G.node(3));
+  G.node(2)->AddRcrsvScsr(G.node(5));
+  EXPECT_EQ(3, G.node(4)->GetRecursiveSuccessors()->GetElmntCnt());
+  EXPECT_EQ(3, G.node(2)->GetRecursiveSuccessors()->GetElmntCnt());
+  EXPECT_TRUE(G.node(4)->IsRcrsvScsr(G.node(3)));
+}
+
+TEST(Graph, DetectsCycles) {
+  std::vector<std::pair<int, int>> Edges = DiamondEdges;
+  Edges.push_back({3, 1});
+  TestGraph G(7, Edges);
+  EXPECT_EQ(RES_ERROR, G.FindRcrsvNghbrs(DIR_FRWRD));
+}
+
+} // namespace
@@ -0,0 +1,157 @@
+#include "opt-sched/Scheduler/hash_table.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace llvm::opt_sched;
+
+namespace {
+
+using EntryAlloc = MemAlloc<BinHashTblEntry<int>>;
+
+TEST(ShardedBinHashTable, FindsMatchesFromNewestToOldest) {
+  ShardedBinHashTable<int> table(16, 8);
+  EntryAlloc alctr(16);
+  int a = 1, b = 2, c = 3;
+
+  // All three keys hash to the same bucket.
+  table.InsertElement(0x0101, &a, &alctr);
+  table.InsertElement(0x01FF, &b, &alctr);
+  table.InsertElement(0x0101, &c, &alctr);
+
+  EXPECT_EQ(3u, table.GetListSize(0x0101));
+  EXPECT_EQ(3u, table.GetEntryCnt());
+
+  ShardedBinHashTable<int>::SrchCrsr crsr;
+  EXPECT_EQ(&c, table.GetLastMatch(0x0101, crsr));
+  EXPECT_EQ(&a, table.GetPrevMatch(crsr));
+  EXPECT_EQ(nullptr, table.GetPrevMatch(crsr));
+
+  EXPECT_EQ(nullptr, table.GetLastMatch(0x0102, crsr));
+}
+
+TEST(ShardedBinHashTable, CountsHitsAndCollisionsPerShard) {
+  ShardedBinHashTable<int> table(16, 8, 2);
+  EntryAlloc alctr(16);
+  int a = 1, b = 2;
+
+  // Bucket 0x01 is in the first of the four shards.
+  table.InsertElement(0x0101, &a, &alctr);
+  table.InsertElement(0x01FF, &b, &alctr);
+
+  ShardedBinHashTable<int>::SrchCrsr crsr;
+  EXPECT_EQ(&a, table.GetLastMatch(0x0101, crsr));
+  EXPECT_EQ(nullptr, table.GetPrevMatch(crsr));
+
+  ASSERT_EQ(4, table.GetShardCnt());
+  HashTblShardStats stats = table.GetShardStats(0);
+  EXPECT_EQ(2u, stats.insrtCnt);
+  EXPECT_EQ(1u, stats.srchCnt);
+  EXPECT_EQ(1u, stats.hitCnt);
+  EXPECT_EQ(1u, stats.cllsnCnt);
+  EXPECT_EQ(2u, stats.maxListSize);
+  EXPECT_EQ(1u, table.GetPpultdBktCnt(0));
+
+  EXPECT_EQ(0u, table.GetShardStats(3).insrtCnt);
+  EXPECT_EQ(0u, table.GetPpultdBktCnt(3));
+}
+
+TEST(ShardedBinHashTable, ClearForgetsAllEntries) {
+  ShardedBinHashTable<int> table(16, 8);
+  EntryAlloc alctr(16);
+  int a = 1;
+
+  table.InsertElement(0x0101, &a, &alctr);
+  table.Clear();
+
+  ShardedBinHashTable<int>::SrchCrsr crsr;
+  EXPECT_EQ(0u, table.GetEntryCnt());
+  EXPECT_EQ(0u, table.GetListSize(0x0101));
+  EXPECT_EQ(nullptr, table.GetLastMatch(0x0101, crsr));
+}
+
+TEST(ShardedBinHashTable, EvictsTheChosenEntryOfTheBucket) {
+  ShardedBinHashTable<int> table(16, 8);
+  EntryAlloc alctr(16);
+  int a = 3, b = 1, c = 2, d = 1;
+
+  table.InsertElement(0x0101, &a, &alctr);
+  table.InsertElement(0x01FF, &b, &alctr);
+  table.InsertElement(0x0101, &c, &alctr);
+  table.InsertElement(0x0101, &d, &alctr);
+
+  // Evict the smallest element, and the oldest one among equals.
+  auto isSmaller = [](int *x, int *y) { return *x < *y; };
+  UDT_HASHKEY evctdKey;
+  EXPECT_EQ(&b, table.EvictElement(0x0101, isSmaller, &alctr, evctdKey));
+  EXPECT_EQ(0x01FFu, evctdKey);
+  EXPECT_EQ(&d, table.EvictElement(0x0101, isSmaller, &alctr, evctdKey));
+  EXPECT_EQ(0x0101u, evctdKey);
+
+  EXPECT_EQ(2u, table.GetListSize(0x0101));
+  EXPECT_EQ(2u, table.GetShardStats(0).evictCnt);
+
+  ShardedBinHashTable<int>::SrchCrsr crsr;
+  EXPECT_EQ(&c, table.GetLastMatch(0x0101, crsr));
+  EXPECT_EQ(&a, table.GetPrevMatch(crsr));
+  EXPECT_EQ(nullptr, table.GetPrevMatch(crsr));
+
+  EXPECT_EQ(nullptr, table.EvictElement(0x0202, isSmaller, &alctr, evctdKey));
+}
+
+TEST(ShardedBinHashTable, FindsTheNextPopulatedBucket) {
+  ShardedBinHashTable<int> table(16, 8);
+  EntryAlloc alctr(16);
+  int a = 1, b = 2, c = 3;
+
+  UDT_HASHKEY ppultdKey;
+  EXPECT_FALSE(table.FindPpultdList(0x0101, ppultdKey));
+
+  table.InsertElement(0x0301, &a, &alctr);
+  table.InsertElement(0x0302, &b, &alctr);
+  table.InsertElement(0xF001, &c, &alctr);
+
+  // A populated bucket is its own, and its most recent entry is returned.
+  ASSERT_TRUE(table.FindPpultdList(0x0303, ppultdKey));
+  EXPECT_EQ(0x0302u, ppultdKey);
+  ASSERT_TRUE(table.FindPpultdList(0x0101, ppultdKey));
+  EXPECT_EQ(0x0302u, ppultdKey);
+  ASSERT_TRUE(table.FindPpultdList(0x0401, ppultdKey));
+  EXPECT_EQ(0xF001u, ppultdKey);
+  // The search wraps around past the last bucket.
+  ASSERT_TRUE(table.FindPpultdList(0xF101, ppultdKey));
+  EXPECT_EQ(0x0302u, ppultdKey);
+}
+
+TEST(ShardedBinHashTable, KeepsAllEntriesInsertedConcurrently) {
+  ShardedBinHashTable<int> table(16, 4);
+  const int thrdCnt = 4;
+  const int keyCnt = 1000;
+  std::vector<int> elmnts(keyCnt);
+  std::vector<std::unique_ptr<EntryAlloc>> alctrs;
+  for (int t = 0; t < thrdCnt; t++)
+    alctrs.emplace_back(new EntryAlloc(64));
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thrdCnt; t++) {
+    threads.emplace_back([&, t]() {
+      ShardedBinHashTable<int>::SrchCrsr crsr;
+      for (int i = t; i < keyCnt; i += thrdCnt) {
+        table.InsertElement(i * 61, &elmnts[i], alctrs[t].get());
+        EXPECT_EQ(&elmnts[i], table.GetLastMatch(i * 61, crsr));
+      }
+    });
+  }
+  for (std::thread &thread : threads)
+    thread.join();
+
+  EXPECT_EQ((UDT_HASHTBL_CPCTY)keyCnt, table.GetEntryCnt());
+  ShardedBinHashTable<int>::SrchCrsr crsr;
+  for (int i = 0; i < keyCnt; i++)
+    EXPECT_EQ(&elmnts[i], table.GetLastMatch(i * 61, crsr));
+}
+
+} // namespace
@@ -0,0 +1,123 @@
+#include "opt-sched/Scheduler/hist_table.h"
+#include "TestRegion.h"
+#include "opt-sched/Scheduler/bb_spill.h"
+#include "opt-sched/Scheduler/bit_vector.h"
+#include "opt-sched/Scheduler/config.h"
+#include "opt-sched/Scheduler/enumerator.h"
+#include "opt-sched/Scheduler/logger.h"
+#include "opt-sched/Scheduler/utilities.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+using namespace llvm::opt_sched;
+using namespace llvm::opt_sched::test;
+
+namespace {
+
+// The enumerator settings of createRegion().
+SchedPriorities enumPriorities() {
+  SchedPriorities prirts;
+  prirts.cnt = 3;
+  prirts.isDynmc = true;
+  prirts.vctr[0] = LSH_LUC;
+  prirts.vctr[1] = LSH_CP;
+  prirts.vctr[2] = LSH_NID;
+  return prirts;
+}
+
+Pruning enumPruning() {
+  Pruning pruning;
+  pruning.rlxd = true;
+  pruning.nodeSup = false;
+  pruning.histDom = true;
+  pruning.spillCost = true;
+  pruning.useSuffixConcatenation = false;
+  return pruning;
+}
+
+// A cost enumerator whose history is limited to a given number of bytes,
+// which may be far less than the megabytes HIST_TABLE_MAX_MB allows.
+class CappedEnumerator : public LengthCostEnumerator {
+public:
+  CappedEnumerator(DataDepGraph *ddg, MachineModel *machMdl,
+                   InstCount schedUprBound, uint64_t maxBytes)
+      : LengthCostEnumerator(ddg, machMdl, schedUprBound, 16, enumPriorities(),
+                             enumPruning(), false, true, 60000, SCF_PERP) {
+    histMaxBytes_ = maxBytes;
+    if (evctdSigs_ == NULL)
+      evctdSigs_ = new llvm::opt_sched::BitVector(1 << 16);
+  }
+
+  uint64_t getHistBytes() const { return histBytes_; }
+  uint64_t getPeakHistBytes() const { return peakHistBytes_; }
+  uint64_t getEvictedCnt() const { return evctdHistCnt_; }
+};
+
+class HistTable : public ::testing::Test {
+protected:
+  HistTable() : target(&machMdl) {}
+
+  void SetUp() override {
+    std::istringstream options(R"(
+        HEUR_ENABLED YES
+        ACO_ENABLED NO
+        ENUM_ENABLED YES
+        ACO_BEFORE_ENUM NO
+        ACO_AFTER_ENUM NO
+        SIMULATE_REGISTER_ALLOCATION NO
+      )");
+    SchedulerOptions::getInstance().Load(options);
+    Logger::SetLogStream(nullStream);
+
+    // Scheduling the region once sets it up for the searches below, and
+    // leaves it with the best cost, which they then try to improve on.
+    ddg = createDDG(&machMdl, 6, 14);
+    rgn = createRegion(&target, ddg.get());
+    bool isLstOptml = false;
+    InstCount bestCost, hurstcCost, hurstcLngth;
+    InstSchedule *bestSched = NULL;
+    Utilities::startTime = std::chrono::high_resolution_clock::now();
+    ASSERT_EQ(RES_SUCCESS,
+              rgn->FindOptimalSchedule(60000, 60000, isLstOptml, bestCost,
+                                       bestLngth, hurstcCost, hurstcLngth,
+                                       bestSched, false, BLOCKS_TO_KEEP::ALL));
+  }
+
+  void TearDown() override { Logger::SetLogStream(std::cerr); }
+
+  // Searches the best length for a schedule that is cheaper than the best
+  // one, which takes a complete search since there is none.
+  FUNC_RESULT search(CappedEnumerator &enumrtr) {
+    InstSchedule sched(&machMdl, ddg.get(), false);
+    rgn->InitForSchdulng();
+    return enumrtr.FindFeasibleSchedule(&sched, bestLngth, rgn.get(), 0,
+                                        INVALID_VALUE);
+  }
+
+  TestMachineModel machMdl;
+  TestTarget target;
+  std::unique_ptr<TestDDG> ddg;
+  std::unique_ptr<BBWithSpill> rgn;
+  InstCount bestLngth;
+  std::ofstream nullStream;
+};
+
+TEST_F(HistTable, StaysWithinTheMemoryLimit) {
+  InstCount uprBound = ddg->GetAbslutSchedUprBound();
+  CappedEnumerator unlimited(ddg.get(), &machMdl, uprBound, UINT64_MAX);
+  FUNC_RESULT rslt = search(unlimited);
+  ASSERT_EQ(0u, unlimited.getEvictedCnt());
+
+  // Leave room for a quarter of the entries that the search keeps.
+  uint64_t maxBytes = unlimited.getPeakHistBytes() / 4;
+  CappedEnumerator capped(ddg.get(), &machMdl, uprBound, maxBytes);
+  EXPECT_EQ(rslt, search(capped));
+  EXPECT_GT(capped.getEvictedCnt(), 0u);
+  EXPECT_LE(capped.getHistBytes(), maxBytes);
+  EXPECT_LE(capped.getPeakHistBytes(), maxBytes);
+}
+
+} // namespace
@@ -0,0 +1,164 @@
+#include "opt-sched/Scheduler/parallel_enum.h"
+#include "TestRegion.h"
+#include "opt-sched/Scheduler/bb_spill.h"
+#include "opt-sched/Scheduler/config.h"
+#include "opt-sched/Scheduler/enumerator.h"
+#include "opt-sched/Scheduler/logger.h"
+#include "opt-sched/Scheduler/utilities.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace llvm::opt_sched;
+using namespace llvm::opt_sched::test;
+
+namespace {
+
+TEST(SharedIncumbent, OnlyAcceptsImprovements) {
+  SharedIncumbent incumbent(10);
+
+  EXPECT_FALSE(incumbent.offer(12));
+  EXPECT_EQ(10, incumbent.get());
+
+  EXPECT_TRUE(incumbent.offer(7));
+  EXPECT_EQ(7, incumbent.get());
+
+  EXPECT_FALSE(incumbent.offer(7));
+  EXPECT_EQ(7, incumbent.get());
+}
+
+TEST(SharedIncumbent, KeepsTheMinimumAcrossThreads) {
+  SharedIncumbent incumbent(1000);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&incumbent, t]() {
+      for (int cost = 999; cost >= 0; cost--) {
+        if (cost % 4 == t)
+          incumbent.offer(cost);
+      }
+    });
+  }
+  for (std::thread &thread : threads)
+    thread.join();
+
+  EXPECT_EQ(0, incumbent.get());
+}
+
+TEST(SharedIncumbent, SeesTheCostsOfTheOuterIncumbent) {
+  SharedIncumbent outer(10);
+  SharedIncumbent incumbent(8, &outer);
+  EXPECT_EQ(8, incumbent.get());
+
+  outer.offer(5);
+  EXPECT_EQ(5, incumbent.get());
+
+  // Improvements are only offered to the inner incumbent.
+  EXPECT_TRUE(incumbent.offer(3));
+  EXPECT_EQ(3, incumbent.get());
+  EXPECT_EQ(5, outer.get());
+}
+
+TEST(SubProblemPool, HandsOutEachSubProblemOnce) {
+  SubProblemPool pool;
+  pool.add({1, 2, 3});
+  pool.add({1, 3, 2});
+  pool.add({1, SCHD_STALL, 2});
+  EXPECT_EQ(3, pool.getSubProbCnt());
+
+  SubProblemPool::Prefix subProb;
+  ASSERT_TRUE(pool.take(subProb));
+  EXPECT_EQ(SubProblemPool::Prefix({1, 2, 3}), subProb);
+  ASSERT_TRUE(pool.take(subProb));
+  EXPECT_EQ(SubProblemPool::Prefix({1, 3, 2}), subProb);
+  ASSERT_TRUE(pool.take(subProb));
+  EXPECT_EQ(SubProblemPool::Prefix({1, SCHD_STALL, 2}), subProb);
+  EXPECT_FALSE(pool.take(subProb));
+}
+
+TEST(SubProblemPool, TakesAreExclusiveAcrossThreads) {
+  SubProblemPool pool;
+  const int prefixCnt = 100;
+  for (int i = 0; i < prefixCnt; i++)
+    pool.add({i, i + 1});
+
+  std::vector<std::vector<InstCount>> taken(4);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < taken.size(); t++) {
+    threads.emplace_back([&pool, &taken, t]() {
+      SubProblemPool::Prefix subProb;
+      while (pool.take(subProb))
+        taken[t].push_back(subProb[0]);
+    });
+  }
+  for (std::thread &thread : threads)
+    thread.join();
+
+  std::vector<InstCount> all;
+  for (const std::vector<InstCount> &thrdTaken : taken)
+    all.insert(all.end(), thrdTaken.begin(), thrdTaken.end());
+  std::sort(all.begin(), all.end());
+  ASSERT_EQ(static_cast<size_t>(prefixCnt), all.size());
+  for (int i = 0; i < prefixCnt; i++)
+    EXPECT_EQ(i, all[i]);
+}
+
+// Schedules the test region, with the given number of threads, and returns
+// its best cost.
+InstCount scheduleTestRegion(int thrdCnt) {
+  TestMachineModel machMdl;
+  TestTarget target(&machMdl);
+  std::unique_ptr<TestDDG> ddg = createDDG(&machMdl);
+  std::unique_ptr<BBWithSpill> rgn = createRegion(&target, ddg.get());
+
+  if (thrdCnt > 1) {
+    rgn->setParallelWorkerFactory([&]() {
+      ParallelEnumWorker wrkr;
+      std::unique_ptr<TestDDG> wrkrDDG = createDDG(&machMdl);
+      wrkr.Rgn = createRegion(&target, wrkrDDG.get());
+      wrkr.DDG = std::move(wrkrDDG);
+      return wrkr;
+    });
+    rgn->setParallelEnum(thrdCnt - 1, 2);
+  }
+
+  bool isLstOptml = false;
+  InstCount bestCost, bestLngth, hurstcCost, hurstcLngth;
+  InstSchedule *sched = NULL;
+  Utilities::startTime = std::chrono::high_resolution_clock::now();
+  FUNC_RESULT rslt = rgn->FindOptimalSchedule(
+      60000, 60000, isLstOptml, bestCost, bestLngth, hurstcCost, hurstcLngth,
+      sched, false, BLOCKS_TO_KEEP::ALL);
+  EXPECT_EQ(RES_SUCCESS, rslt);
+  // The enumerator must have improved on the heuristic for the test to mean
+  // anything.
+  EXPECT_LT(bestCost, hurstcCost);
+  return bestCost;
+}
+
+TEST(ParallelEnum, FindsTheSameCostAsSerialEnum) {
+  std::istringstream options(R"(
+      HEUR_ENABLED YES
+      ACO_ENABLED NO
+      ENUM_ENABLED YES
+      ACO_BEFORE_ENUM NO
+      ACO_AFTER_ENUM NO
+      SIMULATE_REGISTER_ALLOCATION NO
+    )");
+  SchedulerOptions::getInstance().Load(options);
+  std::ofstream nullStream;
+  Logger::SetLogStream(nullStream);
+
+  InstCount serialCost = scheduleTestRegion(1);
+  InstCount prllCost = scheduleTestRegion(4);
+  Logger::SetLogStream(std::cerr);
+
+  EXPECT_EQ(serialCost, prllCost);
+}
+
+} // namespace
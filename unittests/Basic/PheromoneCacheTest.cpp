@@ -0,0 +1,86 @@
+#include "opt-sched/Scheduler/pheromone_cache.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace llvm::opt_sched;
+
+namespace {
+
+std::vector<pheromone_cell_t> makeTable(size_t Cnt) {
+  std::vector<pheromone_cell_t> Tbl;
+  for (size_t i = 0; i < Cnt; i++)
+    Tbl.push_back(1 + (i * 7 % 15) / 2.0f);
+  return Tbl;
+}
+
+TEST(PheromoneCache, LoadsTheStoredTable) {
+  PheromoneCache Cache;
+  std::vector<pheromone_cell_t> Tbl = makeTable(12);
+  Cache.store("main:3", 42, Tbl);
+
+  std::vector<pheromone_cell_t> Loaded(12, 0);
+  EXPECT_TRUE(Cache.load("main:3", 42, Loaded));
+  EXPECT_EQ(Tbl, Loaded);
+}
+
+TEST(PheromoneCache, MatchesTheIDHashAndSize) {
+  PheromoneCache Cache;
+  Cache.store("main:3", 42, makeTable(12));
+
+  std::vector<pheromone_cell_t> Loaded(12, 0);
+  EXPECT_FALSE(Cache.load("main:4", 42, Loaded));
+  EXPECT_FALSE(Cache.load("main:3", 43, Loaded));
+  EXPECT_EQ(std::vector<pheromone_cell_t>(12, 0), Loaded);
+
+  std::vector<pheromone_cell_t> Larger(20, 0);
+  EXPECT_FALSE(Cache.load("main:3", 42, Larger));
+}
+
+TEST(PheromoneCache, ReplacesAnEarlierTable) {
+  PheromoneCache Cache;
+  Cache.store("main:3", 42, makeTable(12));
+  std::vector<pheromone_cell_t> Tbl(12, 8);
+  Cache.store("main:3", 42, Tbl);
+
+  std::vector<pheromone_cell_t> Loaded(12, 0);
+  EXPECT_TRUE(Cache.load("main:3", 42, Loaded));
+  EXPECT_EQ(Tbl, Loaded);
+}
+
+TEST(PheromoneCache, DropsTheOldestTablesOverTheLimit) {
+  PheromoneCache Cache;
+  size_t Cnt = PheromoneCache::MaxCellCnt / 2;
+  Cache.store("a", 1, std::vector<pheromone_cell_t>(Cnt, 1));
+  Cache.store("b", 2, std::vector<pheromone_cell_t>(Cnt, 2));
+  Cache.store("c", 3, std::vector<pheromone_cell_t>(Cnt, 3));
+
+  std::vector<pheromone_cell_t> Loaded(Cnt);
+  EXPECT_FALSE(Cache.load("a", 1, Loaded));
+  EXPECT_TRUE(Cache.load("b", 2, Loaded));
+  EXPECT_TRUE(Cache.load("c", 3, Loaded));
+}
+
+TEST(PheromoneCache, KeepsTheTablesInTheDirectory) {
+  llvm::SmallString<128> Dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("pheromone-cache", Dir));
+  std::vector<pheromone_cell_t> Tbl = makeTable(30);
+  {
+    PheromoneCache Cache(Dir.str().str());
+    Cache.store("main:3", 42, Tbl);
+  }
+
+  // A new cache, as in a later compile, reads the table back.
+  PheromoneCache Cache(Dir.str().str());
+  std::vector<pheromone_cell_t> Loaded(30, 0);
+  EXPECT_TRUE(Cache.load("main:3", 42, Loaded));
+  EXPECT_EQ(Tbl, Loaded);
+  EXPECT_FALSE(Cache.load("main:3", 41, Loaded));
+
+  llvm::sys::fs::remove_directories(Dir);
+}
+
+} // namespace
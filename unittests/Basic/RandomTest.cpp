@@ -0,0 +1,52 @@
+#include "opt-sched/Scheduler/random.h"
+
+#include "gtest/gtest.h"
+
+using namespace llvm::opt_sched;
+
+namespace {
+
+TEST(RandomStream, MatchesTheReferenceGenerator) {
+  // xoshiro256** with its state filled by SplitMix64.
+  RandomStream Stream(0);
+  EXPECT_EQ(0x99ec5f36cb75f2b4ULL, Stream.GetRand64());
+  EXPECT_EQ(0xbf6e1f784956452aULL, Stream.GetRand64());
+  EXPECT_EQ(0x1a5f849d4933e6e0ULL, Stream.GetRand64());
+
+  Stream.Seed(2020);
+  EXPECT_EQ(0x2334c896b4cf8e03ULL, Stream.GetRand64());
+  EXPECT_EQ(0x47fe724559250b1eULL, Stream.GetRand64());
+  EXPECT_EQ(0xd307788674632026ULL, Stream.GetRand64());
+}
+
+TEST(RandomStream, StreamsAreIndependent) {
+  RandomStream A(7);
+  RandomStream B(7);
+  for (int i = 0; i < 100; i++)
+    A.GetRand64();
+  RandomStream C(7);
+  for (int i = 0; i < 10; i++)
+    EXPECT_EQ(B.GetRand64(), C.GetRand64());
+}
+
+TEST(RandomStream, DoublesAreInTheUnitInterval) {
+  RandomStream Stream(1);
+  for (int i = 0; i < 10000; i++) {
+    double D = Stream.GetRandDouble();
+    EXPECT_LE(0.0, D);
+    EXPECT_GT(1.0, D);
+  }
+}
+
+TEST(RandomStream, MixSeedSeparatesStreams) {
+  uint64_t Seed = RandomStream::MixSeedWithStr(2020, "main:3");
+  EXPECT_EQ(Seed, RandomStream::MixSeedWithStr(2020, "main:3"));
+  EXPECT_NE(Seed, RandomStream::MixSeedWithStr(2020, "main:4"));
+  EXPECT_NE(Seed, RandomStream::MixSeedWithStr(2021, "main:3"));
+
+  EXPECT_NE(RandomStream::MixSeed(Seed, 0), RandomStream::MixSeed(Seed, 1));
+  EXPECT_NE(RandomStream::MixSeed(RandomStream::MixSeed(Seed, 1), 2),
+            RandomStream::MixSeed(RandomStream::MixSeed(Seed, 2), 1));
+}
+
+} // namespace
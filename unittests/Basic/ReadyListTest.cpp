@@ -0,0 +1,234 @@
+#include "opt-sched/Scheduler/ready_list.h"
+#include "TestRegion.h"
+#include "opt-sched/Scheduler/config.h"
+#include "opt-sched/Scheduler/register.h"
+
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace llvm::opt_sched;
+using namespace llvm::opt_sched::test;
+
+namespace {
+
+// Sorting by last-use count and critical path alone leaves many instructions
+// with equal keys, so that the order of ties shows.
+SchedPriorities tiedPriorities() {
+  SchedPriorities prirts;
+  prirts.cnt = 2;
+  prirts.isDynmc = true;
+  prirts.vctr[0] = LSH_LUC;
+  prirts.vctr[1] = LSH_CP;
+  return prirts;
+}
+
+// A ready list with the given engine. Each list has its own copy of the
+// graph, since the last-use counts that the keys are computed from are kept
+// in the graph's registers and instructions.
+class EngineList {
+public:
+  EngineList(MachineModel *machMdl, const std::string &engn)
+      : ddg(createDDG(machMdl, 6, 14)) {
+    ddg->SetupForSchdulng(false);
+    std::istringstream options("READY_LIST_ENGINE " + engn);
+    SchedulerOptions::getInstance().Load(options);
+    lst = llvm::make_unique<ReadyList>(ddg.get(), tiedPriorities());
+  }
+
+  void addInst(InstCount num) { lst->AddInst(ddg->GetInstByIndx(num)); }
+
+  // Removes the instruction at the given position from the top.
+  InstCount removeInst(int pos) {
+    SchedInstruction *inst = NULL;
+    lst->ResetIterator();
+    for (int i = 0; i <= pos; i++)
+      inst = lst->GetNextPriorityInst();
+    lst->RemoveNextPriorityInst();
+    lst->ResetIterator();
+    return inst->GetNum();
+  }
+
+  Register *getReg(int num) { return ddg->getRegFiles()[0].GetReg(num); }
+  int getRegCnt() { return ddg->getRegFiles()[0].GetRegCnt(); }
+
+  // The instructions in the list in priority order, with their keys.
+  std::vector<std::pair<InstCount, unsigned long>> contents() {
+    std::vector<std::pair<InstCount, unsigned long>> insts;
+    unsigned long key;
+    lst->ResetIterator();
+    for (SchedInstruction *inst = lst->GetNextPriorityInst(key); inst != NULL;
+         inst = lst->GetNextPriorityInst(key))
+      insts.push_back({inst->GetNum(), key});
+    lst->ResetIterator();
+    return insts;
+  }
+
+  std::unique_ptr<TestDDG> ddg;
+  std::unique_ptr<ReadyList> lst;
+};
+
+class ReadyListEngines : public ::testing::Test {
+protected:
+  ReadyListEngines()
+      : linked(&machMdl, "LINKED"), flat(&machMdl, "FLAT"), rndm(13),
+        inLst(linked.ddg->GetInstCnt(), false) {}
+
+  // Marks one more use of a register as done in both graphs, or takes one
+  // back, which changes the last-use counts of the instructions using it.
+  void changeUse(int regNum, bool add) {
+    for (EngineList *engn : {&linked, &flat}) {
+      Register *reg = engn->getReg(regNum);
+      if (add)
+        reg->AddCrntUse();
+      else
+        reg->DelCrntUse();
+    }
+  }
+
+  // Applies the same random insertion, removal or update of the keys to both
+  // lists.
+  void randomStep() {
+    InstCount instCnt = inLst.size();
+    int lstSize = linked.lst->GetInstCnt();
+    switch (rndm() % 3) {
+    case 0: {
+      InstCount num = rndm() % instCnt;
+      if (inLst[num])
+        break;
+      linked.addInst(num);
+      flat.addInst(num);
+      inLst[num] = true;
+      break;
+    }
+    case 1: {
+      if (lstSize == 0)
+        break;
+      int pos = rndm() % lstSize;
+      InstCount num = linked.removeInst(pos);
+      ASSERT_EQ(num, flat.removeInst(pos));
+      inLst[num] = false;
+      break;
+    }
+    case 2: {
+      // Change the uses of a few registers at once, so that several keys
+      // go up or down in the same update. No register reaches its last
+      // use, which the instructions using it may not be scheduled after.
+      int regCnt = linked.getRegCnt();
+      for (int i = rndm() % 4; i >= 0; i--) {
+        int regNum = rndm() % regCnt;
+        Register *reg = linked.getReg(regNum);
+        bool add = rndm() % 2 == 0;
+        if (add ? reg->GetCrntUseCnt() + 1 < reg->GetUseCnt()
+                : reg->GetCrntUseCnt() > 0) {
+          changeUse(regNum, add);
+          useLog.push_back({regNum, add});
+        }
+      }
+      auto before = linked.contents();
+      linked.lst->UpdatePriorities();
+      flat.lst->UpdatePriorities();
+      auto after = linked.contents();
+      for (auto &entry : before)
+        for (auto &updtd : after)
+          if (entry.first == updtd.first) {
+            sawRaise |= updtd.second > entry.second;
+            sawDrop |= updtd.second < entry.second;
+          }
+      break;
+    }
+    }
+  }
+
+  // Saves the state of both lists with their iterators part way down, makes
+  // random changes, with deeper saved states in between, and then checks
+  // that restoring brings back the contents and the iterators.
+  void checkRestore(int depth) {
+    auto svdInsts = linked.contents();
+    ASSERT_EQ(svdInsts, flat.contents());
+    std::vector<bool> svdInLst = inLst;
+    size_t svdUseCnt = useLog.size();
+
+    int pos = rndm() % (svdInsts.size() + 1);
+    for (EngineList *engn : {&linked, &flat}) {
+      for (int i = 0; i < pos; i++)
+        engn->lst->GetNextPriorityInst();
+      engn->lst->SaveState();
+    }
+
+    for (int i = rndm() % 10; i > 0; i--)
+      randomStep();
+    if (depth > 1)
+      checkRestore(depth - 1);
+    for (int i = rndm() % 10; i > 0; i--)
+      randomStep();
+
+    // Take back the register uses, as backtracking does.
+    while (useLog.size() > svdUseCnt) {
+      changeUse(useLog.back().first, !useLog.back().second);
+      useLog.pop_back();
+    }
+    inLst = svdInLst;
+
+    for (EngineList *engn : {&linked, &flat}) {
+      engn->lst->RestoreState();
+      unsigned long key;
+      SchedInstruction *inst = engn->lst->GetNextPriorityInst(key);
+      if (pos == (int)svdInsts.size()) {
+        EXPECT_EQ(nullptr, inst);
+      } else {
+        ASSERT_NE(nullptr, inst);
+        EXPECT_EQ(svdInsts[pos].first, inst->GetNum());
+        EXPECT_EQ(svdInsts[pos].second, key);
+      }
+      EXPECT_EQ(svdInsts, engn->contents());
+    }
+  }
+
+  TestMachineModel machMdl;
+  EngineList linked;
+  EngineList flat;
+  std::mt19937 rndm;
+  // Whether each instruction is in the lists.
+  std::vector<bool> inLst;
+  // The register uses changed so far, and whether each was added.
+  std::vector<std::pair<int, bool>> useLog;
+  bool sawRaise = false;
+  bool sawDrop = false;
+};
+
+TEST_F(ReadyListEngines, KeepTheSameOrderAndTies) {
+  bool sawTie = false;
+
+  for (int step = 0; step < 3000; step++) {
+    randomStep();
+    auto linkedInsts = linked.contents();
+    ASSERT_EQ(linkedInsts, flat.contents()) << "at step " << step;
+    for (size_t i = 1; i < linkedInsts.size(); i++) {
+      ASSERT_GE(linkedInsts[i - 1].second, linkedInsts[i].second);
+      sawTie |= linkedInsts[i - 1].second == linkedInsts[i].second;
+    }
+  }
+
+  EXPECT_TRUE(sawTie);
+  EXPECT_TRUE(sawRaise);
+  EXPECT_TRUE(sawDrop);
+}
+
+TEST_F(ReadyListEngines, RestoreTheSavedState) {
+  for (int round = 0; round < 300; round++) {
+    for (int i = rndm() % 6; i > 0; i--)
+      randomStep();
+    checkRestore(1 + rndm() % 3);
+  }
+
+  EXPECT_TRUE(sawRaise);
+  EXPECT_TRUE(sawDrop);
+}
+
+} // namespace
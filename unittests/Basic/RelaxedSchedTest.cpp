@@ -0,0 +1,158 @@
+#include "opt-sched/Scheduler/relaxed_sched.h"
+#include "TestRegion.h"
+#include "opt-sched/Scheduler/config.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace llvm::opt_sched;
+using namespace llvm::opt_sched::test;
+
+namespace {
+
+class RelaxedSched : public ::testing::Test {
+protected:
+  RelaxedSched() : ddg(createDDG(&machMdl, 6, 14)) {
+    ddg->SetupForSchdulng(false);
+    InstCount uprBound = ddg->GetAbslutSchedUprBound();
+    for (std::unique_ptr<RJ_RelaxedScheduler> *schdulr : {&incrmntl, &full}) {
+      schdulr->reset(new RJ_RelaxedScheduler(ddg.get(), &machMdl, uprBound,
+                                             DIR_FRWRD, RST_DYNMC));
+      (*schdulr)->SetIncrmntl(schdulr == &incrmntl);
+      (*schdulr)->Initialize(false);
+      (*schdulr)->SetupPrirtyLst();
+    }
+  }
+
+  InstCount getReleaseTime(SchedInstruction *inst) {
+    return inst->GetLwrBound(DIR_FRWRD);
+  }
+
+  TestMachineModel machMdl;
+  std::unique_ptr<TestDDG> ddg;
+  std::unique_ptr<RJ_RelaxedScheduler> incrmntl;
+  std::unique_ptr<RJ_RelaxedScheduler> full;
+};
+
+// Fixes and unfixes instructions the way the enumerator schedules and
+// backtracks, and checks after each step that repairing the last relaxed
+// schedule gives the same answer as building a new one.
+TEST_F(RelaxedSched, RepairsAgreeWithFullChecks) {
+  std::mt19937 rndm(5);
+  InstCount instCnt = ddg->GetInstCnt();
+  // Start from the shortest length that the relaxed problem allows, and go
+  // one cycle below it now and then.
+  InstCount minLastCycle = ddg->GetLeafInst()->GetLwrBound(DIR_FRWRD);
+  while (!full->SchdulAndChkFsblty(0, minLastCycle))
+    minLastCycle++;
+  InstCount lastCycle = minLastCycle;
+  // The fixed instructions, in the order in which they were fixed, which is
+  // that of their release times, so that none of the others are released
+  // before the current cycle.
+  std::vector<SchedInstruction *> fxdInsts;
+  std::vector<bool> isFxd(instCnt, false);
+  int fsblCnt = 0, infsblCnt = 0;
+
+  for (int step = 0; step < 4000; step++) {
+    if (rndm() % 50 == 0)
+      lastCycle = minLastCycle - 1 + rndm() % 4;
+
+    if (rndm() % 5 < 3 && (InstCount)fxdInsts.size() < instCnt) {
+      // Fix one of the unfixed instructions that are released first.
+      std::vector<SchedInstruction *> frstInsts;
+      for (InstCount i = 0; i < instCnt; i++) {
+        SchedInstruction *inst = ddg->GetInstByIndx(i);
+        if (isFxd[i])
+          continue;
+        if (!frstInsts.empty() &&
+            getReleaseTime(inst) < getReleaseTime(frstInsts[0]))
+          frstInsts.clear();
+        if (frstInsts.empty() ||
+            getReleaseTime(inst) == getReleaseTime(frstInsts[0]))
+          frstInsts.push_back(inst);
+      }
+      SchedInstruction *inst = frstInsts[rndm() % frstInsts.size()];
+      InstCount cycle = getReleaseTime(inst);
+      bool fsbl = incrmntl->FixInst(inst, cycle);
+      ASSERT_EQ(fsbl, full->FixInst(inst, cycle));
+      if (fsbl) {
+        fxdInsts.push_back(inst);
+        isFxd[inst->GetNum()] = true;
+      }
+    } else if (!fxdInsts.empty()) {
+      SchedInstruction *inst = fxdInsts.back();
+      incrmntl->UnFixInst(inst, getReleaseTime(inst));
+      full->UnFixInst(inst, getReleaseTime(inst));
+      fxdInsts.pop_back();
+      isFxd[inst->GetNum()] = false;
+    }
+
+    InstCount crntCycle =
+        fxdInsts.empty() ? 0 : getReleaseTime(fxdInsts.back());
+    bool fsbl = full->SchdulAndChkFsblty(crntCycle, lastCycle);
+    ASSERT_EQ(fsbl, incrmntl->ChkFsbltyIncrmntly(crntCycle, lastCycle))
+        << "at step " << step;
+    fsbl ? fsblCnt++ : infsblCnt++;
+  }
+
+  EXPECT_GT(fsblCnt, 0);
+  EXPECT_GT(infsblCnt, 0);
+}
+
+// An LC relaxed scheduler that can find the bounds of a full graph one
+// subgraph at a time, as it does for subgraphs.
+class ListLCScheduler : public LC_RelaxedScheduler {
+public:
+  using LC_RelaxedScheduler::LC_RelaxedScheduler;
+
+  InstCount findListSchedule() { return FindListSchedule_(); }
+};
+
+// The bounds that several threads find for a full graph are the ones found
+// by scheduling each subgraph in turn.
+TEST(LCRelaxedSched, FindsTheSameBoundsOnSeveralThreads) {
+  TestMachineModel machMdl;
+  std::istringstream options("LC_PARALLEL_THREADS 4");
+  SchedulerOptions::getInstance().Load(options);
+
+  for (DIRECTION dir : {DIR_FRWRD, DIR_BKWRD}) {
+    std::unique_ptr<TestDDG> seqDDG = createDDG(&machMdl, 400, 100);
+    std::unique_ptr<TestDDG> prllDDG = createDDG(&machMdl, 400, 100);
+    InstCount instCnt = seqDDG->GetInstCnt();
+    seqDDG->SetupForSchdulng(true);
+    prllDDG->SetupForSchdulng(true);
+
+    // The graph is wide enough to give each of two threads 16 instructions
+    // per depth. The instructions are numbered in topological order.
+    std::vector<InstCount> depths(instCnt, 0);
+    for (InstCount i = 0; i < instCnt; i++) {
+      SchedInstruction *inst = seqDDG->GetInstByIndx(i);
+      for (SchedInstruction *pred = inst->GetFrstPrdcsr(); pred != NULL;
+           pred = inst->GetNxtPrdcsr())
+        depths[i] = std::max(depths[i], depths[pred->GetNum()] + 1);
+    }
+    ASSERT_GE(instCnt, 2 * 16 * (depths.back() + 1));
+
+    seqDDG->BldRcrsvNghbrLsts(DIR_FRWRD);
+    seqDDG->BldRcrsvNghbrLsts(DIR_BKWRD);
+    InstCount uprBound = seqDDG->GetAbslutSchedUprBound();
+    ListLCScheduler seq(seqDDG.get(), &machMdl, uprBound, dir);
+    LC_RelaxedScheduler prll(prllDDG.get(), &machMdl, uprBound, dir);
+    InstCount lngth = seq.findListSchedule();
+    EXPECT_EQ(lngth, prll.FindSchedule());
+    // The issue slots, not the latencies, bound the length.
+    EXPECT_GT(lngth, seqDDG->GetRootInst()->GetCrtclPath(DIR_BKWRD) + 1);
+
+    for (InstCount i = 0; i < instCnt; i++)
+      EXPECT_EQ(seqDDG->GetInstByIndx(i)->GetLwrBound(dir),
+                prllDDG->GetInstByIndx(i)->GetLwrBound(dir))
+          << "inst " << i;
+  }
+}
+
+} // namespace
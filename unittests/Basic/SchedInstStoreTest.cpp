@@ -0,0 +1,97 @@
+#include "opt-sched/Scheduler/sched_basic_data.h"
+#include "opt-sched/Scheduler/lnkd_lst.h"
+
+#include "gtest/gtest.h"
+
+using namespace llvm::opt_sched;
+
+namespace {
+
+// A machine with a single pipelined instruction type.
+class TestMachineModel : public MachineModel {
+public:
+  TestMachineModel() {
+    InstTypeInfo Info;
+    Info.name = "alu";
+    Info.isCntxtDep = false;
+    Info.issuType = 0;
+    Info.ltncy = 1;
+    Info.pipelined = true;
+    Info.sprtd = true;
+    Info.blksCycle = false;
+    AddInstType(Info);
+  }
+};
+
+SchedInstruction *makeInst(InstCount Num, TestMachineModel &MM,
+                           SchedInstStore *Store) {
+  return new SchedInstruction(Num, "alu", 0, "add", 8, Num, Num, Num, 0, 0,
+                              &MM, Store);
+}
+
+TEST(SchedInstStore, HoldsTheFieldsOfEachInstruction) {
+  TestMachineModel MM;
+  SchedInstStore Store(3);
+  SchedInstruction *A = makeInst(0, MM, &Store);
+  SchedInstruction *B = makeInst(2, MM, &Store);
+
+  A->SetIssueType(1);
+  A->SetBounds(2, 5);
+  B->SetBounds(4, 1);
+  B->Schedule(7, 0);
+
+  EXPECT_EQ(1, Store.issuTypes[0]);
+  EXPECT_EQ(2, Store.frwrdLwrBounds[0]);
+  EXPECT_EQ(5, Store.bkwrdLwrBounds[0]);
+  EXPECT_EQ(2, Store.crntFrwrdLwrBounds[0]);
+  EXPECT_EQ(4, Store.crntFrwrdLwrBounds[2]);
+  EXPECT_EQ(SCHD_UNSCHDULD, Store.schedCycles[0]);
+  EXPECT_EQ(SCHD_UNSCHDULD, Store.schedCycles[1]);
+  EXPECT_EQ(7, Store.schedCycles[2]);
+  EXPECT_EQ(7, B->GetSchedCycle());
+
+  B->UnSchedule();
+  EXPECT_FALSE(B->IsSchduld());
+  delete A;
+  delete B;
+}
+
+TEST(SchedInstStore, KeepsDeadlinesInStep) {
+  TestMachineModel MM;
+  SchedInstStore Store(1);
+  SchedInstruction *Inst = makeInst(0, MM, &Store);
+  LinkedList<SchedInstruction> TightndLst, FxdLst;
+
+  Inst->SetBounds(1, 2);
+  ASSERT_TRUE(Inst->InitForSchdulng(10, &FxdLst));
+  EXPECT_EQ(7, Store.crntDeadlines[0]);
+  EXPECT_EQ(7, Inst->GetCrntDeadline());
+
+  ASSERT_TRUE(Inst->TightnLwrBound(DIR_BKWRD, 4, &TightndLst, &FxdLst, false));
+  EXPECT_EQ(5, Inst->GetCrntDeadline());
+  EXPECT_EQ(2, Inst->GetPrevLwrBound(DIR_BKWRD));
+
+  Inst->UnTightnLwrBounds();
+  EXPECT_EQ(2, Inst->GetCrntLwrBound(DIR_BKWRD));
+  EXPECT_EQ(7, Inst->GetCrntDeadline());
+  delete Inst;
+}
+
+TEST(SchedInstStore, InstructionWithoutStore) {
+  TestMachineModel MM;
+  SchedInstStore Store(1);
+  SchedInstruction *Shared = makeInst(0, MM, &Store);
+  SchedInstruction *Own = makeInst(INVALID_VALUE, MM, NULL);
+
+  Shared->SetBounds(1, 1);
+  Own->SetBounds(3, 0);
+  Own->Schedule(3, 0);
+  EXPECT_EQ(3, Own->GetLwrBound(DIR_FRWRD));
+  EXPECT_EQ(3, Own->GetSchedCycle());
+  EXPECT_EQ(1, Store.frwrdLwrBounds[0]);
+  EXPECT_EQ(SCHD_UNSCHDULD, Store.schedCycles[0]);
+  delete Shared;
+  delete Own;
+}
+
+} // namespace
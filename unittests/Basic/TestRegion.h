@@ -0,0 +1,203 @@
+// A small machine model, DDG and target shared by the tests that schedule a
+// whole region.
+
+#ifndef OPTSCHED_UNITTESTS_TEST_REGION_H
+#define OPTSCHED_UNITTESTS_TEST_REGION_H
+
+#include "opt-sched/Scheduler/OptSchedTarget.h"
+#include "opt-sched/Scheduler/bb_spill.h"
+#include "opt-sched/Scheduler/data_dep.h"
+#include "opt-sched/Scheduler/register.h"
+#include "opt-sched/Scheduler/sched_basic_data.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/ErrorHandling.h"
+
+#include <cstring>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace llvm {
+namespace opt_sched {
+namespace test {
+
+// A machine with two issue slots and few registers, so that the order of the
+// instructions decides the spill cost.
+class TestMachineModel : public MachineModel {
+public:
+  TestMachineModel() {
+    mdlName_ = "test";
+    issueRate_ = 2;
+    dependenceLatencies_[DEP_DATA] = 1;
+    dependenceLatencies_[DEP_ANTI] = 0;
+    dependenceLatencies_[DEP_OUTPUT] = 1;
+    dependenceLatencies_[DEP_OTHER] = 1;
+
+    IssueTypeInfo issueType;
+    issueType.name = "Default";
+    issueType.slotsCount = 2;
+    addIssueType(issueType);
+
+    RegTypeInfo regType;
+    regType.name = "GPR";
+    regType.count = 3;
+    registerTypes_.push_back(regType);
+
+    addInstType("artificial", 1);
+    addInstType("alu", 1);
+    addInstType("load", 3);
+  }
+
+private:
+  void addInstType(const char *name, int16_t ltncy) {
+    InstTypeInfo info;
+    info.name = name;
+    info.isCntxtDep = false;
+    info.issuType = 0;
+    info.ltncy = ltncy;
+    info.pipelined = true;
+    info.sprtd = true;
+    info.blksCycle = false;
+    AddInstType(info);
+  }
+};
+
+// A region of loads whose results are combined by ALU instructions. Each
+// instruction defines a register that is used by its data successors.
+class TestDDG : public DataDepGraph {
+public:
+  explicit TestDDG(MachineModel *machMdl, InstCount loadCnt = 4,
+                   InstCount aluCnt = 8, unsigned seed = 7)
+      : DataDepGraph(machMdl, LTP_ROUGH) {
+    InstCount root = 0;
+    InstCount leaf = loadCnt + aluCnt + 1;
+    strncpy(dagID_, "test_region", sizeof(dagID_));
+    strncpy(compiler_, "LLVM", sizeof(compiler_));
+    instCnt_ = nodeCnt_ = leaf + 1;
+    AllocArrays_(instCnt_);
+
+    InstType artType = machMdl->GetInstTypeByName("artificial");
+    InstType aluType = machMdl->GetInstTypeByName("alu");
+    InstType loadType = machMdl->GetInstTypeByName("load");
+    for (InstCount i = 0; i < instCnt_; i++) {
+      bool isArt = i == root || i == leaf;
+      InstType type = isArt ? artType : i <= loadCnt ? loadType : aluType;
+      CreateNode_(i, isArt ? "artificial" : "inst", type, "inst", i, i, i, 0,
+                  0, 0);
+    }
+
+    // The ALU instructions combine two earlier results each, picked with a
+    // fixed pseudo-random sequence.
+    for (InstCount i = loadCnt + 1; i < leaf; i++) {
+      for (int j = 0; j < 2; j++) {
+        seed = seed * 1103515245 + 12345;
+        InstCount opnd = 1 + (seed >> 16) % (i - 1);
+        int ltncy = machMdl->GetLatency(insts_[opnd]->GetInstType(), DEP_DATA);
+        CreateEdge_(opnd, i, ltncy, DEP_DATA);
+      }
+    }
+    for (InstCount i = 1; i < leaf; i++) {
+      if (insts_[i]->GetPrdcsrCnt() == 0)
+        CreateEdge_(root, i, 0, DEP_OTHER);
+      if (insts_[i]->GetScsrCnt() == 0)
+        CreateEdge_(i, leaf, 0, DEP_OTHER);
+    }
+
+    if (Finish_() != RES_SUCCESS)
+      ADD_FAILURE() << "Invalid test DDG";
+  }
+
+  void convertSUnits(bool, bool) override {}
+
+  void convertRegFiles() override {
+    RegisterFile &regFile = RegFiles[0];
+    regFile.SetRegType(0);
+    regFile.SetRegCnt(instCnt_ - 2);
+
+    for (InstCount i = 1; i < instCnt_ - 1; i++) {
+      Register *reg = regFile.GetReg(i - 1);
+      SchedInstruction *inst = insts_[i];
+      inst->AddDef(reg);
+      reg->AddDef(inst);
+
+      DependenceType depType;
+      for (SchedInstruction *scsr = inst->GetFrstScsr(NULL, NULL, &depType);
+           scsr != NULL; scsr = inst->GetNxtScsr(NULL, NULL, &depType)) {
+        if (depType != DEP_DATA && scsr != GetLeafInst())
+          continue;
+        scsr->AddUse(reg);
+        reg->AddUse(scsr);
+        if (scsr == GetLeafInst())
+          reg->SetIsLiveOut(true);
+      }
+    }
+  }
+};
+
+class TestTarget : public OptSchedTarget {
+public:
+  explicit TestTarget(MachineModel *machMdl) { MM = machMdl; }
+
+  std::unique_ptr<OptSchedMachineModel>
+  createMachineModel(const char *) override {
+    llvm_unreachable("The test builds its own machine model.");
+  }
+
+  std::unique_ptr<OptSchedDDGWrapperBase>
+  createDDGWrapper(MachineSchedContext *, ScheduleDAGOptSched *,
+                   OptSchedMachineModel *, LATENCY_PRECISION,
+                   const std::string &) override {
+    llvm_unreachable("The test builds its own DDGs.");
+  }
+
+  void initRegion(ScheduleDAGInstrs *, MachineModel *) override {}
+  void finalizeRegion(const InstSchedule *) override {}
+
+  InstCount getCost(const llvm::SmallVectorImpl<unsigned> &PRP) const override {
+    return PRP[0];
+  }
+};
+
+inline std::unique_ptr<TestDDG> createDDG(MachineModel *machMdl,
+                                          InstCount loadCnt = 4,
+                                          InstCount aluCnt = 8,
+                                          unsigned seed = 7) {
+  auto ddg = llvm::make_unique<TestDDG>(machMdl, loadCnt, aluCnt, seed);
+  ddg->convertRegFiles();
+  return ddg;
+}
+
+inline std::unique_ptr<BBWithSpill>
+createRegion(TestTarget *target, DataDepGraph *ddg,
+             SPILL_COST_FUNCTION spillCostFunc = SCF_PERP) {
+  // The heuristic only looks at the critical paths, so that it leaves the
+  // enumerator something to improve.
+  SchedPriorities hurstcPrirts;
+  hurstcPrirts.cnt = 1;
+  hurstcPrirts.isDynmc = false;
+  hurstcPrirts.vctr[0] = LSH_CP;
+
+  SchedPriorities enumPrirts;
+  enumPrirts.cnt = 3;
+  enumPrirts.isDynmc = true;
+  enumPrirts.vctr[0] = LSH_LUC;
+  enumPrirts.vctr[1] = LSH_CP;
+  enumPrirts.vctr[2] = LSH_NID;
+
+  Pruning pruning;
+  pruning.rlxd = true;
+  pruning.nodeSup = false;
+  pruning.histDom = true;
+  pruning.spillCost = true;
+  pruning.useSuffixConcatenation = false;
+
+  return llvm::make_unique<BBWithSpill>(
+      target, ddg, 0, 16, LBA_LC, hurstcPrirts, enumPrirts, false, pruning,
+      false, true, 10000, spillCostFunc, SCHED_LIST);
+}
+
+} // namespace test
+} // namespace opt_sched
+} // namespace llvm
+
+#endif
@@ -0,0 +1,54 @@
+#include "opt-sched/Scheduler/undo_trail.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace llvm::opt_sched;
+
+namespace {
+
+TEST(UndoTrail, PopsToMarkNewestFirst) {
+  UndoTrail Trail;
+  std::vector<InstCount> Vals = {10, 20, 30};
+
+  auto set = [&](InstCount Indx, InstCount Val) {
+    Trail.Push(TK_FRWRD_LWR_BOUND, Indx, Vals[Indx]);
+    Vals[Indx] = Val;
+  };
+  auto undo = [&](const TrailEntry &Entry) {
+    EXPECT_EQ(TK_FRWRD_LWR_BOUND, Entry.kind);
+    Vals[Entry.indx] = Entry.val;
+  };
+
+  set(0, 11);
+  UndoTrail::Mark Outer = Trail.GetMark();
+  set(1, 21);
+  set(0, 12);
+  UndoTrail::Mark Inner = Trail.GetMark();
+  set(0, 13);
+  set(2, 31);
+  EXPECT_EQ(5u, Trail.GetSize());
+
+  Trail.PopTo(Inner, undo);
+  EXPECT_EQ((std::vector<InstCount>{12, 21, 30}), Vals);
+  Trail.PopTo(Outer, undo);
+  EXPECT_EQ((std::vector<InstCount>{11, 20, 30}), Vals);
+
+  // Popping to the current mark does nothing.
+  Trail.PopTo(Outer, undo);
+  EXPECT_EQ(Outer, Trail.GetSize());
+  Trail.PopTo(0, undo);
+  EXPECT_EQ((std::vector<InstCount>{10, 20, 30}), Vals);
+}
+
+TEST(UndoTrail, ResetDropsEntries) {
+  UndoTrail Trail;
+  Trail.Push(TK_AVLBL_SLOTS, 0, 4);
+  Trail.Push(TK_AVLBL_SLOTS_IN_CYCLE, 1, 2);
+  Trail.Reset();
+  EXPECT_EQ(0u, Trail.GetSize());
+  Trail.PopTo(0, [](const TrailEntry &) { ADD_FAILURE(); });
+}
+
+} // namespace